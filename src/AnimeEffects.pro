@@ -5,7 +5,7 @@
 #-------------------------------------------------
 
 TEMPLATE    = subdirs
-SUBDIRS     = util thr cmnd gl img core ctrl gui
+SUBDIRS     = util thr cmnd gl img core ctrl gui bench
 
 CONFIG += ordered
 
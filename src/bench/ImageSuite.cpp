@@ -0,0 +1,266 @@
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <QVersionNumber>
+#include "XC.h"
+#include "util/PackBits.h"
+#include "util/StreamWriter.h"
+#include "util/StreamReader.h"
+#include "img/GridMeshCreator.h"
+#include "img/PSDReader.h"
+#include "img/PSDUtil.h"
+#include "core/Serializer.h"
+#include "core/Deserializer.h"
+#include "bench/SyntheticImage.h"
+#include "bench/ImageSuite.h"
+
+namespace
+{
+
+class ScopedBlock
+{
+public:
+    ScopedBlock(const XCMemBlock& aBlock) : mBlock(aBlock) {}
+    ~ScopedBlock() { delete [] mBlock.data; }
+    const XCMemBlock& operator*() const { return mBlock; }
+    const XCMemBlock* operator->() const { return &mBlock; }
+private:
+    XCMemBlock mBlock;
+};
+
+} // namespace
+
+namespace bench
+{
+
+ImageSuite::ImageSuite(Recorder& aRecorder, const RigParam& aParam)
+    : mRecorder(aRecorder)
+    , mParam(aParam)
+    , mLog()
+{
+}
+
+bool ImageSuite::run()
+{
+    runGridMesh();
+    runPackBits();
+    runSerializer();
+    return runPsd();
+}
+
+void ImageSuite::runGridMesh()
+{
+    const QSize size = mParam.canvasSize;
+    const int cellSize = mParam.cellSize;
+    ScopedBlock image(SyntheticImage::createBlob(size, 0));
+
+    std::vector<GLfloat> positions;
+    std::vector<GLfloat> texCoords;
+    std::vector<GLuint> indices;
+    std::vector<img::GridMeshCreator::HexaConnection> connections;
+
+    QJsonObject params;
+    params["width"] = size.width();
+    params["height"] = size.height();
+    params["cell_size"] = cellSize;
+
+    mRecorder.measure("img.GridMeshCreator", params, [&]()
+    {
+        img::GridMeshCreator creator(image->data, size, cellSize);
+        positions.resize(creator.vertexCount() * 3);
+        texCoords.resize(creator.vertexCount() * 2);
+        indices.resize(creator.indexCount());
+        connections.resize(creator.vertexCount());
+
+        if (creator.vertexCount() > 0 && creator.indexCount() > 0)
+        {
+            creator.writeIndices(indices.data());
+            creator.writeVertices(positions.data(), texCoords.data());
+            creator.writeConnections(connections.data());
+        }
+    });
+}
+
+void ImageSuite::runPackBits()
+{
+    const QSize size = mParam.canvasSize;
+    const int w = size.width();
+    const int h = size.height();
+    ScopedBlock image(SyntheticImage::createBlob(size, 1));
+
+    // planar lines like the project file
+    std::vector<uint8> planes((size_t)w * h * 4);
+    for (int i = 0; i < w * h; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            planes[(size_t)c * w * h + i] = image->data[i * 4 + c];
+        }
+    }
+
+    const size_t lineCount = (size_t)h * 4;
+    const size_t worstSize = util::PackBits::worstEncodedSize((size_t)w);
+    std::vector<uint8> encoded(worstSize * lineCount);
+    std::vector<size_t> encodedSizes(lineCount);
+    std::vector<uint8> decoded((size_t)w);
+
+    QJsonObject params;
+    params["width"] = w;
+    params["height"] = h;
+    params["bytes"] = (double)planes.size();
+
+    auto encodeLines = [&]()
+    {
+        util::PackBits encoder;
+        for (size_t i = 0; i < lineCount; ++i)
+        {
+            const XCMemBlock src(planes.data() + i * w, (size_t)w);
+            encodedSizes[i] = encoder.encode(src, encoded.data() + i * worstSize);
+        }
+    };
+    mRecorder.measure("util.PackBits.encode", params, encodeLines);
+
+    // (the encoder case may be filtered)
+    if (!mRecorder.isEnabled("util.PackBits.encode")) encodeLines();
+
+    mRecorder.measure("util.PackBits.decode", params, [&]()
+    {
+        util::PackBits decoder;
+        XCMemBlock dst(decoded.data(), decoded.size());
+        for (size_t i = 0; i < lineCount; ++i)
+        {
+            const XCMemBlock src(encoded.data() + i * worstSize, encodedSizes[i]);
+            decoder.decode(src, dst);
+        }
+    });
+
+    // psd style (interleaved to plane)
+    std::vector<XCMemBlock> channels(4);
+    mRecorder.measure("img.PSDUtil.encodePlanePackBits", params, [&]()
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            channels[c] = img::PSDUtil::encodePlanePackBits(
+                        image->data + c, image->size, w, h, 4);
+        }
+    },
+    [&]()
+    {
+        for (auto& channel : channels)
+        {
+            delete [] channel.data;
+            channel = XCMemBlock();
+        }
+    });
+
+    // (the encoder case may be filtered)
+    for (int c = 0; c < 4 && !channels[c].data; ++c)
+    {
+        channels[c] = img::PSDUtil::encodePlanePackBits(image->data + c, image->size, w, h, 4);
+    }
+
+    std::vector<uint8> interleaved(image->size);
+    mRecorder.measure("img.PSDUtil.decodePlanePackBits", params, [&]()
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            img::PSDUtil::decodePlanePackBits(
+                        interleaved.data() + c, interleaved.size() - c,
+                        channels[c].data, channels[c].size, w, h, 4);
+        }
+    });
+
+    for (auto& channel : channels)
+    {
+        delete [] channel.data;
+    }
+}
+
+void ImageSuite::runSerializer()
+{
+    const QSize size = mParam.canvasSize;
+    ScopedBlock image(SyntheticImage::createBlob(size, 2));
+
+    QJsonObject params;
+    params["width"] = size.width();
+    params["height"] = size.height();
+
+    std::string serialized;
+    auto writeImage = [&]()
+    {
+        std::ostringstream stream(std::ios::out | std::ios::binary);
+        util::StreamWriter writer(stream);
+        core::Serializer out(writer);
+        out.writeImage(*image, size);
+        serialized = stream.str();
+    };
+    mRecorder.measure("core.Serializer.writeImage", params, writeImage);
+
+    // (the writer case may be filtered)
+    if (serialized.empty()) writeImage();
+
+    gl::DeviceInfo deviceInfo;
+    deviceInfo.maxTextureSize = std::max(size.width(), size.height());
+    SilentReporter reporter;
+
+    mRecorder.measure("core.Deserializer.readImage", params, [&]()
+    {
+        std::istringstream stream(serialized, std::ios::in | std::ios::binary);
+        util::LEStreamReader reader(stream);
+        core::Deserializer::IDSolverType solver;
+        core::Deserializer in(
+                    reader, solver, serialized.size(),
+                    QVersionNumber(AE_PROJECT_FORMAT_MAJOR_VERSION, AE_PROJECT_FORMAT_MINOR_VERSION),
+                    deviceInfo, reporter, 0);
+
+        XCMemBlock block;
+        if (!in.readImage(block))
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to read a serialized image.", "");
+        }
+        delete [] block.data;
+    });
+}
+
+bool ImageSuite::runPsd()
+{
+    auto format = SyntheticImage::createPsd(mParam.canvasSize, SyntheticRig::layerRects(mParam));
+    if (!format)
+    {
+        mLog = "Failed to create a synthetic psd.";
+        return false;
+    }
+
+    QJsonObject params;
+    params["width"] = mParam.canvasSize.width();
+    params["height"] = mParam.canvasSize.height();
+    params["layers"] = mParam.layerCount;
+
+    std::string written;
+    mRecorder.measure("img.PSDWriter", params, [&]()
+    {
+        SyntheticImage::writePsd(*format, written);
+    });
+
+    // (the writer case may be filtered)
+    if (written.empty() && !SyntheticImage::writePsd(*format, written))
+    {
+        mLog = "Failed to write a synthetic psd.";
+        return false;
+    }
+    params["bytes"] = (double)written.size();
+
+    mRecorder.measure("img.PSDReader", params, [&]()
+    {
+        std::istringstream stream(written, std::ios::in | std::ios::binary);
+        img::PSDReader reader(stream);
+        if (reader.resultCode() != img::PSDReader::ResultCode_Success)
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to read a synthetic psd.",
+                           QString::fromStdString(reader.resultMessage()));
+        }
+    });
+    return true;
+}
+
+} // namespace bench
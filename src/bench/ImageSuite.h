@@ -0,0 +1,32 @@
+#ifndef BENCH_IMAGESUITE_H
+#define BENCH_IMAGESUITE_H
+
+#include "bench/Recorder.h"
+#include "bench/SyntheticRig.h"
+
+namespace bench
+{
+
+// cases which don't require any opengl context.
+// (grid mesh creation, packbits, image serialization and psd)
+class ImageSuite
+{
+public:
+    ImageSuite(Recorder& aRecorder, const RigParam& aParam);
+    bool run();
+    const QString& log() const { return mLog; }
+
+private:
+    void runGridMesh();
+    void runPackBits();
+    void runSerializer();
+    bool runPsd();
+
+    Recorder& mRecorder;
+    RigParam mParam;
+    QString mLog;
+};
+
+} // namespace bench
+
+#endif // BENCH_IMAGESUITE_H
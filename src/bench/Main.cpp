@@ -0,0 +1,180 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSysInfo>
+#include <QThread>
+#include "XC.h"
+#include "gl/Global.h"
+#include "bench/Recorder.h"
+#include "gl/OffscreenContext.h"
+#include "bench/SyntheticRig.h"
+#include "bench/ImageSuite.h"
+#include "bench/ThreadSuite.h"
+#include "bench/RigSuite.h"
+
+class BenchAssertHandler : public XCAssertHandler
+{
+public:
+    virtual void failure() const {}
+};
+
+class BenchErrorHandler : public XCErrorHandler
+{
+public:
+    virtual void critical(
+            const QString& aText, const QString& aInfo,
+            const QString& aDetail) const
+    {
+        std::fprintf(stderr, "%s\n%s\n%s\n",
+                     aText.toLocal8Bit().constData(),
+                     aInfo.toLocal8Bit().constData(),
+                     aDetail.toLocal8Bit().constData());
+        std::exit(EXIT_FAILURE);
+    }
+};
+
+XCAssertHandler* gXCAssertHandler = nullptr;
+XCErrorHandler* gXCErrorHandler = nullptr;
+static BenchAssertHandler sBenchAssertHandler;
+static BenchErrorHandler sBenchErrorHandler;
+static bool sVerbose = false;
+
+static void benchMessageHandler(
+        QtMsgType aType, const QMessageLogContext&, const QString& aMessage)
+{
+    // the core libraries are very talkative
+    if (aType == QtDebugMsg && !sVerbose) return;
+    std::fprintf(stderr, "%s\n", aMessage.toLocal8Bit().constData());
+}
+
+int main(int argc, char *argv[])
+{
+    gXCAssertHandler = &sBenchAssertHandler;
+    gXCErrorHandler = &sBenchErrorHandler;
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("AnimeEffectsBench");
+
+    // application path (shaders are loaded from ./data)
+#if defined(Q_OS_MAC)
+    const QString appDir = QDir(app.applicationDirPath() + "/../../").absolutePath();
+#else
+    const QString appDir = app.applicationDirPath();
+#endif
+    QDir::setCurrent(appDir);
+
+    // command line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless benchmarks of AnimeEffects.");
+    parser.addHelpOption();
+
+    const QCommandLineOption layersOption("layers", "The number of layers.", "count", "16");
+    const QCommandLineOption bonesOption("bones", "The number of bones.", "count", "8");
+    const QCommandLineOption poseKeysOption("pose-keys", "The number of pose keys.", "count", "4");
+    const QCommandLineOption ffdKeysOption("ffd-keys", "The number of ffd keys per layer.", "count", "4");
+    const QCommandLineOption cellOption("cell", "The cell size of layer meshes.", "pixels", "8");
+    const QCommandLineOption sizeOption("size", "The canvas size.", "pixels", "1024");
+    const QCommandLineOption framesOption("frames", "The number of frames.", "count", "60");
+    const QCommandLineOption iterationsOption("iterations", "The iteration count of each case.", "count", "5");
+    const QCommandLineOption filterOption("filter", "Run only cases matching the regexp.", "regexp");
+    const QCommandLineOption outputOption("output", "Write json results to the file.", "path");
+    const QCommandLineOption noGLOption("no-gl", "Skip cases which require an opengl context.");
+    const QCommandLineOption verboseOption("verbose", "Print debug messages.");
+    parser.addOptions({ layersOption, bonesOption, poseKeysOption, ffdKeysOption,
+                        cellOption, sizeOption, framesOption, iterationsOption,
+                        filterOption, outputOption, noGLOption, verboseOption });
+    parser.process(app);
+
+    sVerbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(benchMessageHandler);
+
+    bench::RigParam param;
+    const int size = std::max(parser.value(sizeOption).toInt(), 16);
+    param.canvasSize = QSize(size, size);
+    param.layerCount = std::max(parser.value(layersOption).toInt(), 1);
+    param.boneCount = std::max(parser.value(bonesOption).toInt(), 0);
+    param.poseKeyCount = std::max(parser.value(poseKeysOption).toInt(), 0);
+    param.ffdKeyCount = std::max(parser.value(ffdKeysOption).toInt(), 0);
+    param.cellSize = std::max(parser.value(cellOption).toInt(), 2);
+    param.frameCount = std::max(parser.value(framesOption).toInt(), 2);
+
+    bench::Recorder recorder(std::max(parser.value(iterationsOption).toInt(), 1));
+    if (parser.isSet(filterOption))
+    {
+        recorder.setFilter(parser.value(filterOption));
+    }
+
+    // environment
+    recorder.setEnvironment("version", QString("%1.%2.%3")
+                            .arg(AE_MAJOR_VERSION).arg(AE_MINOR_VERSION).arg(AE_MICRO_VERSION));
+    recorder.setEnvironment("cpu", QSysInfo::currentCpuArchitecture());
+    recorder.setEnvironment("os", QSysInfo::prettyProductName());
+    recorder.setEnvironment("threads", QThread::idealThreadCount());
+    recorder.setEnvironment("rig", param.toJson());
+    recorder.setEnvironment("date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+
+    int result = EXIT_SUCCESS;
+    {
+        bench::ImageSuite imageSuite(recorder, param);
+        if (!imageSuite.run())
+        {
+            std::fprintf(stderr, "%s\n", imageSuite.log().toLocal8Bit().constData());
+            result = EXIT_FAILURE;
+        }
+    }
+    {
+        bench::ThreadSuite threadSuite(recorder, param);
+        if (!threadSuite.run())
+        {
+            std::fprintf(stderr, "%s\n", threadSuite.log().toLocal8Bit().constData());
+            result = EXIT_FAILURE;
+        }
+    }
+
+    if (!parser.isSet(noGLOption))
+    {
+        gl::OffscreenContext context;
+        if (!context.create())
+        {
+            std::fprintf(stderr, "%s\n", context.log().toLocal8Bit().constData());
+            result = EXIT_FAILURE;
+        }
+        else
+        {
+            recorder.setEnvironment("gl_renderer", QString::fromStdString(context.deviceInfo().renderer));
+            recorder.setEnvironment("gl_version", QString::fromStdString(context.deviceInfo().version));
+
+            bench::RigSuite rigSuite(recorder, param, context);
+            if (!rigSuite.run())
+            {
+                std::fprintf(stderr, "%s\n", rigSuite.log().toLocal8Bit().constData());
+                result = EXIT_FAILURE;
+            }
+        }
+    }
+
+    // output
+    const QByteArray json = recorder.toJson().toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption))
+    {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) < 0)
+        {
+            std::fprintf(stderr, "Failed to write %s\n",
+                         parser.value(outputOption).toLocal8Bit().constData());
+            result = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        std::fwrite(json.constData(), 1, (size_t)json.size(), stdout);
+    }
+    std::fprintf(stderr, "%s", recorder.summary().toLocal8Bit().constData());
+
+    return result;
+}
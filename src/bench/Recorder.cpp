@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include "XC.h"
+#include "bench/Recorder.h"
+
+namespace bench
+{
+
+Recorder::Recorder(int aIterations)
+    : mIterations(std::max(aIterations, 1))
+    , mFilter()
+    , mEnvironment()
+    , mResults()
+{
+}
+
+void Recorder::setFilter(const QString& aPattern)
+{
+    mFilter = QRegExp(aPattern);
+}
+
+void Recorder::setEnvironment(const QString& aKey, const QJsonValue& aValue)
+{
+    mEnvironment.insert(aKey, aValue);
+}
+
+bool Recorder::isEnabled(const QString& aName) const
+{
+    if (mFilter.isEmpty() || !mFilter.isValid()) return true;
+    return mFilter.indexIn(aName) >= 0;
+}
+
+void Recorder::measure(const QString& aName, const QJsonObject& aParams,
+                       const FuncType& aFunc, const FuncType& aSetup)
+{
+    if (!isEnabled(aName)) return;
+
+    XC_REPORT() << "measure" << aName;
+
+    Result result;
+    result.name = aName;
+    result.params = aParams;
+
+    // warm up
+    if (aSetup) aSetup();
+    aFunc();
+
+    QElapsedTimer timer;
+    for (int i = 0; i < mIterations; ++i)
+    {
+        if (aSetup) aSetup();
+
+        timer.start();
+        aFunc();
+        result.msecs.push_back(timer.nsecsElapsed() / 1000000.0);
+    }
+    mResults.push_back(result);
+}
+
+QJsonDocument Recorder::toJson() const
+{
+    QJsonArray results;
+    for (auto& result : mResults)
+    {
+        QVector<double> sorted = result.msecs;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (auto msec : sorted) total += msec;
+
+        const int count = sorted.size();
+        const double median = (count % 2) ?
+                    sorted[count / 2] :
+                    (sorted[count / 2 - 1] + sorted[count / 2]) * 0.5;
+
+        QJsonObject object;
+        object["name"] = result.name;
+        object["params"] = result.params;
+        object["iterations"] = count;
+        object["min_ms"] = sorted.front();
+        object["median_ms"] = median;
+        object["mean_ms"] = total / count;
+        object["max_ms"] = sorted.back();
+        results.append(object);
+    }
+
+    QJsonObject root;
+    root["environment"] = mEnvironment;
+    root["results"] = results;
+    return QJsonDocument(root);
+}
+
+QString Recorder::summary() const
+{
+    QString text;
+    for (auto& result : mResults)
+    {
+        QVector<double> sorted = result.msecs;
+        std::sort(sorted.begin(), sorted.end());
+        text += QString("%1 : min %2 ms, median %3 ms\n")
+                .arg(result.name, -32)
+                .arg(sorted.front(), 0, 'f', 3)
+                .arg(sorted[sorted.size() / 2], 0, 'f', 3);
+    }
+    return text;
+}
+
+} // namespace bench
@@ -0,0 +1,50 @@
+#ifndef BENCH_RECORDER_H
+#define BENCH_RECORDER_H
+
+#include <functional>
+#include <QString>
+#include <QRegExp>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+namespace bench
+{
+
+// measures the wall clock time of each case and keeps them as json.
+class Recorder
+{
+public:
+    typedef std::function<void()> FuncType;
+
+    Recorder(int aIterations);
+
+    void setFilter(const QString& aPattern);
+    void setEnvironment(const QString& aKey, const QJsonValue& aValue);
+
+    bool isEnabled(const QString& aName) const;
+
+    // aSetup is called before each iteration and it's not measured.
+    void measure(const QString& aName, const QJsonObject& aParams,
+                 const FuncType& aFunc, const FuncType& aSetup = FuncType());
+
+    QJsonDocument toJson() const;
+    QString summary() const;
+
+private:
+    struct Result
+    {
+        QString name;
+        QJsonObject params;
+        QVector<double> msecs;
+    };
+
+    int mIterations;
+    QRegExp mFilter;
+    QJsonObject mEnvironment;
+    QVector<Result> mResults;
+};
+
+} // namespace bench
+
+#endif // BENCH_RECORDER_H
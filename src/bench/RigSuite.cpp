@@ -0,0 +1,358 @@
+#include <fstream>
+#include <set>
+#include <vector>
+#include <QDir>
+#include <QOpenGLFramebufferObject>
+#include "XC.h"
+#include "gl/Global.h"
+#include "gl/Util.h"
+#include "core/TimeKeyBlender.h"
+#include "core/PoseKey.h"
+#include "core/FFDKey.h"
+#include "core/RenderInfo.h"
+#include "core/ClippingFrame.h"
+#include "core/DestinationTexturizer.h"
+#include "ctrl/ProjectSaver.h"
+#include "ctrl/ProjectLoader.h"
+#include "ctrl/Exporter.h"
+#include "bench/SyntheticImage.h"
+#include "bench/RigSuite.h"
+
+namespace bench
+{
+
+RigSuite::RigSuite(Recorder& aRecorder, const RigParam& aParam, gl::OffscreenContext& aContext)
+    : mRecorder(aRecorder)
+    , mParam(aParam)
+    , mContext(aContext)
+    , mWorkDir()
+    , mPsdPath()
+    , mLog()
+{
+}
+
+bool RigSuite::run()
+{
+    XC_ASSERT(mContext.isValid());
+
+    if (!writePsdFile()) return false;
+
+    runBuild();
+
+    SyntheticRig rig(mParam, mContext.deviceInfo());
+    if (!rig.build(mPsdPath))
+    {
+        mLog = "Failed to build a synthetic rig. " + rig.log();
+        return false;
+    }
+
+    runInfluence(rig);
+    runBlender(rig);
+    runRender(rig);
+    if (!runSteppedExport(rig)) return false;
+    runProjectFile(rig);
+    return true;
+}
+
+bool RigSuite::writePsdFile()
+{
+    if (!mWorkDir.isValid())
+    {
+        mLog = "Failed to create a temporary directory.";
+        return false;
+    }
+    mPsdPath = mWorkDir.path() + "/rig.psd";
+
+    auto format = SyntheticImage::createPsd(mParam.canvasSize, SyntheticRig::layerRects(mParam));
+    std::string written;
+    if (!format || !SyntheticImage::writePsd(*format, written))
+    {
+        mLog = "Failed to create a synthetic psd.";
+        return false;
+    }
+
+    std::ofstream file(mPsdPath.toLocal8Bit(), std::ios::binary);
+    file.write(written.data(), (std::streamsize)written.size());
+    if (file.fail())
+    {
+        mLog = "Failed to write a synthetic psd file.";
+        return false;
+    }
+    return true;
+}
+
+void RigSuite::runBuild()
+{
+    // psd loading, texture and mesh creation, key pushing and first influence maps
+    QScopedPointer<SyntheticRig> rig;
+    mRecorder.measure("ctrl.SyntheticRig.build", mParam.toJson(), [&]()
+    {
+        rig.reset(new SyntheticRig(mParam, mContext.deviceInfo()));
+        if (!rig->build(mPsdPath))
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to build a synthetic rig.", rig->log());
+        }
+        // wait influence maps
+        if (rig->boneKey())
+        {
+            for (auto cache : rig->boneKey()->caches()) cache->influence().accessor();
+        }
+    },
+    [&]()
+    {
+        rig.reset();
+    });
+}
+
+void RigSuite::runInfluence(SyntheticRig& aRig)
+{
+    auto boneKey = aRig.boneKey();
+    if (!boneKey) return;
+
+    auto& project = aRig.project();
+    auto& topNode = *project.objectTree().topNode();
+
+    QJsonObject params = mParam.toJson();
+    params["caches"] = boneKey->caches().count();
+
+    mRecorder.measure("core.BoneInfluenceMap.build", params, [&]()
+    {
+        // measure full writing
+        for (auto cache : boneKey->caches()) cache->influence().invalidate();
+        boneKey->resetCaches(project, topNode);
+        for (auto cache : boneKey->caches()) cache->influence().accessor();
+    });
+}
+
+void RigSuite::runBlender(SyntheticRig& aRig)
+{
+    auto& project = aRig.project();
+    auto topNode = project.objectTree().topNode();
+
+    mRecorder.measure("core.TimeKeyBlender.updateCurrents", mParam.toJson(), [&]()
+    {
+        core::TimeInfo time = project.currentTimeInfo();
+        core::TimeKeyBlender blender(*topNode, true);
+
+        for (int frame = 0; frame < mParam.frameCount; ++frame)
+        {
+            time.frame = core::Frame(frame);
+            blender.updateCurrents(topNode, time);
+        }
+    },
+    [&]()
+    {
+        core::TimeKeyBlender(*topNode, true).clearCaches(topNode);
+    });
+}
+
+void RigSuite::runRender(SyntheticRig& aRig)
+{
+    auto& project = aRig.project();
+    const QSize size = project.attribute().imageSize();
+
+    gl::Global::makeCurrent();
+    gl::Global::Functions& ggl = gl::Global::functions();
+
+    auto topNode = project.objectTree().topNode();
+    core::TimeKeyBlender blender(*topNode, true);
+
+    QOpenGLFramebufferObject framebuffer(size);
+    core::ClippingFrame clippingFrame;
+    clippingFrame.resize(size);
+    core::DestinationTexturizer destTexturizer;
+    destTexturizer.resize(size);
+
+    auto renderFrame = [&](int aFrame)
+    {
+        core::TimeInfo time = project.currentTimeInfo();
+        time.frame = core::Frame(aFrame);
+        blender.updateCurrents(topNode, time);
+
+        clippingFrame.clearTexture();
+        clippingFrame.resetClippingId();
+        destTexturizer.clearTexture();
+
+        if (!framebuffer.bind())
+        {
+            XC_FATAL_ERROR("OpenGL Error", "Failed to bind framebuffer.", "");
+        }
+        gl::Util::setViewportAsActualPixels(size);
+        gl::Util::clearColorBuffer(0.0, 0.0, 0.0, 0.0);
+        gl::Util::resetRenderState();
+
+        core::RenderInfo renderInfo;
+        renderInfo.camera.reset(size, 1.0, size, QPoint());
+        renderInfo.time = time;
+        renderInfo.framebuffer = framebuffer.handle();
+        renderInfo.dest = framebuffer.texture();
+        renderInfo.isGrid = false;
+        renderInfo.clippingId = 0;
+        renderInfo.clippingFrame = &clippingFrame;
+        renderInfo.destTexturizer = &destTexturizer;
+        project.objectTree().render(renderInfo, true);
+
+        framebuffer.release();
+    };
+
+    QJsonObject params = mParam.toJson();
+
+    // evaluation and drawing of each frame
+    mRecorder.measure("core.ObjectTree.render.playback", params, [&]()
+    {
+        for (int frame = 0; frame < mParam.frameCount; ++frame)
+        {
+            renderFrame(frame);
+        }
+        ggl.glFinish();
+    },
+    [&]()
+    {
+        blender.clearCaches(topNode);
+    });
+
+    // drawing only (the evaluation is cached)
+    mRecorder.measure("core.ObjectTree.render.still", params, [&]()
+    {
+        renderFrame(0);
+        ggl.glFinish();
+    });
+    GL_CHECK_ERROR();
+}
+
+bool RigSuite::runSteppedExport(SyntheticRig& aRig)
+{
+    static const char* kName = "ctrl.Exporter.execute.stepped";
+    if (!mRecorder.isEnabled(kName)) return true;
+
+    auto& project = aRig.project();
+    auto topNode = project.objectTree().topNode();
+
+    // hold every pose and ffd until the next key, then the scene changes
+    // on the key frames only
+    std::vector<std::pair<util::Easing::Param*, util::Easing::Param>> easings;
+    std::set<int> keyFrames = { 0 };
+    for (core::ObjectNode::Iterator itr(topNode); itr.hasNext();)
+    {
+        auto node = itr.next();
+        if (!node->timeLine()) continue;
+
+        for (int i = 0; i < core::TimeKeyType_TERM; ++i)
+        {
+            const core::TimeKeyType type = (core::TimeKeyType)i;
+            auto& keys = node->timeLine()->keys(type);
+            for (int k = 0; k < keys.size(); ++k)
+            {
+                keyFrames.insert(keys.frame(k));
+
+                util::Easing::Param* easing = nullptr;
+                if (type == core::TimeKeyType_Pose)
+                {
+                    easing = &((core::PoseKey*)keys.key(k))->data().easing();
+                }
+                else if (type == core::TimeKeyType_FFD)
+                {
+                    easing = &((core::FFDKey*)keys.key(k))->data().easing();
+                }
+                if (!easing) continue;
+
+                easings.push_back(std::make_pair(easing, *easing));
+                easing->type = util::Easing::Type_None;
+            }
+        }
+    }
+    core::TimeKeyBlender(*topNode, true).clearCaches(topNode);
+
+    int heldCount = 0;
+    for (int frame : keyFrames)
+    {
+        if (frame < mParam.frameCount) ++heldCount;
+    }
+    const int expected = mParam.frameCount - heldCount;
+
+    const QString dir = mWorkDir.path() + "/stepped";
+    QDir().mkpath(dir);
+
+    ctrl::Exporter::CommonParam common;
+    common.path = dir;
+    common.size = project.attribute().imageSize();
+    common.frame = util::Range(0, mParam.frameCount - 1);
+    common.fps = project.attribute().fps();
+    ctrl::Exporter::ImageParam image;
+    image.name = "frame";
+
+    QJsonObject params = mParam.toJson();
+    params["expected_duplicates"] = expected;
+
+    int duplicated = 0;
+    mRecorder.measure(kName, params, [&]()
+    {
+        ctrl::Exporter exporter(project);
+        exporter.setOverwriteConfirmer([](const QString&) { return true; });
+        exporter.setShardCount(1);
+        if (!exporter.execute(common, image))
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to export a stepped clip.", exporter.log());
+        }
+        duplicated = exporter.duplicatedFrameCount();
+    });
+
+    // restore the easings
+    for (auto& easing : easings)
+    {
+        *easing.first = easing.second;
+    }
+    core::TimeKeyBlender(*topNode, true).clearCaches(topNode);
+
+    if (duplicated != expected)
+    {
+        mLog = QString("The stepped export duplicated %1 frames, but %2 frames are held.")
+                .arg(duplicated).arg(expected);
+        return false;
+    }
+    return true;
+}
+
+void RigSuite::runProjectFile(SyntheticRig& aRig)
+{
+    auto& project = aRig.project();
+    const QString path = mWorkDir.path() + "/rig.anie";
+    QJsonObject params = mParam.toJson();
+
+    auto save = [&]()
+    {
+        ctrl::ProjectSaver saver;
+        if (!saver.save(path, project))
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to save a project.", saver.log());
+        }
+    };
+    mRecorder.measure("ctrl.ProjectSaver.save", params, save);
+
+    // (the saver case may be filtered)
+    if (!mRecorder.isEnabled("ctrl.ProjectSaver.save")) save();
+
+    FixedAnimator animator;
+    QScopedPointer<core::Project> loaded;
+    auto resetLoaded = [&]()
+    {
+        gl::Global::makeCurrent();
+        loaded.reset();
+    };
+
+    mRecorder.measure("ctrl.ProjectLoader.load", params, [&]()
+    {
+        SilentReporter reporter;
+        loaded.reset(new core::Project(path, animator, nullptr));
+        ctrl::ProjectLoader loader;
+        if (!loader.load(path, *loaded, mContext.deviceInfo(), reporter))
+        {
+            XC_FATAL_ERROR("Bench Error", "Failed to load a project.", loader.log().join("\n"));
+        }
+    },
+    resetLoaded);
+
+    resetLoaded();
+}
+
+} // namespace bench
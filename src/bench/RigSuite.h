@@ -0,0 +1,39 @@
+#ifndef BENCH_RIGSUITE_H
+#define BENCH_RIGSUITE_H
+
+#include <QTemporaryDir>
+#include "bench/Recorder.h"
+#include "bench/SyntheticRig.h"
+#include "gl/OffscreenContext.h"
+
+namespace bench
+{
+
+// cases which run on a synthetic project. (it requires an opengl context)
+class RigSuite
+{
+public:
+    RigSuite(Recorder& aRecorder, const RigParam& aParam, gl::OffscreenContext& aContext);
+    bool run();
+    const QString& log() const { return mLog; }
+
+private:
+    bool writePsdFile();
+    void runBuild();
+    void runInfluence(SyntheticRig& aRig);
+    void runBlender(SyntheticRig& aRig);
+    void runRender(SyntheticRig& aRig);
+    bool runSteppedExport(SyntheticRig& aRig);
+    void runProjectFile(SyntheticRig& aRig);
+
+    Recorder& mRecorder;
+    RigParam mParam;
+    gl::OffscreenContext& mContext;
+    QTemporaryDir mWorkDir;
+    QString mPsdPath;
+    QString mLog;
+};
+
+} // namespace bench
+
+#endif // BENCH_RIGSUITE_H
@@ -0,0 +1,184 @@
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+#include "img/PSDUtil.h"
+#include "img/PSDWriter.h"
+#include "bench/SyntheticImage.h"
+
+namespace
+{
+
+// deterministic random numbers to keep results comparable between runs
+class Random
+{
+public:
+    Random(int aSeed) : mState(0x9e3779b9u ^ (uint32)aSeed) { next(); }
+    uint32 next()
+    {
+        mState = mState * 1664525u + 1013904223u;
+        return mState >> 8;
+    }
+    float nextRate() { return (next() & 0xffff) / 65535.0f; }
+private:
+    uint32 mState;
+};
+
+img::PSDFormat::Rect toPSDRect(const QRect& aRect)
+{
+    img::PSDFormat::Rect rect;
+    rect.edge[0] = aRect.top();
+    rect.edge[1] = aRect.left();
+    rect.edge[2] = aRect.top() + aRect.height();
+    rect.edge[3] = aRect.left() + aRect.width();
+    return rect;
+}
+
+img::PSDFormat::ChannelPtr createChannel(sint16 aId, uint16 aCompressionId, uint32 aDataLength)
+{
+    img::PSDFormat::ChannelPtr channel(new img::PSDFormat::Channel());
+    channel->id = aId;
+    channel->compressionId = aCompressionId;
+    channel->dataLength = aDataLength;
+    if (aDataLength > 0)
+    {
+        channel->data.reset(new uint8[aDataLength]);
+        std::fill(channel->data.get(), channel->data.get() + aDataLength, (uint8)0);
+    }
+    return channel;
+}
+
+} // namespace
+
+namespace bench
+{
+
+XCMemBlock SyntheticImage::createBlob(const QSize& aSize, int aSeed)
+{
+    const int w = aSize.width();
+    const int h = aSize.height();
+    const size_t size = (size_t)w * h * 4;
+    XCMemBlock block(new uint8[size], size);
+
+    Random random(aSeed);
+
+    // holes
+    struct Hole { float x; float y; float r; };
+    Hole holes[4];
+    for (auto& hole : holes)
+    {
+        hole.x = (0.25f + 0.5f * random.nextRate()) * w;
+        hole.y = (0.25f + 0.5f * random.nextRate()) * h;
+        hole.r = (0.03f + 0.07f * random.nextRate()) * std::min(w, h);
+    }
+
+    const float cx = 0.5f * w;
+    const float cy = 0.5f * h;
+    const float rx = 0.45f * w;
+    const float ry = 0.45f * h;
+    const int bands = 4 + (int)(random.next() % 8);
+    const uint8 tint = (uint8)(random.next() & 0xff);
+
+    for (int y = 0; y < h; ++y)
+    {
+        uint8* dst = block.data + (size_t)y * w * 4;
+        const float dy = (y + 0.5f - cy) / ry;
+
+        for (int x = 0; x < w; ++x, dst += 4)
+        {
+            const float dx = (x + 0.5f - cx) / rx;
+            const float dist = std::sqrt(dx * dx + dy * dy);
+
+            // soft edge
+            float alpha = xc_clamp((1.0f - dist) * std::min(rx, ry) * 0.25f, 0.0f, 1.0f);
+            for (auto& hole : holes)
+            {
+                const float hx = x + 0.5f - hole.x;
+                const float hy = y + 0.5f - hole.y;
+                if (hx * hx + hy * hy < hole.r * hole.r) alpha = 0.0f;
+            }
+
+            if (alpha <= 0.0f)
+            {
+                dst[0] = dst[1] = dst[2] = dst[3] = 0;
+                continue;
+            }
+
+            // flat color bands and a gradation
+            const int band = (x * bands) / std::max(w, 1);
+            dst[0] = (uint8)(band * 255 / bands);
+            dst[1] = (uint8)(y * 255 / std::max(h, 1));
+            dst[2] = tint;
+            dst[3] = (uint8)(alpha * 255.0f);
+        }
+    }
+    return block;
+}
+
+std::unique_ptr<img::PSDFormat> SyntheticImage::createPsd(
+        const QSize& aCanvasSize, const QVector<QRect>& aLayerRects)
+{
+    using img::PSDFormat;
+    std::unique_ptr<PSDFormat> format(new PSDFormat());
+
+    // header
+    PSDFormat::Header& header = format->header();
+    header.version = 1;
+    header.channels = 4;
+    header.width = (uint32)aCanvasSize.width();
+    header.height = (uint32)aCanvasSize.height();
+    header.depth = 8;
+    header.mode = PSDFormat::ColorMode_RGB;
+
+    // layers (the first layer is the bottom)
+    int index = 0;
+    for (auto rect : aLayerRects)
+    {
+        PSDFormat::LayerPtr layer(new PSDFormat::Layer());
+        layer->rect = toPSDRect(rect);
+        layer->blendMode = "norm";
+        layer->opacity = 255;
+        layer->clipping = 0;
+        layer->flags = 0;
+        layer->name = "layer" + std::to_string(index);
+
+        layer->channels.push_back(createChannel(-1, 1, 0));
+        layer->channels.push_back(createChannel( 0, 1, 0));
+        layer->channels.push_back(createChannel( 1, 1, 0));
+        layer->channels.push_back(createChannel( 2, 1, 0));
+
+        XCMemBlock image = createBlob(rect.size(), index);
+        const bool success = img::PSDUtil::makeChanneledImage(
+                    *layer, header, image, img::PSDUtil::ColorFormat_RGBA8);
+        delete [] image.data;
+        if (!success) return std::unique_ptr<PSDFormat>();
+
+        format->layerAndMaskInfo().layers.push_back(std::move(layer));
+        ++index;
+    }
+    format->layerAndMaskInfo().layerCount = (sint16)index;
+
+    // merged image (raw transparent)
+    PSDFormat::ImageData& imageData = format->imageData();
+    imageData.compressionId = 0;
+    imageData.hasTransparency = 1;
+    const uint32 planeSize = header.width * header.height;
+    for (int i = 0; i < header.channels; ++i)
+    {
+        imageData.channels.push_back(createChannel(i < 3 ? (sint16)i : (sint16)-1, 0, planeSize));
+    }
+    return format;
+}
+
+bool SyntheticImage::writePsd(const img::PSDFormat& aFormat, std::string& aDst)
+{
+    std::ostringstream out(std::ios::out | std::ios::binary);
+    img::PSDWriter writer(out, aFormat);
+    if (writer.resultCode() != img::PSDWriter::ResultCode_Success)
+    {
+        return false;
+    }
+    aDst = out.str();
+    return true;
+}
+
+} // namespace bench
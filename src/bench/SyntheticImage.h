@@ -0,0 +1,32 @@
+#ifndef BENCH_SYNTHETICIMAGE_H
+#define BENCH_SYNTHETICIMAGE_H
+
+#include <string>
+#include <memory>
+#include <QSize>
+#include <QRect>
+#include <QVector>
+#include "XC.h"
+#include "img/PSDFormat.h"
+
+namespace bench
+{
+
+class SyntheticImage
+{
+public:
+    // a rgba8 image which has a soft-edged blob with some holes.
+    // the colors consist of gradations and flat runs like a painted layer.
+    static XCMemBlock createBlob(const QSize& aSize, int aSeed);
+
+    // a psd format which has rgba layers of each rect. (rle compressed)
+    static std::unique_ptr<img::PSDFormat> createPsd(
+            const QSize& aCanvasSize, const QVector<QRect>& aLayerRects);
+
+    // write psd to a memory.
+    static bool writePsd(const img::PSDFormat& aFormat, std::string& aDst);
+};
+
+} // namespace bench
+
+#endif // BENCH_SYNTHETICIMAGE_H
@@ -0,0 +1,248 @@
+#include <cmath>
+#include "XC.h"
+#include "cmnd/ScopedMacro.h"
+#include "cmnd/BasicCommands.h"
+#include "gl/Global.h"
+#include "core/ObjectNode.h"
+#include "core/TimeLine.h"
+#include "core/ImageKey.h"
+#include "core/PoseKey.h"
+#include "core/FFDKey.h"
+#include "ctrl/ImageFileLoader.h"
+#include "ctrl/TimeLineUtil.h"
+#include "ctrl/bone/bone_Notifier.h"
+#include "ctrl/bone/bone_GeoBuilder.h"
+#include "bench/SyntheticRig.h"
+
+using namespace core;
+
+namespace bench
+{
+
+//-------------------------------------------------------------------------------------------------
+RigParam::RigParam()
+    : canvasSize(1024, 1024)
+    , layerCount(16)
+    , boneCount(8)
+    , poseKeyCount(4)
+    , ffdKeyCount(4)
+    , cellSize(8)
+    , frameCount(60)
+{
+}
+
+QJsonObject RigParam::toJson() const
+{
+    QJsonObject object;
+    object["width"] = canvasSize.width();
+    object["height"] = canvasSize.height();
+    object["layers"] = layerCount;
+    object["bones"] = boneCount;
+    object["pose_keys"] = poseKeyCount;
+    object["ffd_keys"] = ffdKeyCount;
+    object["cell_size"] = cellSize;
+    object["frames"] = frameCount;
+    return object;
+}
+
+//-------------------------------------------------------------------------------------------------
+QVector<QRect> SyntheticRig::layerRects(const RigParam& aParam)
+{
+    QVector<QRect> rects;
+    const int count = aParam.layerCount;
+    if (count <= 0) return rects;
+
+    // overlapped grid layout
+    const int cols = (int)std::ceil(std::sqrt((double)count));
+    const int rows = (count + cols - 1) / cols;
+    const QRect canvas(QPoint(), aParam.canvasSize);
+    const int cellW = aParam.canvasSize.width() / cols;
+    const int cellH = aParam.canvasSize.height() / rows;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const QPoint center((i % cols) * cellW + cellW / 2, (i / cols) * cellH + cellH / 2);
+        const QSize size(std::max(cellW * 3 / 2, 8), std::max(cellH * 3 / 2, 8));
+        QRect rect(center - QPoint(size.width() / 2, size.height() / 2), size);
+        rects.push_back(rect.intersected(canvas));
+    }
+    return rects;
+}
+
+SyntheticRig::SyntheticRig(const RigParam& aParam, const gl::DeviceInfo& aDeviceInfo)
+    : mParam(aParam)
+    , mDeviceInfo(aDeviceInfo)
+    , mAnimator()
+    , mProject()
+    , mBoneKey()
+    , mLog()
+{
+}
+
+SyntheticRig::~SyntheticRig()
+{
+    if (mProject)
+    {
+        // bind gl context for destructors
+        gl::Global::makeCurrent();
+        mProject.reset();
+    }
+}
+
+bool SyntheticRig::build(const QString& aPsdPath)
+{
+    gl::Global::makeCurrent();
+
+    core::Project::Attribute attribute;
+    attribute.setImageSize(mParam.canvasSize);
+    attribute.setMaxFrame(std::max(mParam.frameCount - 1, 1));
+
+    mProject.reset(new core::Project(QString(), mAnimator, nullptr));
+    mProject->attribute() = attribute;
+
+    SilentReporter reporter;
+    ctrl::ImageFileLoader loader(mDeviceInfo);
+    loader.setCanvasSize(mParam.canvasSize, true);
+    if (!loader.load(aPsdPath, *mProject, reporter))
+    {
+        mLog = loader.log();
+        return false;
+    }
+    mProject->attribute().setMaxFrame(attribute.maxFrame());
+
+    setCellSizes();
+    pushBones();
+    pushPoses();
+    pushFFDs();
+
+    // drop undo buffers
+    mProject->commandStack().clear();
+    return true;
+}
+
+int SyntheticRig::keyFrame(int aIndex, int aCount) const
+{
+    if (aCount <= 1) return 0;
+    return (aIndex * (mParam.frameCount - 1)) / (aCount - 1);
+}
+
+void SyntheticRig::setCellSizes()
+{
+    ObjectNode::Iterator itr(mProject->objectTree().topNode());
+    while (itr.hasNext())
+    {
+        auto node = itr.next();
+        if (node->type() != ObjectType_Layer || !node->timeLine()) continue;
+        ctrl::TimeLineUtil::assignImageKeyCellSize(
+                    *mProject, *node, TimeLine::kDefaultKeyIndex, mParam.cellSize);
+    }
+}
+
+void SyntheticRig::pushBones()
+{
+    if (mParam.boneCount < 2) return;
+
+    ObjectNode& topNode = *mProject->objectTree().topNode();
+    XC_PTR_ASSERT(topNode.timeLine());
+
+    const float w = mParam.canvasSize.width();
+    const float h = mParam.canvasSize.height();
+    const float range = 0.35f * h;
+
+    // a zigzag chain across the canvas
+    mBoneKey = new BoneKey();
+    Bone2* parent = nullptr;
+    for (int i = 0; i < mParam.boneCount; ++i)
+    {
+        const float rate = i / (float)(mParam.boneCount - 1);
+        const QVector2D pos(w * (0.05f + 0.9f * rate), h * ((i % 2) ? 0.55f : 0.45f));
+
+        Bone2* bone = new Bone2();
+        bone->setWorldPos(pos, parent);
+        bone->setRange(0, QVector2D(range, range));
+        bone->setRange(1, QVector2D(range, range));
+
+        if (parent)
+        {
+            parent->children().pushBack(bone);
+        }
+        else
+        {
+            mBoneKey->data().topBones().push_back(bone);
+        }
+        bone->updateWorldTransform();
+        parent = bone;
+    }
+
+    // push the key (the notifier writes influence maps)
+    {
+        cmnd::Stack& stack = mProject->commandStack();
+        cmnd::ScopedMacro macro(stack, "push synthetic bones");
+        macro.grabListener(new ctrl::bone::Notifier(
+                               *mProject, topNode, *mBoneKey, TimeLineEvent::Type_PushKey));
+        stack.push(new cmnd::GrabNewObject<BoneKey>(mBoneKey));
+        stack.push(topNode.timeLine()->createPusher(TimeKeyType_Bone, 0, mBoneKey));
+    }
+}
+
+void SyntheticRig::pushPoses()
+{
+    if (!mBoneKey) return;
+
+    ObjectNode& topNode = *mProject->objectTree().topNode();
+    for (int i = 0; i < mParam.poseKeyCount; ++i)
+    {
+        auto key = new PoseKey();
+        key->data().createBonesBy(*mBoneKey);
+
+        int index = 0;
+        for (auto top : key->data().topBones())
+        {
+            for (Bone2::Iterator itr(top); itr.hasNext(); ++index)
+            {
+                itr.next()->setRotate(((index + i) % 2 ? 0.2f : -0.2f));
+            }
+            top->updateWorldTransform();
+        }
+        ctrl::TimeLineUtil::pushNewPoseKey(
+                    *mProject, topNode, keyFrame(i, mParam.poseKeyCount), key, mBoneKey);
+    }
+}
+
+void SyntheticRig::pushFFDs()
+{
+    if (mParam.ffdKeyCount <= 0) return;
+
+    ObjectNode::Iterator itr(mProject->objectTree().topNode());
+    while (itr.hasNext())
+    {
+        auto node = itr.next();
+        if (node->type() != ObjectType_Layer || !node->timeLine()) continue;
+
+        auto imageKey = (ImageKey*)node->timeLine()->defaultKey(TimeKeyType_Image);
+        if (!imageKey) continue;
+
+        const LayerMesh& mesh = imageKey->data().gridMesh();
+        const int count = mesh.vertexCount();
+        if (count <= 0) continue;
+
+        for (int i = 0; i < mParam.ffdKeyCount; ++i)
+        {
+            auto key = new FFDKey();
+            key->data().allocAndWrite(mesh.positions(), count);
+
+            // waves
+            gl::Vector3* positions = key->data().positions();
+            const float phase = (float)i;
+            for (int k = 0; k < count; ++k)
+            {
+                positions[k].x += 4.0f * std::sin(0.05f * positions[k].y + phase);
+                positions[k].y += 4.0f * std::cos(0.05f * positions[k].x + phase);
+            }
+            ctrl::TimeLineUtil::pushNewFFDKey(
+                        *mProject, *node, keyFrame(i, mParam.ffdKeyCount), key, imageKey);
+        }
+    }
+}
+
+} // namespace bench
@@ -0,0 +1,92 @@
+#ifndef BENCH_SYNTHETICRIG_H
+#define BENCH_SYNTHETICRIG_H
+
+#include <QSize>
+#include <QRect>
+#include <QVector>
+#include <QString>
+#include <QJsonObject>
+#include <QScopedPointer>
+#include "util/NonCopyable.h"
+#include "util/IProgressReporter.h"
+#include "gl/DeviceInfo.h"
+#include "core/Animator.h"
+#include "core/Project.h"
+#include "core/BoneKey.h"
+
+namespace bench
+{
+
+class SilentReporter : public util::IProgressReporter
+{
+public:
+    virtual void setSection(const QString&) {}
+    virtual void setMaximum(int) {}
+    virtual void setProgress(int) {}
+    virtual bool wasCanceled() const { return false; }
+};
+
+class FixedAnimator : public core::Animator
+{
+public:
+    FixedAnimator() : mFrame(0) {}
+    void setFrame(int aFrame) { mFrame = aFrame; }
+    virtual core::Frame currentFrame() const { return core::Frame(mFrame); }
+    virtual void stop() {}
+    virtual void suspend() {}
+    virtual void resume() {}
+    virtual bool isSuspended() const { return false; }
+private:
+    int mFrame;
+};
+
+struct RigParam
+{
+    RigParam();
+    QJsonObject toJson() const;
+
+    QSize canvasSize;
+    int layerCount;
+    int boneCount;    ///< the number of joints of a bone chain on the top node
+    int poseKeyCount;
+    int ffdKeyCount;  ///< per layer
+    int cellSize;     ///< mesh density in pixels
+    int frameCount;
+};
+
+// a project which is built from a synthetic psd,
+// then it's rigged by a bone chain, pose keys and ffd keys.
+class SyntheticRig : private util::NonCopyable
+{
+public:
+    static QVector<QRect> layerRects(const RigParam& aParam);
+
+    SyntheticRig(const RigParam& aParam, const gl::DeviceInfo& aDeviceInfo);
+    ~SyntheticRig();
+
+    // the psd file should be created by SyntheticImage.
+    bool build(const QString& aPsdPath);
+
+    core::Project& project() { return *mProject; }
+    FixedAnimator& animator() { return mAnimator; }
+    core::BoneKey* boneKey() const { return mBoneKey; }
+    const QString& log() const { return mLog; }
+
+private:
+    void setCellSizes();
+    void pushBones();
+    void pushPoses();
+    void pushFFDs();
+    int keyFrame(int aIndex, int aCount) const;
+
+    RigParam mParam;
+    gl::DeviceInfo mDeviceInfo;
+    FixedAnimator mAnimator;
+    QScopedPointer<core::Project> mProject;
+    core::BoneKey* mBoneKey;
+    QString mLog;
+};
+
+} // namespace bench
+
+#endif // BENCH_SYNTHETICRIG_H
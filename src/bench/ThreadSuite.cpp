@@ -0,0 +1,96 @@
+#include <vector>
+#include <QThread>
+#include "XC.h"
+#include "thr/Paralleler.h"
+#include "bench/ThreadSuite.h"
+
+namespace
+{
+
+// a small job per layer
+qint64 sumRange(qint64 aBegin, qint64 aEnd)
+{
+    qint64 sum = 0;
+    for (qint64 i = aBegin; i < aEnd; ++i) sum += i;
+    return sum;
+}
+
+} // namespace
+
+namespace bench
+{
+
+ThreadSuite::ThreadSuite(Recorder& aRecorder, const RigParam& aParam)
+    : mRecorder(aRecorder)
+    , mParam(aParam)
+    , mLog()
+{
+}
+
+bool ThreadSuite::run()
+{
+    runContinuation();
+    return runDiscard();
+}
+
+void ThreadSuite::runContinuation()
+{
+    static const qint64 kJobSize = 1 << 16;
+    const int jobCount = mParam.layerCount;
+    const qint64 expected = 2 * sumRange(0, kJobSize * jobCount);
+
+    thr::Paralleler paralleler(QThread::idealThreadCount());
+    paralleler.start();
+
+    QJsonObject params;
+    params["jobs"] = jobCount;
+    params["threads"] = QThread::idealThreadCount();
+
+    // fan out, join by whenAll, then chain a continuation
+    mRecorder.measure("thr.Paralleler.whenAll.then", params, [&]()
+    {
+        std::vector<thr::Future<qint64>> jobs;
+        std::vector<thr::FutureBase> bases;
+        for (int i = 0; i < jobCount; ++i)
+        {
+            const qint64 begin = kJobSize * i;
+            jobs.push_back(paralleler.async([=]() { return sumRange(begin, begin + kJobSize); }));
+            bases.push_back(jobs.back());
+        }
+
+        auto sum = paralleler.after(thr::whenAll(bases), [=]()
+        {
+            qint64 total = 0;
+            for (auto& job : jobs) total += job.get();
+            return total;
+        });
+        auto doubled = paralleler.then(sum, [](const qint64& aSum) { return 2 * aSum; });
+
+        if (doubled.get() != expected)
+        {
+            XC_FATAL_ERROR("Bench Error", "A continuation returned a wrong result.", "");
+        }
+    });
+}
+
+bool ThreadSuite::runDiscard()
+{
+    thr::Future<qint64> job;
+    thr::Future<qint64> chained;
+    {
+        // never started, so every task is left in the queue
+        thr::Paralleler paralleler(1);
+        job = paralleler.async([]() { return sumRange(0, 3); });
+        chained = paralleler.then(job, [](const qint64& aValue) { return aValue + 1; });
+    }
+
+    // the promises of discarded tasks have to be fulfilled
+    if (!job.isReady() || !chained.isReady() || job.get() != 0 || chained.get() != 0)
+    {
+        mLog = "Discarded tasks left their futures unready.";
+        return false;
+    }
+    return true;
+}
+
+} // namespace bench
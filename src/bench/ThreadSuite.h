@@ -0,0 +1,29 @@
+#ifndef BENCH_THREADSUITE_H
+#define BENCH_THREADSUITE_H
+
+#include "bench/Recorder.h"
+#include "bench/SyntheticRig.h"
+
+namespace bench
+{
+
+// cases of the task parallelism. (futures, continuations and discarding)
+class ThreadSuite
+{
+public:
+    ThreadSuite(Recorder& aRecorder, const RigParam& aParam);
+    bool run();
+    const QString& log() const { return mLog; }
+
+private:
+    void runContinuation();
+    bool runDiscard();
+
+    Recorder& mRecorder;
+    RigParam mParam;
+    QString mLog;
+};
+
+} // namespace bench
+
+#endif // BENCH_THREADSUITE_H
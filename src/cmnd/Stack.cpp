@@ -12,8 +12,11 @@ Stack::Stack()
     , mSuspendCount(0)
     , mModifiable()
     , mEditingOrigin(0)
+    , mModificationCount(0)
+    , mIsOriginModified()
     , mIsEdited()
     , mOnEditStatusChanged()
+    , mOnCommandInvoking()
 {
 }
 
@@ -80,6 +83,11 @@ void Stack::pushImpl(Base* aCommand)
     XC_PTR_ASSERT(aCommand);
     if (!aCommand) return;
 
+    if (mOnCommandInvoking)
+    {
+        mOnCommandInvoking();
+    }
+
     // delete invalid branch
     while (mCurrent != mCommands.end())
     {
@@ -117,6 +125,11 @@ QString Stack::undo(bool* undone)
 
     if (!isSuspended())
     {
+        if (mOnCommandInvoking)
+        {
+            mOnCommandInvoking();
+        }
+
         mModifiable = NULL;
         while (mCurrent != mCommands.begin())
         {
@@ -148,6 +161,11 @@ QString Stack::redo(bool* redone)
 
     if (!isSuspended())
     {
+        if (mOnCommandInvoking)
+        {
+            mOnCommandInvoking();
+        }
+
         mModifiable = NULL;
         while (mCurrent != mCommands.end())
         {
@@ -185,13 +203,34 @@ void Stack::clear()
 
 bool Stack::isModifiable(const Base* aBase) const
 {
-    if (!mModifiable) return false;
-    return mModifiable == aBase;
+    return mModifiable && mModifiable == aBase;
+}
+
+void Stack::markModified()
+{
+    XC_PTR_ASSERT(mModifiable);
+    ++mModificationCount;
+
+    // the command at the origin is modified, undoing never restores the origin
+    if (mEditingOrigin == 0)
+    {
+        mIsOriginModified = true;
+        updateEditStatus();
+    }
 }
 
 void Stack::resetEditingOrigin()
 {
     mEditingOrigin = 0;
+    mIsOriginModified = false;
+    updateEditStatus();
+}
+
+void Stack::resetEditingOrigin(int aPrevOrigin, int aPrevModificationCount)
+{
+    mEditingOrigin -= aPrevOrigin;
+    // the modifiable command might be the one at the previous origin
+    mIsOriginModified = (mModificationCount != aPrevModificationCount);
     updateEditStatus();
 }
 
@@ -205,9 +244,14 @@ void Stack::setOnEditStatusChanged(const std::function<void(bool)>& aFunction)
     mOnEditStatusChanged = aFunction;
 }
 
+void Stack::setOnCommandInvoking(const std::function<void()>& aFunction)
+{
+    mOnCommandInvoking = aFunction;
+}
+
 void Stack::updateEditStatus()
 {
-    const bool isEdited = (mEditingOrigin != 0);
+    const bool isEdited = (mEditingOrigin != 0 || mIsOriginModified);
 
     if (mIsEdited != isEdited)
     {
@@ -31,10 +31,19 @@ public:
     void clear();
 
     bool isModifiable(const Base* aBase) const;
+    // call it before modifying the modifiable command, so it's counted as an edit
+    void markModified();
 
     void resetEditingOrigin();
     bool isEdited() const;
+
+    // an origin which was got before some edits can be restored later
+    int editingOrigin() const { return mEditingOrigin; }
+    int modificationCount() const { return mModificationCount; }
+    void resetEditingOrigin(int aPrevOrigin, int aPrevModificationCount);
     void setOnEditStatusChanged(const std::function<void(bool)>&);
+    // called before any command is executed, undone or redone
+    void setOnCommandInvoking(const std::function<void()>&);
 
 private:
     class Macro : public Base
@@ -79,8 +88,11 @@ private:
     int mSuspendCount;
     Base* mModifiable;
     int mEditingOrigin;
+    int mModificationCount;
+    bool mIsOriginModified;
     bool mIsEdited;
     std::function<void(bool)> mOnEditStatusChanged;
+    std::function<void()> mOnCommandInvoking;
 };
 
 } // namespace cmnd
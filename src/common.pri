@@ -18,7 +18,7 @@ DEFINES += "AE_MINOR_VERSION=3"
 DEFINES += "AE_MICRO_VERSION=4"
 
 DEFINES += "AE_PROJECT_FORMAT_MAJOR_VERSION=0"
-DEFINES += "AE_PROJECT_FORMAT_MINOR_VERSION=5"
+DEFINES += "AE_PROJECT_FORMAT_MINOR_VERSION=6"
 
 DEFINES += "AE_PROJECT_FORMAT_OLDEST_MAJOR_VERSION=0"
 DEFINES += "AE_PROJECT_FORMAT_OLDEST_MINOR_VERSION=4"
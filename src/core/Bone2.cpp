@@ -41,6 +41,19 @@ Bone2::~Bone2()
     qDeleteAll(children().begin(), children().end());
 }
 
+void Bone2::copyValues(const Bone2& aRhs)
+{
+    mOrigin = aRhs.mOrigin;
+    mLocalPos = aRhs.mLocalPos;
+    mLocalAngle = aRhs.mLocalAngle;
+    mRange = aRhs.mRange;
+    mShape = aRhs.mShape;
+    mBindingNodes = aRhs.mBindingNodes;
+    mWorldPos = aRhs.mWorldPos;
+    mWorldAngle = aRhs.mWorldAngle;
+    mRotate = aRhs.mRotate;
+}
+
 void Bone2::setWorldPos(const QVector2D& aWorldPos, const Bone2* aParent)
 {
     XC_ASSERT(!mOrigin);
@@ -45,6 +45,9 @@ public:
     // shadow bone
     Bone2* createShadow() const;
 
+    // copy all values except the tree structure and the focus links
+    void copyValues(const Bone2& aRhs);
+
     // transform
     void setRotate(float aRotate);
     float rotate() const;
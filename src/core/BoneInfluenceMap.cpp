@@ -1,4 +1,5 @@
 #include <float.h>
+#include <algorithm>
 #include <QtMath>
 #include "XC.h"
 #include "core/Constant.h"
@@ -7,6 +8,28 @@
 #include "core/BoneInfluenceMap.h"
 //#include <QElapsedTimer>
 
+namespace
+{
+
+// inclusive overlapping, same as the bounding check of BoneShape::influence
+bool overlaps(const QRectF& aLhs, const QRectF& aRhs)
+{
+    return !(aLhs.right() < aRhs.left() || aRhs.right() < aLhs.left() ||
+             aLhs.bottom() < aRhs.top() || aRhs.bottom() < aLhs.top());
+}
+
+bool isSameVertices(const QVector<QVector2D>& aLhs, const QVector<QVector2D>& aRhs)
+{
+    if (aLhs.size() != aRhs.size()) return false;
+    for (int i = 0; i < aLhs.size(); ++i)
+    {
+        if (aLhs[i].x() != aRhs[i].x() || aLhs[i].y() != aRhs[i].y()) return false;
+    }
+    return true;
+}
+
+}
+
 namespace core
 {
 
@@ -16,6 +39,11 @@ BoneInfluenceMap::BoneInfluenceMap()
     , mMaxBoneCount(0)
     , mGroupMtx()
     , mBoneList()
+    , mSourceVertices()
+    , mIsPartial(false)
+    , mDirtyRect()
+    , mDirtyVertices()
+    , mBuilt()
     , mWorks()
     , mBuildTask()
 {
@@ -38,6 +66,7 @@ void BoneInfluenceMap::allocate(int aVertexCount, bool aInitialize)
     // reallocate
     if (mVertexCount != aVertexCount)
     {
+        mBuilt.isValid = false;
         mWorks.reset();
 
         for (int t = 0; t < 2; ++t)
@@ -65,6 +94,7 @@ void BoneInfluenceMap::allocate(int aVertexCount, bool aInitialize)
     // initialize
     if (aInitialize)
     {
+        mBuilt.isValid = false;
         for (int t = 0; t < 2; ++t)
         {
             IndicesType* indices = mIndices[t].data();
@@ -101,6 +131,26 @@ void BoneInfluenceMap::writeAsync(
         mBuildTask->cancel();
     }
 
+    // make bone list
+    makeBoneList(aTopBones);
+
+    // source vertices
+    const gl::Vector3* positions = aMesh.positions();
+    mSourceVertices.resize(mVertexCount);
+    for (int i = 0; i < mVertexCount; ++i)
+    {
+        mSourceVertices[i] = positions[i].pos2D();
+    }
+
+    // find the region which is affected by modified bones
+    mDirtyRect = QRectF();
+    mIsPartial = getDirtyRect(aGroupMtx, mDirtyRect);
+    if (mIsPartial && mDirtyRect.isEmpty())
+    {
+        // nothing to do
+        return;
+    }
+
     // set group matrix
     mGroupMtx = aGroupMtx;
 
@@ -110,16 +160,12 @@ void BoneInfluenceMap::writeAsync(
     if (!mWorks) return;
 
     // initialize work buffer
-    const gl::Vector3* positions = aMesh.positions();
     for (int i = 0; i < mVertexCount; ++i)
     {
         mWorks[i].clear();
-        mWorks[i].vertex = positions[i].pos2D();
+        mWorks[i].vertex = mSourceVertices[i];
     }
 
-    // make bone list
-    makeBoneList(aTopBones);
-
 #ifdef UNUSE_PARALLEL
     build();
     (void)aProject;
@@ -130,6 +176,12 @@ void BoneInfluenceMap::writeAsync(
 #endif
 }
 
+void BoneInfluenceMap::invalidate()
+{
+    waitBuilding();
+    mBuilt.isValid = false;
+}
+
 BoneInfluenceMap::Accessor BoneInfluenceMap::accessor() const
 {
     waitBuilding();
@@ -168,21 +220,79 @@ void BoneInfluenceMap::makeBoneList(const QList<Bone2*>& aTopBones)
     }
 }
 
+bool BoneInfluenceMap::getDirtyRect(const QMatrix4x4& aGroupMtx, QRectF& aDirtyRect) const
+{
+    // the last writing has to be finished with same vertices
+    if (!mBuilt.isValid) return false;
+    if (!(mBuilt.groupMtx == aGroupMtx)) return false;
+    if (!isSameVertices(mBuilt.vertices, mSourceVertices)) return false;
+
+    // the bone indices have to be same
+    const QVector<BoneParam>& prevs = mBuilt.boneList.params;
+    const QVector<BoneParam>& nexts = mBoneList.params;
+    if (prevs.size() != nexts.size()) return false;
+
+    // union of the old and new bounds of modified bones
+    for (int i = 0; i < nexts.size(); ++i)
+    {
+        const BoneParam& prev = prevs[i];
+        const BoneParam& next = nexts[i];
+        const bool prevAffects = prev.hasParent && prev.hasRange;
+        const bool nextAffects = next.hasParent && next.hasRange;
+
+        if (prevAffects == nextAffects &&
+                (!nextAffects || prev.shape.hasSameInfluence(next.shape)))
+        {
+            continue;
+        }
+
+        if (prevAffects) aDirtyRect = aDirtyRect.united(prev.shape.influenceBounds());
+        if (nextAffects) aDirtyRect = aDirtyRect.united(next.shape.influenceBounds());
+    }
+    return true;
+}
+
 void BoneInfluenceMap::build()
 {
+    // the outputs are inconsistent until the end of writing
+    mBuilt.isValid = false;
+
     // world matrix * vertices
     transformVertices();
     if (isBuildCanceled()) return;
 
-    // write bone weight
-    writeWeights();
-    if (isBuildCanceled()) return;
+    if (mIsPartial)
+    {
+        // write bone weight around modified bones
+        writePartialWeights();
+        if (isBuildCanceled()) return;
 
-    // write vertex attribute
-    writeVertexAttribute();
-    if (isBuildCanceled()) return;
+        // write vertex attribute
+        for (int i : mDirtyVertices)
+        {
+            writeVertexAttribute(i);
+        }
+        if (isBuildCanceled()) return;
+    }
+    else
+    {
+        // write bone weight
+        writeWeights();
+        if (isBuildCanceled()) return;
+
+        // write vertex attribute
+        writeVertexAttribute();
+        if (isBuildCanceled()) return;
+    }
+
+    // keep the state for the next partial writing
+    mBuilt.groupMtx = mGroupMtx;
+    mBuilt.vertices = mSourceVertices;
+    mBuilt.boneList = mBoneList;
+    mBuilt.isValid = true;
 
     // free work buffer
+    mDirtyVertices.clear();
     mWorks.reset();
 }
 
@@ -218,69 +328,108 @@ void BoneInfluenceMap::writeWeights()
     }
 }
 
+void BoneInfluenceMap::writePartialWeights()
+{
+    // vertices in the dirty rect
+    mDirtyVertices.clear();
+    for (int k = 0; k < mVertexCount; ++k)
+    {
+        if (mDirtyRect.contains(mWorks[k].vertex.toPointF()))
+        {
+            mDirtyVertices.push_back(k);
+        }
+    }
+
+    // each bone in the same order as writeWeights()
+    for (int i = 0; i < mBoneList.params.size(); ++i)
+    {
+        const BoneParam& param = mBoneList.params[i];
+        if (!param.hasParent || !param.hasRange) continue;
+        if (!overlaps(param.shape.influenceBounds(), mDirtyRect)) continue;
+
+        // calculate weights
+        for (int k : mDirtyVertices)
+        {
+            const float weight = param.shape.influence(mWorks[k].vertex);
+
+            if (weight >= FLT_EPSILON)
+            {
+                mWorks[k].tryPushBoneWeight(i, weight);
+            }
+        }
+
+        // check canceling
+        if (isBuildCanceled()) return;
+    }
+}
+
 void BoneInfluenceMap::writeVertexAttribute()
+{
+    // each vertex
+    for (int i = 0; i < mVertexCount; ++i)
+    {
+        writeVertexAttribute(i);
+    }
+}
+
+void BoneInfluenceMap::writeVertexAttribute(int aIndex)
 {
     static const float kMinPowerSum = 0.01f;
 
+    const int ixc = aIndex * kBonePerVtxMaxEach;
+    const WorkAttribute& work = mWorks[aIndex];
+
     // clear
     for (int t = 0; t < 2; ++t)
     {
-        IndicesType* indices = mIndices[t].data();
-        WeightsType* weights = mWeights[t].data();
-        const int count = mVertexCount * kBonePerVtxMaxEach;
-
-        for (int i = 0; i < count; ++i) { indices[i] = 0; }
-        for (int i = 0; i < count; ++i) { weights[i] = 0.0f; }
+        for (int k = 0; k < kBonePerVtxMaxEach; ++k)
+        {
+            mIndices[t][ixc + k] = 0;
+            mWeights[t][ixc + k] = 0.0f;
+        }
     }
 
-    // each vertex
-    for (int i = 0; i < mVertexCount; ++i)
+    if (work.count == 0)
     {
-        const int ixc = i * kBonePerVtxMaxEach;
-        const WorkAttribute& work = mWorks[i];
+        // no bone influence
+        mIndices[0][ixc] = 0;
+        mWeights[0][ixc] = 1.0f;
+    }
+    else if (work.count == 1)
+    {
+        // single bone influence
+        mIndices[0][ixc] = work.id[0];
+        mWeights[0][ixc] = 1.0f;
+    }
+    else
+    {
+        // some bones influence
 
-        if (work.count == 0)
+        float powerSum = 0.0f;
+        for (int k = 0; k < work.count; ++k)
         {
-            // no bone influence
-            mIndices[0][ixc] = 0;
-            mWeights[0][ixc] = 1.0f;
+            powerSum += work.weight[k];
         }
-        else if (work.count == 1)
+
+        float weightRate = 1.0f;
+        float weightAdd = 0.0f;
+
+        if (powerSum >= kMinPowerSum)
         {
-            // single bone influence
-            mIndices[0][ixc] = work.id[0];
-            mWeights[0][ixc] = 1.0f;
+            weightRate /= powerSum;
         }
         else
         {
-            // some bones influence
-
-            float powerSum = 0.0f;
-            for (int k = 0; k < work.count; ++k)
-            {
-                powerSum += work.weight[k];
-            }
-
-            float weightRate = 1.0f;
-            float weightAdd = 0.0f;
-
-            if (powerSum >= kMinPowerSum)
-            {
-                weightRate /= powerSum;
-            }
-            else
-            {
-                weightAdd = (1.0f - powerSum) / work.count;
-            }
+            weightAdd = (1.0f - powerSum) / work.count;
+        }
 
-            for (int k = 0; k < work.count; ++k)
-            {
-                const int t = k / kBonePerVtxMaxEach;
-                const int each = ixc + k - t * kBonePerVtxMaxEach;
+        for (int k = 0; k < work.count; ++k)
+        {
+            const int t = k / kBonePerVtxMaxEach;
+            const int each = ixc + k - t * kBonePerVtxMaxEach;
 
-                mIndices[t][each] = work.id[k];
-                mWeights[t][each] = work.weight[k] * weightRate + weightAdd;
-            }
+            mIndices[t][each] = work.id[k];
+            mWeights[t][each] = work.weight[k] * weightRate + weightAdd;
         }
     }
 }
@@ -305,6 +454,22 @@ void BoneInfluenceMap::waitBuilding() const
 #endif
 }
 
+void BoneInfluenceMap::copyFrom(const BoneInfluenceMap& aRhs)
+{
+    aRhs.waitBuilding();
+
+    mMaxBoneCount = aRhs.mMaxBoneCount;
+    allocate(aRhs.mVertexCount, false);
+    mBuilt.isValid = false;
+
+    const int count = kBonePerVtxMaxEach * mVertexCount;
+    for (int t = 0; t < 2; ++t)
+    {
+        std::copy(aRhs.mIndices[t].data(), aRhs.mIndices[t].data() + count, mIndices[t].data());
+        std::copy(aRhs.mWeights[t].data(), aRhs.mWeights[t].data() + count, mWeights[t].data());
+    }
+}
+
 bool BoneInfluenceMap::serialize(Serializer& aOut) const
 {
     waitBuilding();
@@ -328,6 +493,7 @@ bool BoneInfluenceMap::serialize(Serializer& aOut) const
 bool BoneInfluenceMap::deserialize(Deserializer& aIn)
 {
     waitBuilding();
+    mBuilt.isValid = false;
 
     // vertex count
     {
@@ -337,8 +503,12 @@ bool BoneInfluenceMap::deserialize(Deserializer& aIn)
         // reallocate
         allocate(vertexCount, false);
     }
-    // max bone count
-    aIn.read(mMaxBoneCount);
+    // max bone count. (old files have a smaller limit)
+    {
+        int maxBoneCount = 0;
+        aIn.read(maxBoneCount);
+        mMaxBoneCount = std::max(mMaxBoneCount, maxBoneCount);
+    }
 
     const int count = kBonePerVtxMaxEach * mVertexCount;
     // indices
@@ -359,6 +529,15 @@ BoneInfluenceMap::BoneParam::BoneParam()
 {
 }
 
+//-------------------------------------------------------------------------------------------------
+BoneInfluenceMap::BuiltState::BuiltState()
+    : isValid(false)
+    , groupMtx()
+    , vertices()
+    , boneList()
+{
+}
+
 //-------------------------------------------------------------------------------------------------
 void BoneInfluenceMap::WorkAttribute::clear()
 {
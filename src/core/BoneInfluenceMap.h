@@ -50,12 +50,19 @@ public:
     void allocate(int aVertexCount, bool aInitialize = true);
     int vertexCount() const { return mVertexCount; }
 
+    // rewrite only the vertices around modified bones if the last writing
+    // has been finished with the same mesh and the same skeleton structure.
     void writeAsync(
             Project& aProject, const QList<Bone2*>& aTopBones,
             const QMatrix4x4& aGroupMtx, const LayerMesh& aMesh);
+    // forget the last writing. the next writing rebuilds all vertices.
+    void invalidate();
 
     Accessor accessor() const;
 
+    // copy the influences of the last writing. (it waits for the writing)
+    void copyFrom(const BoneInfluenceMap& aRhs);
+
     bool serialize(Serializer& aOut) const;
     bool deserialize(Deserializer& aIn);
 
@@ -76,6 +83,17 @@ private:
         QVector<BoneParam> params;
     };
 
+    // the state of the last finished writing
+    class BuiltState
+    {
+    public:
+        BuiltState();
+        bool isValid;
+        QMatrix4x4 groupMtx;
+        QVector<QVector2D> vertices;
+        BoneList boneList;
+    };
+
     struct WorkAttribute
     {
         int id[kBonePerVtxMaxAll];
@@ -98,10 +116,13 @@ private:
     };
 
     void makeBoneList(const QList<Bone2*>& aTopBones);
+    bool getDirtyRect(const QMatrix4x4& aGroupMtx, QRectF& aDirtyRect) const;
     void build();
     void transformVertices();
     void writeWeights();
+    void writePartialWeights();
     void writeVertexAttribute();
+    void writeVertexAttribute(int aIndex);
     bool isBuildCanceled() const;
     void waitBuilding() const;
 
@@ -109,6 +130,11 @@ private:
     int mMaxBoneCount;
     QMatrix4x4 mGroupMtx;
     BoneList mBoneList;
+    QVector<QVector2D> mSourceVertices;
+    bool mIsPartial;
+    QRectF mDirtyRect;
+    QVector<int> mDirtyVertices;
+    BuiltState mBuilt;
     QScopedArrayPointer<IndicesType> mIndices[2];
     QScopedArrayPointer<WeightsType> mWeights[2];
     QScopedArrayPointer<WorkAttribute> mWorks;
@@ -1,6 +1,7 @@
 #include "util/TreeUtil.h"
 #include "util/MathUtil.h"
 #include "core/BoneKey.h"
+#include "core/PosePalette.h"
 #include "core/Project.h"
 #include "core/TimeKeyBlender.h"
 #include "core/ObjectNodeUtil.h"
@@ -88,8 +89,7 @@ BoneKey::Cache::Cache()
     , mInnerMtx()
     , mFrameSign()
 {
-    static const int kMaxBoneCount = 32;
-    mInfluence.setMaxBoneCount(kMaxBoneCount);
+    mInfluence.setMaxBoneCount(PosePalette::kMaxCount);
 }
 
 void BoneKey::Cache::setNode(ObjectNode& aNode)
@@ -97,6 +97,11 @@ void BoneKey::Cache::setNode(ObjectNode& aNode)
     mNode = aNode.pointee();
 }
 
+void BoneKey::Cache::setNode(const util::LifeLink::Pointee<ObjectNode>& aNode)
+{
+    mNode = aNode;
+}
+
 //-------------------------------------------------------------------------------------------------
 BoneKey::BindingCache::BindingCache()
     : node()
@@ -107,7 +112,8 @@ BoneKey::BindingCache::BindingCache()
 
 //-------------------------------------------------------------------------------------------------
 BoneKey::BoneKey()
-    : mData()
+    : mSnapshotLink()
+    , mData()
     , mCaches()
     , mCacheOwner()
     , mBindingCaches()
@@ -129,7 +135,7 @@ void BoneKey::updateCaches(Project& aProject, const QList<Cache*>& aTargets)
 
     if (!aTargets.isEmpty())
     {
-        QWriteLocker lock(&aProject.objectTree().timeCacheLock().working);
+        QMutexLocker lock(&aProject.objectTree().timeCacheEpoch().working);
 
         // update bone influence map
         for (auto cache : aTargets)
@@ -363,6 +369,29 @@ TimeKey* BoneKey::createClone()
     return newKey;
 }
 
+TimeKey* BoneKey::createSnapshot() const
+{
+    auto newKey = new BoneKey();
+    newKey->mData = this->mData;
+
+    // the nodes are only referred by addresses. they are linked to the
+    // snapshot's own link, so the living nodes never touch the copy.
+    auto& link = newKey->mSnapshotLink;
+
+    for (auto cache : mCaches)
+    {
+        auto newCache = new Cache();
+        newCache->setNode(link.pointee<ObjectNode>(cache->node()));
+        newCache->setInnerMatrix(cache->innerMatrix());
+        newCache->setFrameSign(cache->frameSign());
+        newCache->influence().copyFrom(cache->influence());
+        newKey->mCaches.push_back(newCache);
+    }
+    newKey->mCacheOwner = link.pointee<ObjectNode>(mCacheOwner.get());
+    newKey->mBindingCaches = mBindingCaches;
+    return newKey;
+}
+
 bool BoneKey::serialize(Serializer& aOut) const
 {
     // top bone count
@@ -42,6 +42,7 @@ public:
     public:
         Cache();
         void setNode(ObjectNode& aNode);
+        void setNode(const util::LifeLink::Pointee<ObjectNode>& aNode);
         ObjectNode* node() { return mNode.get(); }
         const ObjectNode* node() const { return mNode.get(); }
         BoneInfluenceMap& influence() { return mInfluence; }
@@ -83,6 +84,7 @@ public:
     virtual TimeKeyType type() const { return TimeKeyType_Bone; }
     virtual bool canHoldChild() const { return true; }
     virtual TimeKey* createClone(); ///@note a new key have to reset caches.
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
@@ -94,6 +96,7 @@ private:
     bool serializeBone(Serializer& aOut, const Bone2* aBone) const;
     bool deserializeBone(Deserializer& aIn, Bone2* aBone);
 
+    util::LifeLink mSnapshotLink; // links of the caches of a snapshot
     Data mData;
     CacheList mCaches;
     util::LinkPointer<ObjectNode> mCacheOwner;
@@ -8,6 +8,21 @@
 namespace
 {
 static const float kRangeMin = 0.1f;
+
+bool isSameVector(const QVector2D& aLhs, const QVector2D& aRhs)
+{
+    return aLhs.x() == aRhs.x() && aLhs.y() == aRhs.y();
+}
+
+bool isSamePolygon(const QPolygonF& aLhs, const QPolygonF& aRhs)
+{
+    if (aLhs.size() != aRhs.size()) return false;
+    for (int i = 0; i < aLhs.size(); ++i)
+    {
+        if (aLhs[i].x() != aRhs[i].x() || aLhs[i].y() != aRhs[i].y()) return false;
+    }
+    return true;
+}
 } // namespace
 
 namespace core
@@ -172,6 +187,27 @@ float BoneShape::influence(const QVector2D& aPos) const
     return 0.0f;
 }
 
+QRectF BoneShape::influenceBounds() const
+{
+    return mIsValid ? mBounding : QRectF();
+}
+
+bool BoneShape::hasSameInfluence(const BoneShape& aRhs) const
+{
+    if (mIsValid != aRhs.mIsValid) return false;
+    if (!mIsValid) return true;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (mRootBendRange.angle[i] != aRhs.mRootBendRange.angle[i]) return false;
+        if (mTailBendRange.angle[i] != aRhs.mTailBendRange.angle[i]) return false;
+        if (!isSameVector(mRadius[i], aRhs.mRadius[i])) return false;
+    }
+    return isSameVector(mSegment.start, aRhs.mSegment.start) &&
+            isSameVector(mSegment.dir, aRhs.mSegment.dir) &&
+            isSamePolygon(mPolygon, aRhs.mPolygon);
+}
+
 float BoneShape::getBoneEllipseWeight(
         const QVector2D& aCenter, const QVector2D& aVUnit,
         const QVector2D& aRadius, const QVector2D& aPoint) const
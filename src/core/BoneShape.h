@@ -34,6 +34,11 @@ public:
 
     float influence(const QVector2D& aPos) const;
 
+    // the influence is always zero out of this rect. (empty if invalid)
+    QRectF influenceBounds() const;
+    // whether two shapes give exactly the same influences
+    bool hasSameInfluence(const BoneShape& aRhs) const;
+
     // serialize
     bool serialize(Serializer& aOut) const;
     bool deserialize(Deserializer& aIn);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "XC.h"
 #include "util/MathUtil.h"
 #include "core/CameraInfo.h"
@@ -131,6 +132,28 @@ float CameraInfo::toWorldLength(float aValue) const
     return aValue / mScale;
 }
 
+QRectF CameraInfo::visibleWorldRect() const
+{
+    const float w = mScreenSize.width();
+    const float h = mScreenSize.height();
+    const std::array<QVector2D, 4> corners = {
+        toWorldPos(QVector2D(0.0f, 0.0f)),
+        toWorldPos(QVector2D(w, 0.0f)),
+        toWorldPos(QVector2D(0.0f, h)),
+        toWorldPos(QVector2D(w, h))};
+
+    QVector2D minPos = corners[0];
+    QVector2D maxPos = corners[0];
+    for (auto& corner : corners)
+    {
+        minPos.setX(std::min(minPos.x(), corner.x()));
+        minPos.setY(std::min(minPos.y(), corner.y()));
+        maxPos.setX(std::max(maxPos.x(), corner.x()));
+        maxPos.setY(std::max(maxPos.y(), corner.y()));
+    }
+    return QRectF(minPos.toPointF(), maxPos.toPointF());
+}
+
 std::array<QVector2D, 4> CameraInfo::toScreenQuadangle(const QRectF& aWorldRect) const
 {
     return std::array<QVector2D, 4>{
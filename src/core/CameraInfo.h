@@ -65,6 +65,9 @@ public:
 
     float toWorldLength(float aValue) const;
 
+    // a world rect which covers the whole screen
+    QRectF visibleWorldRect() const;
+
     QMatrix4x4 viewMatrix() const;
 
 private:
@@ -25,7 +25,7 @@ public:
     static int imageCellSizeMax() { return 30000; }
     static int imageCellSizeMin() { return 2; }
 
-    static int imageCellCountMax() { return 1000000; }
+    static int imageCellCountMax() { return 2000000; }
 };
 
 } // namespace core
@@ -28,6 +28,13 @@ TimeKey* DepthKey::createClone()
     return newKey;
 }
 
+TimeKey* DepthKey::createSnapshot() const
+{
+    auto newKey = new DepthKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool DepthKey::serialize(Serializer& aOut) const
 {
     aOut.write(mData.easing());
@@ -1,6 +1,8 @@
+#include <memory>
 #include "XC.h"
 #include "core/Deserializer.h"
 #include "util/PackBits.h"
+#include "util/ChannelUtil.h"
 
 namespace core
 {
@@ -43,6 +45,11 @@ void Deserializer::read(int& aValue)
     aValue = mIn.readSInt32();
 }
 
+void Deserializer::read(uint64& aValue)
+{
+    aValue = mIn.readUInt64();
+}
+
 void Deserializer::read(float& aValue)
 {
     aValue = mIn.readFloat32();
@@ -326,13 +333,9 @@ bool Deserializer::readImage(XCMemBlock& aValue)
     // allocate work buffer
     const size_t srcSize = util::PackBits::worstEncodedSize((size_t)w);
     const size_t wrkSize = (size_t)w;
-    QScopedPointer<uint8> src(new uint8[srcSize]);
-    QScopedPointer<uint8> wrk(new uint8[wrkSize]);
-    XCMemBlock wrkBlock(wrk.data(), wrkSize);
-    if (src.isNull()) return false;
-    if (wrk.isNull()) return false;
-
-    util::PackBits decoder;
+    std::unique_ptr<uint8[]> src(new uint8[srcSize]);
+    std::unique_ptr<uint8[]> wrk(new uint8[wrkSize * 4]);
+    uint8* planes[4] = { wrk.get(), wrk.get() + wrkSize, wrk.get() + wrkSize * 2, wrk.get() + wrkSize * 3 };
 
     uint8* dstp = dst.data();
 
@@ -344,20 +347,20 @@ bool Deserializer::readImage(XCMemBlock& aValue)
         {
             // line length
             const size_t linelen = (size_t)mIn.readUInt32();
+            if (linelen > srcSize) return false;
+
             // compressed bytes
-            mIn.readBuf(src.data(), linelen);
+            mIn.readBuf(src.get(), linelen);
 
             // decode
-            if (!decoder.decode(XCMemBlock(src.data(), linelen), wrkBlock))
+            if (!util::PackBits::decode(src.get(), linelen, planes[i], wrkSize))
             {
                 return false;
             }
-
-            // merge channel bytes
-            const uint8* wp = wrk.data();
-            const uint8* we = wp + wrkSize;
-            for (uint8* dp = dstp + i; wp < we; dp += 4, ++wp) *dp = *wp;
         }
+
+        // merge channel bytes
+        util::ChannelUtil::merge4(planes[0], planes[1], planes[2], planes[3], wrkSize, dstp);
         dstp += w * 4;
     }
 
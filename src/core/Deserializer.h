@@ -47,6 +47,7 @@ public:
 
     void read(bool& aValue);
     void read(int& aValue);
+    void read(uint64& aValue);
     void read(float& aValue);
     void read(QPoint& aValue);
     void read(QVector2D& aValue);
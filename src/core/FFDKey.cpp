@@ -112,6 +112,13 @@ TimeKey* FFDKey::createClone()
     return newKey;
 }
 
+TimeKey* FFDKey::createSnapshot() const
+{
+    auto newKey = new FFDKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool FFDKey::serialize(Serializer& aOut) const
 {
     // easing
@@ -168,37 +168,6 @@ void FolderNode::setClipped(bool aIsClipped)
     mIsClipped = aIsClipped;
 }
 
-bool FolderNode::serialize(Serializer& aOut) const
-{
-    static const std::array<uint8, 8> kSignature =
-        { 'F', 'o', 'l', 'd', 'e', 'r', 'N', 'd' };
-
-    // block begin
-    auto pos = aOut.beginBlock(kSignature);
-
-    // name
-    aOut.write(mName);
-    // visibility
-    aOut.write(mIsVisible);
-    // slim-down
-    aOut.write(mIsSlimmedDown);
-    // initial rect
-    aOut.write(mInitialRect);
-    // clipping
-    aOut.write(mIsClipped);
-
-    // timeline
-    if (!mTimeLine.serialize(aOut))
-    {
-        return false;
-    }
-
-    // block end
-    aOut.endBlock(pos);
-
-    return !aOut.failure();
-}
-
 bool FolderNode::deserialize(Deserializer& aIn)
 {
     // check block begin
@@ -45,7 +45,6 @@ public:
     virtual TimeLine* timeLine() { return &mTimeLine; }
     virtual const TimeLine* timeLine() const { return &mTimeLine; }
 
-    virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
     // from Renderer
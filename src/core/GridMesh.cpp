@@ -52,15 +52,15 @@ GridMesh::GridMesh(const GridMesh& aRhs)
     , mNormals(aRhs.mNormals)
     , mHexaConnections(aRhs.mHexaConnections)
     , mMeshBuffer()
-    , mIndexBuffer()
+    , mIndexBuffer(aRhs.mIndexBuffer)
 {
-    // initialize mesh buffer
-    getMeshBuffer();
+    // the arrays and the index buffer are shared until either is modified.
+    // the mesh buffer is allocated on the first drawing.
 }
 
 GridMesh& GridMesh::operator=(const GridMesh& aRhs)
 {
-    freeBuffers();
+    if (this == &aRhs) return *this;
 
     mSize = aRhs.mSize;
     mOriginOffset = aRhs.mOriginOffset;
@@ -75,11 +75,8 @@ GridMesh& GridMesh::operator=(const GridMesh& aRhs)
     mNormals = aRhs.mNormals;
     mHexaConnections = aRhs.mHexaConnections;
 
-    // reset index buffer
-    resetIndexBuffer();
-
-    // initialize mesh buffer
-    getMeshBuffer();
+    // share index buffer
+    mIndexBuffer = aRhs.mIndexBuffer;
 
     return *this;
 }
@@ -104,9 +101,7 @@ void GridMesh::swap(GridMesh& aRhs)
     mNormals.swap(aRhs.mNormals);
     mHexaConnections.swap(aRhs.mHexaConnections);
     mMeshBuffer.swap(aRhs.mMeshBuffer);
-
-    resetIndexBuffer();
-    aRhs.resetIndexBuffer();
+    mIndexBuffer.swap(aRhs.mIndexBuffer);
 }
 
 void GridMesh::freeBuffers()
@@ -124,11 +119,12 @@ void GridMesh::resetIndexBuffer()
 {
     if (mIndices && mIndexCount > 0)
     {
-        if (!mIndexBuffer)
+        // never overwrite the buffer which is shared with other meshes
+        if (!mIndexBuffer || mIndexBuffer.use_count() > 1)
         {
-            mIndexBuffer.reset(new gl::BufferObject(GL_ELEMENT_ARRAY_BUFFER));
+            mIndexBuffer = std::make_shared<gl::BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
         }
-        mIndexBuffer->resetData(mIndexCount, GL_STATIC_DRAW, mIndices.data());
+        mIndexBuffer->resetData(mIndexCount, GL_STATIC_DRAW, mIndices.constData());
     }
     else
     {
@@ -252,14 +248,20 @@ void GridMesh::createQuadMesh()
 
 void GridMesh::writeHeightMap(const HeightMap& aMap, const QVector2D& aMinPos)
 {
+    if (mVertexCount <= 0) return;
+
+    // detach the shared arrays at once
+    auto positions = mPositions.data();
+    auto normals = mNormals.data();
+
     for (int i = 0; i < mVertexCount; ++i)
     {
-        gl::Vector3 glpos = mPositions[i];
+        gl::Vector3 glpos = positions[i];
 
         // read height
         QVector3D c(glpos.x + aMinPos.x(), glpos.y + aMinPos.y(), 0.0f);
         c.setZ(aMap.readHeight(c.toVector2D()));
-        mPositions[i].z = c.z();
+        positions[i].z = c.z();
 
         // read around height
         QVector3D l(c.x() - 2.0f, c.y(), 0.0f);
@@ -283,7 +285,7 @@ void GridMesh::writeHeightMap(const HeightMap& aMap, const QVector2D& aMinPos)
         normal += QVector3D::crossProduct(d, r);
 
         normal.setZ(-normal.z());
-        mNormals[i].set((normal / 4).normalized());
+        normals[i].set((normal / 4).normalized());
     }
 }
 
@@ -291,7 +293,7 @@ gl::BufferObject& GridMesh::getIndexBuffer()
 {
     if (!mIndexBuffer)
     {
-        mIndexBuffer.reset(new gl::BufferObject(GL_ELEMENT_ARRAY_BUFFER));
+        mIndexBuffer = std::make_shared<gl::BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
     }
     return *mIndexBuffer;
 }
@@ -1,6 +1,7 @@
 #ifndef CORE_GRIDMESH_H
 #define CORE_GRIDMESH_H
 
+#include <memory>
 #include <QGL>
 #include <QSize>
 #include <QScopedArrayPointer>
@@ -125,7 +126,7 @@ private:
     util::ArrayBuffer<gl::Vector3> mNormals;
     util::ArrayBuffer<HexaConnection> mHexaConnections;
     QScopedPointer<MeshBuffer> mMeshBuffer;
-    QScopedPointer<gl::BufferObject> mIndexBuffer;
+    std::shared_ptr<gl::BufferObject> mIndexBuffer;
 };
 
 } // namespace core
@@ -68,6 +68,15 @@ TimeKey* ImageKey::createClone()
     return newKey;
 }
 
+TimeKey* ImageKey::createSnapshot() const
+{
+    auto newKey = new ImageKey();
+    // a snapshot is never drawn, so it has no texture and keeps no origin image
+    newKey->mData.resource().setOriginKeeping(false);
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 void ImageKey::setImage(const img::ResourceHandle& aResource, img::BlendMode aMode)
 {
     mData.setBlendMode(aMode);
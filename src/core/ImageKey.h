@@ -66,6 +66,7 @@ public:
     virtual TimeKeyType type() const { return TimeKeyType_Image; }
     virtual bool canHoldChild() const { return true; }
     virtual TimeKey* createClone();
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
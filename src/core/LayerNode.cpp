@@ -6,6 +6,7 @@
 #include "gl/Global.h"
 #include "gl/ExtendShader.h"
 #include "gl/Util.h"
+#include "gl/Profiler.h"
 #include "img/ResourceNode.h"
 #include "img/BlendMode.h"
 #include "core/LayerNode.h"
@@ -32,6 +33,7 @@ LayerNode::LayerNode(const QString& aName, ShaderHolder& aShaderHolder)
     , mIsClipped()
     , mMeshTransformer("./data/shader/MeshTransform.glslex")
     , mCurrentMesh()
+    , mIsCulled(false)
     , mClippees()
 {
 }
@@ -152,6 +154,7 @@ void LayerNode::setBlendMode(img::BlendMode aMode)
 void LayerNode::prerender(const RenderInfo& aInfo, const TimeCacheAccessor& aAccessor)
 {
     mCurrentMesh = nullptr;
+    mIsCulled = false;
 
     if (!mIsVisible) return;
 
@@ -161,7 +164,7 @@ void LayerNode::prerender(const RenderInfo& aInfo, const TimeCacheAccessor& aAcc
 
 void LayerNode::render(const RenderInfo& aInfo, const TimeCacheAccessor& aAccessor)
 {
-    if (!mIsVisible) return;
+    if (!mIsVisible || mIsCulled) return;
 
     if (aAccessor.get(mTimeLine).opa().isZero()) return;
 
@@ -214,6 +217,8 @@ void LayerNode::renderClipper(
     if (!mIsVisible || !aInfo.clippingFrame) return;
     if (!mCurrentMesh) return;
 
+    gl::ProfileScope profile("clipping", mName, true);
+
     gl::Global::Functions& ggl = gl::Global::functions();
     auto& shader = mShaderHolder.clipperShader(aInfo.clippingId != 0);
     auto& expans = aAccessor.get(mTimeLine);
@@ -315,7 +320,17 @@ void LayerNode::transformShape(
     }
     XC_ASSERT(positions);
 
+    // out of the view (clippees of the layer are also invisible)
+    const QRectF bounds = MeshTransformer::worldBoundingRect(
+                expans, mesh->originOffset(), positions, aInfo.nonPosed, useInfluence);
+    if (!bounds.isNull() && !bounds.intersects(aInfo.camera.visibleWorldRect()))
+    {
+        mIsCulled = true;
+        return;
+    }
+
     // transform
+    gl::ProfileScope profile("transform", mName, true);
     mMeshTransformer.callGL(
                 expans, mesh->getMeshBuffer(), mesh->originOffset(),
                 positions, aInfo.nonPosed, useInfluence);
@@ -328,6 +343,7 @@ void LayerNode::renderShape(
 {
     if (!mCurrentMesh) return;
 
+    gl::ProfileScope profile("draw", mName, true);
     gl::Global::Functions& ggl = gl::Global::functions();
     const bool isClippee = (aInfo.clippingFrame && aInfo.clippingId != 0);
 
@@ -350,6 +366,7 @@ void LayerNode::renderShape(
     auto destTextureId = aInfo.destTexturizer->texture().id();
     if (!aInfo.isGrid && blendMode != img::BlendMode_Normal)
     {
+        gl::ProfileScope destProfile("pipeline", "DestinationTexturizer", true);
         aInfo.destTexturizer->update(
                     aInfo.framebuffer, aInfo.dest, viewMatrix,
                     *mCurrentMesh, mMeshTransformer.positions());
@@ -363,7 +380,15 @@ void LayerNode::renderShape(
     {
         // blend func
         ggl.glEnable(GL_BLEND);
-        ggl.glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+        if (aInfo.isFlattening)
+        {
+            // keep premultiplied alpha to be composited later
+            ggl.glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        else
+        {
+            ggl.glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+        }
 
         ggl.glActiveTexture(GL_TEXTURE0);
         ggl.glBindTexture(GL_TEXTURE_2D, textureId);
@@ -449,36 +474,6 @@ cmnd::Vector LayerNode::createResourceUpdater(const ResourceEvent& aEvent)
     return result;
 }
 
-bool LayerNode::serialize(Serializer& aOut) const
-{
-    static const std::array<uint8, 8> kSignature =
-        { 'L', 'a', 'y', 'e', 'r', 'N', 'd', '_' };
-
-    // block begin
-    auto pos = aOut.beginBlock(kSignature);
-
-    // name
-    aOut.write(mName);
-    // visibility
-    aOut.write(mIsVisible);
-    // slim-down
-    aOut.write(mIsSlimmedDown);
-    // initial rect
-    aOut.write(mInitialRect);
-    // clipping
-    aOut.write(mIsClipped);
-    // timeline
-    if (!mTimeLine.serialize(aOut))
-    {
-        return false;
-    }
-
-    // block end
-    aOut.endBlock(pos);
-
-    return !aOut.failure();
-}
-
 bool LayerNode::deserialize(Deserializer& aIn)
 {
     // check block begin
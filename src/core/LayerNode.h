@@ -59,7 +59,6 @@ public:
 
     virtual cmnd::Vector createResourceUpdater(const ResourceEvent& aEvent);
 
-    virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
     // from Renderer
@@ -89,6 +88,7 @@ private:
 
     MeshTransformer mMeshTransformer;
     LayerMesh* mCurrentMesh;
+    bool mIsCulled;
     std::vector<Renderer::SortUnit> mClippees; // a cache for performance
 };
 
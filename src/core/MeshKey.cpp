@@ -1,8 +1,10 @@
 #include <float.h>
+#include <atomic>
 #include <QPolygonF>
 #include "XC.h"
 #include "util/CollDetect.h"
 #include "util/MathUtil.h"
+#include "util/ObjectPool.h"
 #include "cmnd/BasicCommands.h"
 #include "cmnd/Scalable.h"
 #include "core/Constant.h"
@@ -10,6 +12,13 @@
 #include "core/MeshKeyUtil.h"
 #include "core/FFDKey.h"
 
+namespace
+{
+
+std::atomic<uint32> sMeshRevision(0);
+
+} // namespace
+
 namespace core
 {
 
@@ -26,6 +35,7 @@ MeshVtx::MeshVtx(float aX, float aY)
     : x(aX)
     , y(aY)
     , mEdges()
+    , mIndex(-1)
 {
 }
 
@@ -42,6 +52,17 @@ MeshVtx::~MeshVtx()
     XC_ASSERT(!hasParent());
 }
 
+void* MeshVtx::operator new(size_t aSize)
+{
+    XC_ASSERT(aSize == sizeof(MeshVtx)); (void)aSize;
+    return util::ObjectPool<MeshVtx>::instance().allocate();
+}
+
+void MeshVtx::operator delete(void* aPtr)
+{
+    util::ObjectPool<MeshVtx>::instance().deallocate(aPtr);
+}
+
 void MeshVtx::link(MeshEdgeLinkNode& aEdge)
 {
     MeshEdgeLink current = mEdges;
@@ -98,6 +119,7 @@ int MeshVtx::connectionCount() const
 //-------------------------------------------------------------------------------------------------
 MeshEdge::MeshEdge()
     : mFaces()
+    , mIndex(-1)
 {
     for (int i = 0; i < 2; ++i)
     {
@@ -111,6 +133,17 @@ MeshEdge::~MeshEdge()
     clear();
 }
 
+void* MeshEdge::operator new(size_t aSize)
+{
+    XC_ASSERT(aSize == sizeof(MeshEdge)); (void)aSize;
+    return util::ObjectPool<MeshEdge>::instance().allocate();
+}
+
+void MeshEdge::operator delete(void* aPtr)
+{
+    util::ObjectPool<MeshEdge>::instance().deallocate(aPtr);
+}
+
 void MeshEdge::set(MeshVtx& aVp0, MeshVtx& aVp1)
 {
     clear();
@@ -204,6 +237,17 @@ MeshFace::~MeshFace()
     clear();
 }
 
+void* MeshFace::operator new(size_t aSize)
+{
+    XC_ASSERT(aSize == sizeof(MeshFace)); (void)aSize;
+    return util::ObjectPool<MeshFace>::instance().allocate();
+}
+
+void MeshFace::operator delete(void* aPtr)
+{
+    util::ObjectPool<MeshFace>::instance().deallocate(aPtr);
+}
+
 bool MeshFace::has(const MeshEdge& aEdge) const
 {
     for (int i = 0; i < 3; ++i)
@@ -431,7 +475,9 @@ MeshKey::Data::Data()
     , mMeshBuffer()
     , mIndexBuffer()
     , mOwner()
+    , mRevision()
 {
+    updateRevision();
 }
 
 MeshKey::Data::Data(const Data& aRhs)
@@ -443,19 +489,21 @@ MeshKey::Data::Data(const Data& aRhs)
     , mTexCoords(aRhs.mTexCoords)
     , mIndices(aRhs.mIndices)
     , mMeshBuffer()
-    , mIndexBuffer()
+    , mIndexBuffer(aRhs.mIndexBuffer)
     , mOwner(aRhs.mOwner)
+    , mRevision()
 {
+    updateRevision();
     // copy geo
     copyVerticesEdgesAndFaces(aRhs);
-    // initialize index buffer
-    resetIndexBuffer();
-    // initialize mesh buffer
-    getMeshBuffer();
+    // the attributes and the index buffer are shared until the geometry is modified.
+    // the mesh buffer is allocated on the first drawing.
 }
 
 MeshKey::Data& MeshKey::Data::operator=(const Data& aRhs)
 {
+    if (this == &aRhs) return *this;
+
     destroy();
 
     mOriginOffset = aRhs.mOriginOffset;
@@ -463,12 +511,11 @@ MeshKey::Data& MeshKey::Data::operator=(const Data& aRhs)
     mTexCoords = aRhs.mTexCoords;
     mIndices = aRhs.mIndices;
     mOwner = aRhs.mOwner;
+    updateRevision();
     // copy geo
     copyVerticesEdgesAndFaces(aRhs);
-    // initialize index buffer
-    resetIndexBuffer();
-    // initialize mesh buffer
-    getMeshBuffer();
+    // share index buffer
+    mIndexBuffer = aRhs.mIndexBuffer;
 
     return *this;
 }
@@ -480,40 +527,56 @@ MeshKey::Data::~Data()
 
 void MeshKey::Data::copyVerticesEdgesAndFaces(const Data& aRhs)
 {
+    // the elements of aRhs are looked up by their indices
     // vertices
-    QMap<MeshVtx*, MeshVtx*> vtxMap;
+    mVertices.reserve(aRhs.mVertices.count());
     {
         int i = 0;
         for (auto prevVtx : aRhs.mVertices)
         {
+            XC_ASSERT(prevVtx->index() == i);
             auto nextVtx = new MeshVtx(prevVtx->vec());
             nextVtx->setIndex(i);
             mVertices.push_back(nextVtx);
-            vtxMap[prevVtx] = nextVtx;
             ++i;
         }
     }
+
     // edges
-    QMap<MeshEdge*, MeshEdge*> edgeMap;
-    for (auto prevEdge : aRhs.mEdges)
+    mEdges.reserve(aRhs.mEdges.count());
     {
-        auto nextEdge = new MeshEdge();
-        nextEdge->rawInit(*vtxMap[prevEdge->vtx(0)], *vtxMap[prevEdge->vtx(1)]);
-        mEdges.push_back(nextEdge);
-        edgeMap[prevEdge] = nextEdge;
+        int i = 0;
+        for (auto prevEdge : aRhs.mEdges)
+        {
+            XC_ASSERT(prevEdge->index() == i);
+            auto nextEdge = new MeshEdge();
+            nextEdge->rawInit(
+                    *mVertices[prevEdge->vtx(0)->index()],
+                    *mVertices[prevEdge->vtx(1)->index()]);
+            nextEdge->setIndex(i);
+            mEdges.push_back(nextEdge);
+            ++i;
+        }
     }
+
     // faces
+    mFaces.reserve(aRhs.mFaces.count());
     for (auto prevFace : aRhs.mFaces)
     {
         auto nextFace = new MeshFace();
         nextFace->rawInit(
-                *edgeMap[prevFace->edge(0)],
-                *edgeMap[prevFace->edge(1)],
-                *edgeMap[prevFace->edge(2)]);
+                *mEdges[prevFace->edge(0)->index()],
+                *mEdges[prevFace->edge(1)->index()],
+                *mEdges[prevFace->edge(2)->index()]);
         mFaces.push_back(nextFace);
     }
 }
 
+void MeshKey::Data::updateRevision()
+{
+    mRevision = ++sMeshRevision;
+}
+
 void MeshKey::Data::destroy()
 {
     // kill from parents
@@ -530,7 +593,7 @@ gl::BufferObject& MeshKey::Data::getIndexBuffer()
 {
     if (!mIndexBuffer)
     {
-        mIndexBuffer.reset(new gl::BufferObject(GL_ELEMENT_ARRAY_BUFFER));
+        mIndexBuffer = std::make_shared<gl::BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
     }
     return *mIndexBuffer;
 }
@@ -604,6 +667,8 @@ void MeshKey::Data::updateVtxIndices()
 
 void MeshKey::Data::updateGLAttribute()
 {
+    updateRevision();
+
     int vtxCount = mVertices.count();
 
     // vertices
@@ -644,11 +709,12 @@ void MeshKey::Data::resetIndexBuffer()
 {
     if (mIndices.count() > 0)
     {
-        if (!mIndexBuffer)
+        // never overwrite the buffer which is shared with other keys
+        if (!mIndexBuffer || mIndexBuffer.use_count() > 1)
         {
-            mIndexBuffer.reset(new gl::BufferObject(GL_ELEMENT_ARRAY_BUFFER));
+            mIndexBuffer = std::make_shared<gl::BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
         }
-        mIndexBuffer->resetData(mIndices.count(), GL_STATIC_DRAW, mIndices.data());
+        mIndexBuffer->resetData(mIndices.count(), GL_STATIC_DRAW, mIndices.constData());
     }
     else
     {
@@ -656,43 +722,79 @@ void MeshKey::Data::resetIndexBuffer()
     }
 }
 
+void MeshKey::Data::getSerialData(SerialData& aDest) const
+{
+    XC_ASSERT(mPositions.count() == mVertices.count());
+
+    aDest.originOffset = mOriginOffset;
+    aDest.positions = mPositions;
+
+    // edges
+    aDest.edges.resize(mEdges.count() * 2);
+    {
+        int i = 0;
+        for (auto edge : mEdges)
+        {
+            aDest.edges[i    ] = edge->vtx(0)->index();
+            aDest.edges[i + 1] = edge->vtx(1)->index();
+            i += 2;
+        }
+    }
+
+    // faces
+    aDest.faces.resize(mFaces.count() * 3);
+    {
+        int i = 0;
+        for (auto face : mFaces)
+        {
+            aDest.faces[i    ] = face->edge(0)->index();
+            aDest.faces[i + 1] = face->edge(1)->index();
+            aDest.faces[i + 2] = face->edge(2)->index();
+            i += 3;
+        }
+    }
+}
+
 bool MeshKey::Data::serialize(Serializer& aOut) const
+{
+    SerialData data;
+    getSerialData(data);
+    return serialize(aOut, data);
+}
+
+bool MeshKey::Data::serialize(Serializer& aOut, const SerialData& aData)
 {
     // origin offset
-    aOut.write(mOriginOffset);
+    aOut.write(aData.originOffset);
 
     // vertex count
-    aOut.write((int)mVertices.count());
+    aOut.write((int)aData.positions.count());
 
     // vertices
-    for (auto vtx : mVertices)
+    for (auto& pos : aData.positions)
     {
-        aOut.write(vtx->vec());
+        aOut.write(QVector2D(pos.x, pos.y));
     }
 
     // edge count
-    aOut.write((int)mEdges.count());
+    const int edgeCount = aData.edges.count() / 2;
+    aOut.write(edgeCount);
 
     // edges
-    QMap<MeshEdge*, int> edgeMap;
-    int edgeIndex = 0;
-    for (auto edge : mEdges)
+    for (int i = 0; i < edgeCount; ++i)
     {
-        aOut.write((int)edge->vtx(0)->index());
-        aOut.write((int)edge->vtx(1)->index());
-        edgeMap[edge] = edgeIndex;
-        ++edgeIndex;
+        aOut.write(aData.edges[2 * i]);
+        aOut.write(aData.edges[2 * i + 1]);
     }
 
     // face count
-    aOut.write((int)mFaces.count());
+    const int faceCount = aData.faces.count() / 3;
+    aOut.write(faceCount);
 
     // faces
-    for (auto face : mFaces)
+    for (int i = 0; i < faceCount * 3; ++i)
     {
-        aOut.write(edgeMap[face->edge(0)]);
-        aOut.write(edgeMap[face->edge(1)]);
-        aOut.write(edgeMap[face->edge(2)]);
+        aOut.write(aData.faces[i]);
     }
 
     return aOut.checkStream();
@@ -711,14 +813,12 @@ bool MeshKey::Data::deserialize(Deserializer& aIn)
         return aIn.errored("invalid vertex count");
 
     // vertices
-    QMap<int, MeshVtx*> vtxMap;
     for (int i = 0; i < vtxCount; ++i)
     {
         auto vec = aIn.getRead<QVector2D>();
         auto vtx = new MeshVtx(vec);
         vtx->setIndex(i);
         mVertices.push_back(vtx);
-        vtxMap[i] = vtx;
     }
     // check failure
     if (aIn.failure())
@@ -730,7 +830,6 @@ bool MeshKey::Data::deserialize(Deserializer& aIn)
         return aIn.errored("invalid edge count");
 
     // edges
-    QMap<int, MeshEdge*> edgeMap;
     for (int i = 0; i < edgeCount; ++i)
     {
         auto v0 = aIn.getRead<int>();
@@ -743,9 +842,9 @@ bool MeshKey::Data::deserialize(Deserializer& aIn)
         }
 
         auto edge = new MeshEdge();
-        edge->rawInit(*vtxMap[v0], *vtxMap[v1]);
+        edge->rawInit(*mVertices[v0], *mVertices[v1]);
+        edge->setIndex(i);
         mEdges.push_back(edge);
-        edgeMap[i] = edge;
     }
     // check failure
     if (aIn.failure())
@@ -771,7 +870,7 @@ bool MeshKey::Data::deserialize(Deserializer& aIn)
         }
 
         auto face = new MeshFace();
-        face->rawInit(*edgeMap[e0], *edgeMap[e1], *edgeMap[e2]);
+        face->rawInit(*mEdges[e0], *mEdges[e1], *mEdges[e2]);
         mFaces.push_back(face);
     }
     // check failure
@@ -790,6 +889,7 @@ bool MeshKey::Data::deserialize(Deserializer& aIn)
 //-------------------------------------------------------------------------------------------------
 MeshKey::MeshKey()
     : mData()
+    , mSnapshot()
 {
     mData.mOwner = this;
 }
@@ -802,8 +902,23 @@ TimeKey* MeshKey::createClone()
     return newKey;
 }
 
+TimeKey* MeshKey::createSnapshot() const
+{
+    // a snapshot is only serialized, so the element graph isn't copied
+    auto data = new Data::SerialData();
+    mData.getSerialData(*data);
+
+    auto newKey = new MeshKey();
+    newKey->mSnapshot.reset(data);
+    return newKey;
+}
+
 bool MeshKey::serialize(Serializer& aOut) const
 {
+    if (mSnapshot)
+    {
+        return Data::serialize(aOut, *mSnapshot);
+    }
     return mData.serialize(aOut);
 }
 
@@ -1450,6 +1565,7 @@ void MeshKey::moveVtx(MeshVtx& aVtx, const QVector2D& aPos)
     auto index = aVtx.index();
     XC_ASSERT(index >= 0);
     mData.mPositions[index].set(aPos.toVector3D());
+    mData.updateRevision();
 }
 
 void MeshKey::updateVtxIndices()
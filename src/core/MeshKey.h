@@ -1,6 +1,7 @@
 #ifndef CORE_MESHKEY_H
 #define CORE_MESHKEY_H
 
+#include <memory>
 #include <vector>
 #include <array>
 #include <QList>
@@ -48,6 +49,8 @@ public:
     MeshVtx(float aX, float aY);
     ~MeshVtx();
     MeshVtx(const QVector2D& aPos);
+    static void* operator new(size_t aSize);
+    static void operator delete(void* aPtr);
     QVector2D vec() const { return QVector2D(x, y); }
     MeshEdgeLink edges() const { return mEdges; }
     void set(float aX, float aY) { x = aX; y = aY; }
@@ -73,6 +76,8 @@ class MeshEdge : private util::NonCopyable
 public:
     MeshEdge();
     ~MeshEdge();
+    static void* operator new(size_t aSize);
+    static void operator delete(void* aPtr);
 
     void set(MeshVtx& aVp0, MeshVtx& aVp1);
     void clear();
@@ -89,6 +94,8 @@ public:
     bool hasChildren() const { return mLink[0].child || mLink[1].child; }
     bool hasMultiParents() const;
     bool hasOtherParents(const QVector<MeshFace*>& aFaces) const;
+    void setIndex(int aIndex) { mIndex = aIndex; }
+    int index() const { return mIndex; }
 
     // for deserialize
     void rawInit(MeshVtx& aVp0, MeshVtx& aVp1);
@@ -102,6 +109,7 @@ private:
 
     MeshEdgeLinkNode mLink[2];
     MeshFaceLink mFaces;
+    int mIndex;
 
 };
 
@@ -111,6 +119,8 @@ class MeshFace : private util::NonCopyable
 public:
     MeshFace();
     ~MeshFace();
+    static void* operator new(size_t aSize);
+    static void operator delete(void* aPtr);
 
     void set(MeshEdge& aEp0, MeshEdge& aEp1, MeshEdge& aEp2);
     void clear();
@@ -160,6 +170,9 @@ public:
 
         void setOriginOffset(const QVector2D& aOffset) { mOriginOffset = aOffset; }
 
+        // changes when the geometry is modified. (unique among all meshes)
+        uint32 revision() const { return mRevision; }
+
         // from LayerMesh
         virtual GLenum primitiveMode() const { return GL_TRIANGLES; }
         virtual const gl::Vector3* positions() const { return mPositions.data(); }
@@ -180,11 +193,23 @@ public:
     private:
         friend class MeshKey;
 
+        // the values written by serialize, without the element graph
+        struct SerialData
+        {
+            QVector2D originOffset;
+            QVector<gl::Vector3> positions; // shared with the source
+            QVector<int> edges; // two vertex indices per edge
+            QVector<int> faces; // three edge indices per face
+        };
+
         void copyVerticesEdgesAndFaces(const Data& aRhs);
+        void updateRevision();
         void updateVtxIndices();
         void updateGLAttribute();
         void resetIndexBuffer();
+        void getSerialData(SerialData& aDest) const;
         bool serialize(Serializer& aOut) const;
+        static bool serialize(Serializer& aOut, const SerialData& aData);
         bool deserialize(Deserializer& aIn);
 
         QVector2D mOriginOffset;
@@ -195,8 +220,9 @@ public:
         QVector<gl::Vector2> mTexCoords;
         QVector<GLuint> mIndices;
         QScopedPointer<MeshBuffer> mMeshBuffer;
-        QScopedPointer<gl::BufferObject> mIndexBuffer;
+        std::shared_ptr<gl::BufferObject> mIndexBuffer;
         MeshKey* mOwner;
+        uint32 mRevision;
     };
 
     MeshKey();
@@ -223,6 +249,7 @@ public:
     virtual TimeKeyType type() const { return TimeKeyType_Mesh; }
     virtual bool canHoldChild() const { return true; }
     virtual TimeKey* createClone();
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
@@ -244,6 +271,7 @@ private:
             MeshEdge& aEdge1, const QVector2D& aPos1, cmnd::Vector& aCommands);
 
     Data mData;
+    QScopedPointer<const Data::SerialData> mSnapshot; // only for snapshots
 };
 
 } // namespace core
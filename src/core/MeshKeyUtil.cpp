@@ -60,6 +60,7 @@ void MeshKeyUtil::CreateEdge::exec()
 void MeshKeyUtil::CreateEdge::redo()
 {
     mNewEdge->set(*mVtxs[0], *mVtxs[1]);
+    mNewEdge->setIndex(mEdgeList.count());
     mEdgeList.push_back(mNewEdge.get());
     mNewEdge.done();
 }
@@ -172,6 +173,7 @@ void MeshKeyUtil::RemoveEdge::exec()
 void MeshKeyUtil::RemoveEdge::redo()
 {
     mEdgeList.removeAt(mIndex);
+    updateIndices();
     mDelEdge->clear();
     mDelEdge.done();
 }
@@ -180,9 +182,19 @@ void MeshKeyUtil::RemoveEdge::undo()
 {
     mDelEdge->set(*mPrevVtxs[0], *mPrevVtxs[1]);
     mEdgeList.insert(mIndex, mDelEdge.get());
+    updateIndices();
     mDelEdge.undone();
 }
 
+void MeshKeyUtil::RemoveEdge::updateIndices()
+{
+    // the edges before mIndex keep their indices
+    for (int i = mIndex; i < mEdgeList.count(); ++i)
+    {
+        mEdgeList[i]->setIndex(i);
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 MeshKeyUtil::RemoveVtx::RemoveVtx(MeshKey& aKey, QList<MeshVtx*>& aVtxList, MeshVtx& aDelVtx)
     : mKey(aKey)
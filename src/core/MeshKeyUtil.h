@@ -95,6 +95,8 @@ public:
         std::array<MeshVtx*, 2> mPrevVtxs;
         int mIndex;
 
+        void updateIndices();
+
     public:
         RemoveEdge(QList<MeshEdge*>& aEdgeList, MeshEdge& aDelEdge);
 
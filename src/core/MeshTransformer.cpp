@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "gl/Global.h"
 #include "gl/Util.h"
 #include "core/MeshTransformer.h"
@@ -35,6 +36,74 @@ MeshTransformer::~MeshTransformer()
     }
 }
 
+QRectF MeshTransformer::worldBoundingRect(
+        const TimeKeyExpans& aExpans,
+        const QVector2D& aOriginOffset,
+        util::ArrayBlock<const gl::Vector3> aPositions,
+        bool aNonPosed, bool aUseInfluence)
+{
+    const int vtxCount = aPositions.count();
+    if (vtxCount <= 0) return QRectF();
+
+    // skinned positions are known on gpu only
+    if (aUseInfluence && aExpans.bone().influenceMap() && !aNonPosed)
+    {
+        return QRectF();
+    }
+
+    // the same matrix as callGL
+    QMatrix4x4 matrix;
+    if (!aNonPosed && aExpans.bone().isAffectedByBinding())
+    {
+        QMatrix4x4 innerMatrix = aExpans.bone().innerMatrix();
+        innerMatrix.translate(aOriginOffset);
+        matrix = aExpans.bone().outerMatrix() * innerMatrix;
+    }
+    else
+    {
+        matrix = aExpans.srt().worldCSRTMatrix();
+        matrix.translate(aOriginOffset);
+    }
+
+    // local bounds
+    const gl::Vector3* positions = aPositions.array();
+    float minX = positions[0].x, maxX = positions[0].x;
+    float minY = positions[0].y, maxY = positions[0].y;
+    float minZ = positions[0].z, maxZ = positions[0].z;
+    for (int i = 1; i < vtxCount; ++i)
+    {
+        const gl::Vector3& pos = positions[i];
+        minX = std::min(minX, pos.x); maxX = std::max(maxX, pos.x);
+        minY = std::min(minY, pos.y); maxY = std::max(maxY, pos.y);
+        minZ = std::min(minZ, pos.z); maxZ = std::max(maxZ, pos.z);
+    }
+
+    // transform the corners
+    QPointF minPos;
+    QPointF maxPos;
+    for (int i = 0; i < 8; ++i)
+    {
+        const QVector3D corner(
+                    (i & 1) ? maxX : minX,
+                    (i & 2) ? maxY : minY,
+                    (i & 4) ? maxZ : minZ);
+        const QPointF pos = (matrix * corner).toPointF();
+        if (i == 0)
+        {
+            minPos = pos;
+            maxPos = pos;
+        }
+        else
+        {
+            minPos.setX(std::min(minPos.x(), pos.x()));
+            minPos.setY(std::min(minPos.y(), pos.y()));
+            maxPos.setX(std::max(maxPos.x(), pos.x()));
+            maxPos.setY(std::max(maxPos.y(), pos.y()));
+        }
+    }
+    return QRectF(minPos, maxPos);
+}
+
 void MeshTransformer::callGL(
         const TimeKeyExpans& aExpans,
         LayerMesh::MeshBuffer& aMeshBuffer,
@@ -100,21 +169,10 @@ void MeshTransformer::callGL(
             program.setAttributeArray("inBoneIndex1", inflData.indices1(), vtxCount);
             program.setAttributeArray("inBoneWeight1", inflData.weights1(), vtxCount);
 
-            if (useDualQuaternion)
-            {
-                auto palette = aNonPosed ? PosePalette().dualQuaternions() :
-                                           aExpans.posePalette().dualQuaternions();
-                program.setTupleUniformValueArray<GLfloat>(
-                            "uBoneDualQuat",
-                            palette.array()->data(),
-                            palette.count() * 2, 4);
-            }
-            else
-            {
-                auto palette = aNonPosed ? PosePalette().matrices() :
-                                           aExpans.posePalette().matrices();
-                program.setUniformValueArray("uBoneMatrix", palette);
-            }
+            // the palette buffer is shared by all layers of the skeleton
+            auto& palette = aExpans.sharedPosePalette().dualQuaternionBuffer();
+            ggl.glBindBufferBase(GL_UNIFORM_BUFFER,
+                                 MeshTransformerResource::kPaletteBinding, palette.id());
         }
 
         ggl.glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffer.workPositions.id());
@@ -148,6 +206,11 @@ void MeshTransformer::callGL(
         ggl.glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
     }
 
+    if (useInfluence)
+    {
+        ggl.glBindBufferBase(GL_UNIFORM_BUFFER, MeshTransformerResource::kPaletteBinding, 0);
+    }
+
     ggl.glFlush();
 
     XC_ASSERT(ggl.glGetError() == GL_NO_ERROR);
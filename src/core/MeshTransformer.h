@@ -2,6 +2,7 @@
 #define CORE_MESHTRANSFORMER_H
 
 #include <QScopedPointer>
+#include <QRectF>
 #include "util/NonCopyable.h"
 #include "util/ArrayBlock.h"
 #include "gl/Vector3.h"
@@ -26,6 +27,14 @@ public:
                 util::ArrayBlock<const gl::Vector3> aPositions,
                 bool aNonPosed = false, bool aUseInfluence = true);
 
+    // the bounds of the positions which callGL outputs.
+    // returns a null rect if they can't be known on cpu. (skinned meshes)
+    static QRectF worldBoundingRect(
+            const TimeKeyExpans& aExpans,
+            const QVector2D& aOriginOffset,
+            util::ArrayBlock<const gl::Vector3> aPositions,
+            bool aNonPosed = false, bool aUseInfluence = true);
+
     gl::BufferObject& positions() { return *mOutPositions; }
     const gl::BufferObject& positions() const { return *mOutPositions; }
 
@@ -90,6 +90,18 @@ void MeshTransformerResource::buildShader(
                        aProgram.log());
     }
 
+    // palette
+    if (aUseSkinning)
+    {
+        const GLuint index = ggl.glGetUniformBlockIndex(aProgram.id(), "BonePalette");
+        if (index == GL_INVALID_INDEX)
+        {
+            XC_FATAL_ERROR("OpenGL Error", "Failed to find the bone palette block.",
+                           aProgram.log());
+        }
+        ggl.glUniformBlockBinding(aProgram.id(), index, kPaletteBinding);
+    }
+
     XC_ASSERT(ggl.glGetError() == GL_NO_ERROR);
 }
 
@@ -9,6 +9,9 @@ namespace core
 class MeshTransformerResource
 {
 public:
+    // the uniform buffer binding of bone palettes
+    enum { kPaletteBinding = 0 };
+
     MeshTransformerResource();
     void setup(const QString& aShaderPath);
     gl::EasyShaderProgram& program(bool aUseSkinning, bool aUseDualQuaternion);
@@ -92,6 +92,13 @@ TimeKey* MoveKey::createClone()
     return newKey;
 }
 
+TimeKey* MoveKey::createSnapshot() const
+{
+    auto newKey = new MoveKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool MoveKey::serialize(Serializer& aOut) const
 {
     aOut.write(mData.easing());
@@ -68,7 +68,6 @@ public:
     virtual bool hasAnyMesh() const { return false; }
     virtual bool hasAnyImage() const { return false; }
 
-    virtual bool serialize(Serializer& aOut) const = 0;
     virtual bool deserialize(Deserializer& aIn) = 0;
 
     virtual cmnd::Vector createResourceUpdater(const ResourceEvent&) { return cmnd::Vector(); }
@@ -5,13 +5,17 @@
 #include "cmnd/Stable.h"
 #include "cmnd/Vector.h"
 #include "cmnd/BasicCommands.h"
+#include "gl/Profiler.h"
 #include "core/ObjectTree.h"
+#include "core/ObjectTreeSnapshot.h"
 #include "core/LayerNode.h"
 #include "core/FolderNode.h"
 #include "core/ObjectTreeEvent.h"
 #include "core/TimeCacheAccessor.h"
 #include "core/BoneKeyUpdater.h"
 #include "core/ImageKeyUpdater.h"
+#include "core/ImageKey.h"
+#include "core/StaticTreeCache.h"
 
 namespace core
 {
@@ -19,80 +23,445 @@ namespace core
 //-------------------------------------------------------------------------------------------------
 class SortAndRenderCall
 {
-    static bool compareDepth(Renderer::SortUnit a, Renderer::SortUnit b)
+    enum { kMaxStaticTreeCount = 8 };
+
+    // a node of the flattened tree (children are in reverse order)
+    struct FlatNode
+    {
+        ObjectNode* node;
+        Renderer* renderer;
+        int parent;
+        int next; // the index after the subtree
+        int slot; // the index of the static tree cache, or -1
+    };
+
+    struct SortUnit
+    {
+        Renderer* renderer;
+        const ObjectNode* node;
+        float depth;
+        int order;
+    };
+
+    // same as a stable sort by depth
+    static bool compareDepth(const SortUnit& a, const SortUnit& b)
     {
-        return a.depth < b.depth;
+        return a.depth < b.depth || (a.depth == b.depth && a.order < b.order);
     }
 
-    void pushNodeRecursive(ObjectNode* aNode, bool aPush)
+    // evaluated states are same on all frames
+    static bool isStaticTimeLine(const TimeLine& aTimeLine)
     {
-        if (!aNode || !aNode->isVisible()) return;
+        for (int i = 0; i < TimeKeyType_TERM; ++i)
+        {
+            const TimeKeyArray& keys = aTimeLine.keys((TimeKeyType)i);
+            if (keys.size() > 1 || (keys.size() == 1 && keys.frame(0) != 0))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool isClipper(const ObjectNode& aNode)
+    {
+        auto prev = aNode.prevSib();
+        return prev && prev->renderer() && prev->renderer()->isClipped();
+    }
+
+    // a folder which isn't a clipper renders nothing
+    static bool isPassive(const SortUnit& aUnit)
+    {
+        return aUnit.node->type() != ObjectType_Layer && !isClipper(*aUnit.node);
+    }
+
+    // a node which can be flattened with normal blending
+    static bool isFlattenable(const ObjectNode& aNode)
+    {
+        auto renderer = aNode.renderer();
+        if (!renderer) return true;
+        if (renderer->isClipped() || isClipper(aNode)) return false;
+
+        if (aNode.type() != ObjectType_Layer || !aNode.timeLine()) return true;
+        const TimeLine& timeLine = *aNode.timeLine();
+
+        auto defaultKey = (const ImageKey*)timeLine.defaultKey(TimeKeyType_Image);
+        if (defaultKey && defaultKey->data().blendMode() != img::BlendMode_Normal)
+        {
+            return false;
+        }
+        const TimeKeyArray& keys = timeLine.keys(TimeKeyType_Image);
+        for (int i = 0; i < keys.size(); ++i)
+        {
+            auto key = (const ImageKey*)keys.key(i);
+            if (key->data().blendMode() != img::BlendMode_Normal) return false;
+        }
+        return true;
+    }
+
+    void flattenRecursive(ObjectNode* aNode, int aParent)
+    {
+        if (!aNode) return;
+
+        const int index = (int)mNodes.size();
+        FlatNode flat = { aNode, aNode->renderer(), aParent, 0, -1 };
+        mNodes.push_back(flat);
+
+        auto& children = aNode->children();
+        for (auto itr = children.rbegin(); itr != children.rend(); ++itr)
+        {
+            flattenRecursive(*itr, index);
+        }
+        mNodes[index].next = (int)mNodes.size();
+    }
+
+    void updateNodes(ObjectNode* aTopNode)
+    {
+        if (!mIsDirty && mTopNode == aTopNode) return;
+
+        mNodes.clear();
+        flattenRecursive(aTopNode, -1);
+        mTopNode = aTopNode;
+        mIsDirty = false;
+        mIsStaticDirty = true;
+        mSorted.clear();
+        mOrders.clear();
+    }
+
+    // find outermost static folders
+    void updateStaticTrees()
+    {
+        if (!mIsStaticDirty) return;
+        mIsStaticDirty = false;
+
+        const int count = (int)mNodes.size();
+        std::vector<char> chainStatic(count, 0);
+        std::vector<char> subtreeOk(count, 0);
+        std::vector<int> layerCount(count, 0);
+
+        for (int i = 0; i < count; ++i)
+        {
+            const FlatNode& flat = mNodes[i];
+            const ObjectNode& node = *flat.node;
+            const bool isStatic = !node.timeLine() || isStaticTimeLine(*node.timeLine());
+
+            chainStatic[i] = isStatic && (flat.parent < 0 || chainStatic[flat.parent]);
+            subtreeOk[i] = isStatic && isFlattenable(node);
+            layerCount[i] = (node.type() == ObjectType_Layer) ? 1 : 0;
+        }
+        for (int i = count - 1; i > 0; --i)
+        {
+            const int parent = mNodes[i].parent;
+            subtreeOk[parent] = subtreeOk[parent] && subtreeOk[i];
+            layerCount[parent] += layerCount[i];
+        }
 
-        auto renderer = aNode->renderer();
-        if (renderer)
+        int slotCount = 0;
+        int i = 0;
+        while (i < count)
         {
-            if (aPush)
+            FlatNode& flat = mNodes[i];
+            flat.slot = -1;
+
+            if (slotCount < kMaxStaticTreeCount &&
+                    flat.node->type() == ObjectType_Folder &&
+                    chainStatic[i] && subtreeOk[i] && layerCount[i] >= 2)
             {
-                if (!renderer->isClipped())
+                for (int k = i; k < flat.next; ++k)
                 {
-                    Renderer::SortUnit unit;
-                    unit.renderer = renderer;
-                    unit.depth = mAccessor->get(*aNode).worldDepth();
-                    mArray.push_back(unit);
+                    mNodes[k].slot = slotCount;
                 }
-                else
+                ++slotCount;
+                i = flat.next;
+                continue;
+            }
+            ++i;
+        }
+
+        // the slots which hold the same nodes keep their textures
+        std::vector<std::vector<const ObjectNode*>> members(slotCount);
+        for (auto& flat : mNodes)
+        {
+            if (flat.slot >= 0) members[flat.slot].push_back(flat.node);
+        }
+        std::vector<int> prevSlots(slotCount, -1);
+        for (int s = 0; s < slotCount; ++s)
+        {
+            auto found = std::find(mSlotMembers.begin(), mSlotMembers.end(), members[s]);
+            if (found != mSlotMembers.end())
+            {
+                prevSlots[s] = (int)(found - mSlotMembers.begin());
+            }
+        }
+        mSlotMembers.swap(members);
+        mCache.rearrange(prevSlots);
+
+        // the slots of modified nodes, their descendants and their ancestors
+        if (mIsStaticContentDirty)
+        {
+            mCache.invalidate();
+        }
+        else
+        {
+            for (auto modified : mModifiedNodes)
+            {
+                for (int k = 0; k < count; ++k)
                 {
-                    aPush = false;
+                    if (mNodes[k].node != modified) continue;
+                    for (int m = k; m < mNodes[k].next; ++m)
+                    {
+                        if (mNodes[m].slot >= 0) mCache.invalidate(mNodes[m].slot);
+                    }
+                    break;
                 }
             }
         }
+        mModifiedNodes.clear();
+        mIsStaticContentDirty = false;
 
-        auto& children = aNode->children();
-        for (auto itr = children.rbegin(); itr != children.rend(); ++itr)
+        mSlotUsable.assign(slotCount, 0);
+    }
+
+    // visible and unclipped renderers. (flags can be changed without any event)
+    void gatherOrders(std::vector<int>& aDest) const
+    {
+        aDest.clear();
+        const int count = (int)mNodes.size();
+        int i = 0;
+        while (i < count)
         {
-            pushNodeRecursive(*itr, aPush);
+            const FlatNode& flat = mNodes[i];
+            if (!flat.node->isVisible() || (flat.renderer && flat.renderer->isClipped()))
+            {
+                i = flat.next;
+                continue;
+            }
+            if (flat.renderer)
+            {
+                aDest.push_back(i);
+            }
+            ++i;
         }
     }
 
-    std::vector<Renderer::SortUnit> mArray;
-    const TimeCacheAccessor* mAccessor;
+    void sortUnits(const TimeCacheAccessor& aAccessor)
+    {
+        gatherOrders(mWorkOrders);
+
+        if (mWorkOrders != mOrders)
+        {
+            // the members are changed
+            mOrders.swap(mWorkOrders);
+            mSorted.clear();
+            mSorted.reserve(mOrders.size());
+            for (auto order : mOrders)
+            {
+                const FlatNode& flat = mNodes[order];
+                SortUnit unit = { flat.renderer, flat.node, 0.0f, order };
+                mSorted.push_back(unit);
+            }
+            mCache.invalidate();
+        }
+
+        // refresh depths in the previous order
+        for (auto& unit : mSorted)
+        {
+            unit.depth = aAccessor.get(*unit.node).worldDepth();
+        }
+
+        // sort only when any depth has been changed
+        if (!std::is_sorted(mSorted.begin(), mSorted.end(), compareDepth))
+        {
+            std::sort(mSorted.begin(), mSorted.end(), compareDepth);
+        }
+    }
+
+    // the layers of a usable slot are contiguous in the sorted units
+    void updateUsableSlots()
+    {
+        const int slotCount = mCache.slotCount();
+        std::vector<char> seen(slotCount, 0);
+        mSlotUsable.assign(slotCount, 1);
+
+        int current = -1;
+        for (auto& unit : mSorted)
+        {
+            if (isPassive(unit)) continue;
+            const int slot = mNodes[unit.order].slot;
+
+            if (slot != current)
+            {
+                if (slot >= 0)
+                {
+                    if (seen[slot]) mSlotUsable[slot] = 0;
+                    seen[slot] = 1;
+                }
+                current = slot;
+            }
+        }
+        for (int i = 0; i < slotCount; ++i)
+        {
+            mSlotUsable[i] = mSlotUsable[i] && seen[i];
+        }
+    }
+
+    bool isCachedNode(const FlatNode& aFlat, const CameraInfo& aCamera) const
+    {
+        return aFlat.slot >= 0 && mSlotUsable[aFlat.slot] &&
+                mCache.isValid(aFlat.slot, aCamera);
+    }
+
+    void renderSlot(int aSlot, size_t aBegin, size_t aEnd,
+                    const RenderInfo& aInfo,
+                    const TimeCacheAccessor& aAccessor)
+    {
+        if (!mCache.isValid(aSlot, aInfo.camera))
+        {
+            gl::ProfileScope profile("pipeline", "flatten", true);
+            RenderInfo info = aInfo;
+            info.framebuffer = mCache.beginCapture(aSlot, aInfo.camera);
+            info.dest = mCache.texture(aSlot);
+            info.isFlattening = true;
+
+            for (size_t i = aBegin; i < aEnd; ++i)
+            {
+                const SortUnit& unit = mSorted[i];
+                if (mNodes[unit.order].slot != aSlot) continue;
+                unit.renderer->render(info, aAccessor);
+            }
+            mCache.endCapture(aSlot, aInfo.framebuffer);
+        }
+        mCache.composite(aSlot);
+    }
+
+    std::vector<FlatNode> mNodes;
+    std::vector<SortUnit> mSorted;
+    std::vector<int> mOrders;
+    std::vector<int> mWorkOrders;
+    std::vector<char> mSlotUsable;
+    std::vector<std::vector<const ObjectNode*>> mSlotMembers;
+    std::vector<const ObjectNode*> mModifiedNodes;
+    const ObjectNode* mTopNode;
+    bool mIsDirty;
+    bool mIsStaticDirty;
+    bool mIsStaticContentDirty;
+    StaticTreeCache mCache;
 
 public:
 
     SortAndRenderCall()
-        : mArray()
-        , mAccessor()
+        : mNodes()
+        , mSorted()
+        , mOrders()
+        , mWorkOrders()
+        , mSlotUsable()
+        , mSlotMembers()
+        , mModifiedNodes()
+        , mTopNode()
+        , mIsDirty(true)
+        , mIsStaticDirty(true)
+        , mIsStaticContentDirty(false)
+        , mCache()
+    {
+    }
+
+    void invalidate()
+    {
+        mIsDirty = true;
+    }
+
+    // any node can be changed
+    void invalidateStaticTrees()
     {
+        mIsStaticDirty = true;
+        mIsStaticContentDirty = true;
+    }
+
+    // only the node and its subtree are changed
+    void invalidateStaticTree(const ObjectNode& aNode)
+    {
+        mIsStaticDirty = true;
+        if (mIsStaticContentDirty) return;
+
+        if (mModifiedNodes.size() >= mNodes.size())
+        {
+            mModifiedNodes.clear();
+            mIsStaticContentDirty = true;
+            return;
+        }
+        if (std::find(mModifiedNodes.begin(), mModifiedNodes.end(), &aNode) == mModifiedNodes.end())
+        {
+            mModifiedNodes.push_back(&aNode);
+        }
     }
 
     void invoke(ObjectNode* aTopNode,
                 const RenderInfo& aInfo,
                 const TimeCacheAccessor& aAccessor)
     {
-        mAccessor = &aAccessor;
+        updateNodes(aTopNode);
+
+        const bool useCache = aInfo.cachesStaticTree &&
+                !aInfo.isGrid && !aInfo.nonPosed && !aInfo.originMesh;
+        if (useCache)
+        {
+            updateStaticTrees();
+        }
+
+        // sort
+        {
+            gl::ProfileScope profile("pipeline", "sort");
+            sortUnits(aAccessor);
+
+            if (useCache)
+            {
+                updateUsableSlots();
+            }
+            else
+            {
+                mSlotUsable.assign(mSlotUsable.size(), 0);
+            }
+        }
 
-        // prerender
+        // prerender (layers out of the view or in a valid cache skip skinning)
         {
-            ObjectNode::Iterator itr(aTopNode);
-            while (itr.hasNext())
+            gl::ProfileScope profile("pipeline", "prerender", true);
+            for (auto& flat : mNodes)
             {
-                auto renderer = itr.next()->renderer();
-                if (renderer)
+                if (flat.renderer && !isCachedNode(flat, aInfo.camera))
                 {
-                    renderer->prerender(aInfo, aAccessor);
+                    flat.renderer->prerender(aInfo, aAccessor);
                 }
             }
         }
 
-        // sort
-        mArray.clear();
-        pushNodeRecursive(aTopNode, true);
-        std::stable_sort(mArray.begin(), mArray.end(), compareDepth);
-
         // render
-        for (auto data : mArray)
         {
-            data.renderer->render(aInfo, aAccessor);
+            gl::ProfileScope profile("pipeline", "render", true);
+            size_t i = 0;
+            while (i < mSorted.size())
+            {
+                const SortUnit& unit = mSorted[i];
+                const int slot = mNodes[unit.order].slot;
+
+                if (slot >= 0 && mSlotUsable[slot] && !isPassive(unit))
+                {
+                    // the run of the slot
+                    size_t end = i + 1;
+                    while (end < mSorted.size())
+                    {
+                        const SortUnit& next = mSorted[end];
+                        if (mNodes[next.order].slot != slot && !isPassive(next)) break;
+                        ++end;
+                    }
+                    renderSlot(slot, i, end, aInfo, aAccessor);
+                    i = end;
+                    continue;
+                }
+
+                unit.renderer->render(aInfo, aAccessor);
+                ++i;
+            }
         }
     }
 };
@@ -108,7 +477,9 @@ ObjectTree::ObjectTree()
     , mTopNode()
     , mCaller(new SortAndRenderCall())
     , mShaderHolder()
-    , mTimeCacheLock()
+    , mTimeCacheEpoch()
+    , mCurrentCacheArena()
+    , mWorkingCacheArena()
 {
 }
 
@@ -116,12 +487,18 @@ ObjectTree::~ObjectTree()
 {
 }
 
+void ObjectTree::grabTopNode(ObjectNode* aNode)
+{
+    mTopNode.reset(aNode);
+    mCaller->invalidate();
+}
+
 void ObjectTree::render(const RenderInfo& aInfo, bool aUseWorkingCache)
 {
     if (mTopNode.data())
     {
         TimeCacheAccessor accessor(
-                    *mTopNode.data(), mTimeCacheLock, aInfo.time, aUseWorkingCache);
+                    *this, *mTopNode.data(), aInfo.time, aUseWorkingCache);
         mCaller->invoke(mTopNode.data(), aInfo, accessor);
     }
 }
@@ -346,102 +723,50 @@ cmnd::Vector ObjectTree::createResourceUpdater(const ResourceEvent& aEvent)
 
 void ObjectTree::onTimeLineModified(TimeLineEvent& aEvent, bool)
 {
+    for (auto& target : aEvent.targets())
+    {
+        if (target.node) mCaller->invalidateStaticTree(*target.node);
+    }
+    for (auto& target : aEvent.defaultTargets())
+    {
+        if (target.node) mCaller->invalidateStaticTree(*target.node);
+    }
     BoneKeyUpdater::onTimeLineModified(aEvent);
 }
 
 void ObjectTree::onTreeRestructured(ObjectTreeEvent& aEvent, bool)
 {
+    mCaller->invalidate();
     BoneKeyUpdater::onTreeRestructured(aEvent);
 }
 
 void ObjectTree::onResourceModified(ResourceEvent& aEvent, bool)
 {
+    mCaller->invalidateStaticTrees();
     BoneKeyUpdater::onResourceModified(aEvent);
 }
 
-void ObjectTree::onProjectAttributeModified(ProjectEvent& aEvent, bool)
+void ObjectTree::onNodeAttributeModified(ObjectNode& aNode, bool)
 {
-    BoneKeyUpdater::onProjectAttributeModified(aEvent);
+    mCaller->invalidateStaticTree(aNode);
 }
 
-bool ObjectTree::serialize(Serializer& aOut) const
+void ObjectTree::onProjectAttributeModified(ProjectEvent& aEvent, bool)
 {
-    static const std::array<uint8, 8> kSignature =
-        { 'O', 'b', 'j', 'T', 'r', 'e', 'e', '_' };
-
-    // signature
-    auto pos = aOut.beginBlock(kSignature);
-
-    // top node count
-    aOut.write(topNode() ? 1 : 0);
-
-    // nodes
-    if (topNode())
-    {
-        if (!serializeNode(aOut, *topNode()))
-        {
-            return false;
-        }
-    }
-
-    aOut.endBlock(pos);
-
-    return aOut.checkStream();
+    mCaller->invalidateStaticTrees();
+    BoneKeyUpdater::onProjectAttributeModified(aEvent);
 }
 
-bool ObjectTree::serializeNode(Serializer& aOut, const ObjectNode& aNode) const
+bool ObjectTree::serialize(Serializer& aOut) const
 {
-    static const std::array<uint8, 8> kSignature =
-        { 'O', 'b', 'j', 'N', 'o', 'd', 'e', '_' };
-
-    // block begin
-    auto pos = aOut.beginBlock(kSignature);
-
-    // type
-    aOut.write((int)aNode.type());
-
-    // child count
-    aOut.write((int)aNode.children().size());
-
-    // reference id
-    aOut.writeID(&aNode);
-
-    // serialize object node
-    if (!aNode.serialize(aOut))
-    {
-        return false;
-    }
-
-    // block end
-    aOut.endBlock(pos);
-
-    // check failure
-    if (aOut.failure())
-    {
-        return false;
-    }
-
-    // iterate children
-    if (aNode.canHoldChild())
-    {
-        for (auto child : aNode.children())
-        {
-            XC_PTR_ASSERT(child);
-
-            if (!serializeNode(aOut, *child))
-            {
-                return false;
-            }
-        }
-    }
-
-    return !aOut.failure();
+    return ObjectTreeSnapshot(*this).serialize(aOut);
 }
 
 bool ObjectTree::deserialize(Deserializer& aIn)
 {
     // clear
     mTopNode.reset();
+    mCaller->invalidate();
 
     // check block begin
     if (!aIn.beginBlock("ObjTree_"))
@@ -16,7 +16,8 @@
 #include "core/TimeLineEvent.h"
 #include "core/ProjectEvent.h"
 #include "core/ShaderHolder.h"
-#include "core/TimeCacheLock.h"
+#include "core/TimeCacheEpoch.h"
+#include "core/TimeCacheArena.h"
 namespace core { class SortAndRenderCall; }
 
 namespace core
@@ -32,15 +33,22 @@ public:
     util::LifeLink::Pointee<ObjectTree> pointee() { return mLifeLink.pointee<ObjectTree>(this); }
     util::LifeLink::Pointee<const ObjectTree> constPointee() { return mLifeLink.pointee<const ObjectTree>(this); }
 
-    void grabTopNode(ObjectNode* aNode) { mTopNode.reset(aNode); }
+    void grabTopNode(ObjectNode* aNode);
     ObjectNode* topNode() { return mTopNode.data(); }
     const ObjectNode* topNode() const { return mTopNode.data(); }
 
     ShaderHolder& shaderHolder() { return mShaderHolder; }
     const ShaderHolder& shaderHolder() const { return mShaderHolder; }
 
-    TimeCacheLock& timeCacheLock() { return mTimeCacheLock; }
-    const TimeCacheLock& timeCacheLock() const { return mTimeCacheLock; }
+    TimeCacheEpoch& timeCacheEpoch() { return mTimeCacheEpoch; }
+    const TimeCacheEpoch& timeCacheEpoch() const { return mTimeCacheEpoch; }
+
+    // scratch spaces which are reused over evaluations. the current one is used
+    // while writing an epoch, and the working one while locking the working caches.
+    TimeCacheArena& timeCacheArena(bool aUseWorking)
+    {
+        return aUseWorking ? mWorkingCacheArena : mCurrentCacheArena;
+    }
 
     void render(const RenderInfo& aRenderInfo, bool aUseWorkingCache);
 
@@ -52,6 +60,7 @@ public:
     void onTimeLineModified(TimeLineEvent& aEvent, bool aIsUndo);
     void onTreeRestructured(ObjectTreeEvent& aEvent, bool aIsUndo);
     void onResourceModified(ResourceEvent& aEvent, bool aIsUndo);
+    void onNodeAttributeModified(ObjectNode& aNode, bool aIsUndo);
     void onProjectAttributeModified(ProjectEvent& aEvent, bool aIsUndo);
 
     bool serialize(Serializer& aOut) const;
@@ -61,7 +70,6 @@ private:
     ObjectNode* findNode(const util::TreePos& aPos);
     ObjectNode* eraseNode(const util::TreePos& aPos);
     void insertNode(const util::TreePos& aPos, ObjectNode* aNode);
-    bool serializeNode(Serializer& aOut, const ObjectNode& aNode) const;
     bool deserializeNode(Deserializer& aIn, ObjectNode* aParent);
     ObjectNode* createSerialNode(int aType);
 
@@ -69,7 +77,9 @@ private:
     QScopedPointer<ObjectNode> mTopNode;
     QScopedPointer<SortAndRenderCall> mCaller;
     ShaderHolder mShaderHolder;
-    TimeCacheLock mTimeCacheLock;
+    TimeCacheEpoch mTimeCacheEpoch;
+    TimeCacheArena mCurrentCacheArena;
+    TimeCacheArena mWorkingCacheArena;
 };
 
 } // namespace core
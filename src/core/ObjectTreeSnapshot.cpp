@@ -0,0 +1,303 @@
+#include "core/ObjectTreeSnapshot.h"
+#include "core/ObjectTree.h"
+#include "core/BoneKey.h"
+
+namespace core
+{
+
+//-------------------------------------------------------------------------------------------------
+ObjectTreeSnapshot::Key::Key()
+    : index(TimeLine::kDefaultKeyIndex)
+    , serialAddress()
+    , copy()
+    , children()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+ObjectTreeSnapshot::Node::Node()
+    : type(ObjectType_TERM)
+    , childCount(0)
+    , serialAddress()
+    , name()
+    , isVisible()
+    , isSlimmedDown()
+    , initialRect()
+    , isClipped()
+    , keys()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+ObjectTreeSnapshot::ObjectTreeSnapshot(const ObjectTree& aTree)
+    : mNodes()
+    , mAliases()
+{
+    if (aTree.topNode())
+    {
+        pushNodes(*aTree.topNode());
+    }
+}
+
+void ObjectTreeSnapshot::pushNodes(const ObjectNode& aNode)
+{
+    mNodes.push_back(Node());
+    {
+        Node& node = mNodes.back();
+        node.type = aNode.type();
+        node.childCount = (int)aNode.children().size();
+        node.serialAddress = &aNode;
+        node.name = aNode.name();
+        node.isVisible = aNode.isVisible();
+        node.isSlimmedDown = aNode.isSlimmedDown();
+        node.initialRect = aNode.initialRect();
+        node.isClipped = aNode.renderer() && aNode.renderer()->isClipped();
+
+        if (aNode.timeLine())
+        {
+            pushKeys(node.keys, *aNode.timeLine());
+        }
+    }
+
+    if (aNode.canHoldChild())
+    {
+        for (auto child : aNode.children())
+        {
+            XC_PTR_ASSERT(child);
+            pushNodes(*child);
+        }
+    }
+}
+
+void ObjectTreeSnapshot::pushKeys(KeyLists& aKeys, const TimeLine& aTimeLine)
+{
+    for (int i = 0; i < TimeKeyType_TERM; ++i)
+    {
+        const TimeKeyType type = (TimeKeyType)i;
+        auto& keys = aKeys[i];
+
+        auto defaultKey = aTimeLine.defaultKey(type);
+        if (defaultKey)
+        {
+            pushKey(keys, TimeLine::kDefaultKeyIndex, *defaultKey);
+        }
+
+        auto& map = aTimeLine.map(type);
+        for (auto itr = map.begin(); itr != map.end(); ++itr)
+        {
+            XC_PTR_ASSERT(itr.value());
+            pushKey(keys, itr.key(), *itr.value());
+        }
+    }
+}
+
+void ObjectTreeSnapshot::pushKey(std::vector<Key>& aKeys, int aIndex, const TimeKey& aKey)
+{
+    Key key;
+    key.index = aIndex;
+    key.serialAddress = &aKey;
+    key.copy.reset(aKey.createSnapshot());
+    for (const TimeKey* child : aKey.children())
+    {
+        key.children.push_back(child);
+    }
+
+    // the copied bones are written with the ids of the living ones,
+    // which poses refer to as their origins
+    if (aKey.type() == TimeKeyType_Bone)
+    {
+        auto& srcBones = static_cast<const BoneKey&>(aKey).data().topBones();
+        auto& dstBones = static_cast<const BoneKey&>(*key.copy).data().topBones();
+        XC_ASSERT(srcBones.count() == dstBones.count());
+
+        for (int i = 0; i < srcBones.count(); ++i)
+        {
+            Bone2::ConstIterator src(srcBones[i]);
+            Bone2::ConstIterator dst(dstBones[i]);
+            while (src.hasNext() && dst.hasNext())
+            {
+                auto srcBone = src.next();
+                mAliases.push_back(std::make_pair(dst.next(), srcBone));
+            }
+        }
+    }
+
+    aKeys.push_back(key);
+}
+
+bool ObjectTreeSnapshot::serialize(Serializer& aOut) const
+{
+    static const std::array<uint8, 8> kSignature =
+        { 'O', 'b', 'j', 'T', 'r', 'e', 'e', '_' };
+
+    for (auto& alias : mAliases)
+    {
+        aOut.setAlias(alias.first, alias.second);
+    }
+
+    // signature
+    auto pos = aOut.beginBlock(kSignature);
+
+    // top node count
+    aOut.write(mNodes.empty() ? 0 : 1);
+
+    // nodes
+    for (auto& node : mNodes)
+    {
+        if (!serializeNode(aOut, node))
+        {
+            return false;
+        }
+    }
+
+    aOut.endBlock(pos);
+
+    return aOut.checkStream();
+}
+
+bool ObjectTreeSnapshot::serializeNode(Serializer& aOut, const Node& aNode) const
+{
+    static const std::array<uint8, 8> kSignature =
+        { 'O', 'b', 'j', 'N', 'o', 'd', 'e', '_' };
+    static const std::array<uint8, 8> kLayerSignature =
+        { 'L', 'a', 'y', 'e', 'r', 'N', 'd', '_' };
+    static const std::array<uint8, 8> kFolderSignature =
+        { 'F', 'o', 'l', 'd', 'e', 'r', 'N', 'd' };
+
+    // block begin
+    auto pos = aOut.beginBlock(kSignature);
+
+    // type
+    aOut.write((int)aNode.type);
+
+    // child count
+    aOut.write(aNode.childCount);
+
+    // reference id
+    aOut.writeID(aNode.serialAddress);
+
+    // object node
+    {
+        XC_ASSERT(aNode.type == ObjectType_Layer || aNode.type == ObjectType_Folder);
+        auto nodePos = aOut.beginBlock(
+                    aNode.type == ObjectType_Layer ? kLayerSignature : kFolderSignature);
+
+        // name
+        aOut.write(aNode.name);
+        // visibility
+        aOut.write(aNode.isVisible);
+        // slim-down
+        aOut.write(aNode.isSlimmedDown);
+        // initial rect
+        aOut.write(aNode.initialRect);
+        // clipping
+        aOut.write(aNode.isClipped);
+        // timeline
+        if (!serializeTimeLine(aOut, aNode.keys))
+        {
+            return false;
+        }
+
+        aOut.endBlock(nodePos);
+    }
+
+    // block end
+    aOut.endBlock(pos);
+
+    return !aOut.failure();
+}
+
+bool ObjectTreeSnapshot::serializeTimeLine(Serializer& aOut, const KeyLists& aKeys) const
+{
+    static const std::array<uint8, 8> kSignature =
+        { 'T', 'i', 'm', 'e', 'L', 'i', 'n', 'e' };
+    static const std::array<uint8, 8> kMapSignature =
+        { 'T', 'i', 'm', 'e', 'M', 'a', 'p', '_' };
+
+    // signature
+    auto pos = aOut.beginBlock(kSignature);
+
+    // non empty type count (including default keys)
+    {
+        int count = 0;
+        for (auto& keys : aKeys)
+        {
+            if (!keys.empty()) ++count;
+        }
+        aOut.write(count);
+    }
+
+    // each map
+    for (int i = 0; i < TimeKeyType_TERM; ++i)
+    {
+        auto& keys = aKeys[i];
+        if (keys.empty()) continue;
+
+        auto itr = keys.begin();
+        const bool hasDefaultKey = (itr->index == TimeLine::kDefaultKeyIndex);
+
+        // signature
+        auto mapPos = aOut.beginBlock(kMapSignature);
+
+        // type name
+        aOut.write(TimeLine::getTimeKeyName((TimeKeyType)i));
+
+        // default key is exists
+        aOut.write(hasDefaultKey);
+
+        // defautltKey
+        if (hasDefaultKey)
+        {
+            if (!serializeTimeKey(aOut, *itr))
+            {
+                return false;
+            }
+            ++itr;
+        }
+
+        // key count
+        aOut.write((int)(keys.end() - itr));
+
+        for (; itr != keys.end(); ++itr)
+        {
+            // timekey index
+            aOut.write(itr->index);
+
+            // time key
+            if (!serializeTimeKey(aOut, *itr))
+            {
+                return false;
+            }
+        }
+
+        aOut.endBlock(mapPos);
+    }
+
+    aOut.endBlock(pos);
+
+    return aOut.checkStream();
+}
+
+bool ObjectTreeSnapshot::serializeTimeKey(Serializer& aOut, const Key& aKey) const
+{
+    // reference id
+    aOut.writeID(aKey.serialAddress);
+
+    // timekey value
+    if (!aKey.copy->serialize(aOut))
+    {
+        return false;
+    }
+
+    // child count
+    aOut.write((int)aKey.children.size());
+
+    // references to children
+    for (auto child : aKey.children)
+    {
+        aOut.writeID(child);
+    }
+    return true;
+}
+
+} // namespace core
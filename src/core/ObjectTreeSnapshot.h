@@ -0,0 +1,71 @@
+#ifndef CORE_OBJECTTREESNAPSHOT_H
+#define CORE_OBJECTTREESNAPSHOT_H
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <QRect>
+#include <QString>
+#include "util/NonCopyable.h"
+#include "core/ObjectType.h"
+#include "core/TimeKey.h"
+#include "core/TimeKeyType.h"
+#include "core/Serializer.h"
+namespace core { class ObjectTree; }
+namespace core { class ObjectNode; }
+namespace core { class TimeLine; }
+
+namespace core
+{
+
+// An immutable copy of an object tree.
+// Time keys are copied without any caches for drawing, and the living nodes
+// and keys are referred by addresses only. So it can be serialized on another
+// thread while the tree is being edited. (create it on the main thread)
+class ObjectTreeSnapshot : private util::NonCopyable
+{
+public:
+    ObjectTreeSnapshot(const ObjectTree& aTree);
+
+    bool serialize(Serializer& aOut) const;
+
+private:
+    struct Key
+    {
+        Key();
+        int index; // a frame or TimeLine::kDefaultKeyIndex
+        const void* serialAddress; ///@note it's used as a key only
+        std::shared_ptr<const TimeKey> copy;
+        std::vector<const void*> children; // serial addresses
+    };
+    typedef std::array<std::vector<Key>, TimeKeyType_TERM> KeyLists;
+
+    struct Node
+    {
+        Node();
+        ObjectType type;
+        int childCount;
+        const void* serialAddress; ///@note it's used as a key only
+        QString name;
+        bool isVisible;
+        bool isSlimmedDown;
+        QRect initialRect;
+        bool isClipped;
+        KeyLists keys; // a default key precedes the others
+    };
+
+    void pushNodes(const ObjectNode& aNode);
+    void pushKeys(KeyLists& aKeys, const TimeLine& aTimeLine);
+    void pushKey(std::vector<Key>& aKeys, int aIndex, const TimeKey& aKey);
+    bool serializeNode(Serializer& aOut, const Node& aNode) const;
+    bool serializeTimeLine(Serializer& aOut, const KeyLists& aKeys) const;
+    bool serializeTimeKey(Serializer& aOut, const Key& aKey) const;
+
+    std::vector<Node> mNodes; // pre-ordered
+    std::vector<std::pair<const void*, const void*>> mAliases;
+};
+
+} // namespace core
+
+#endif // CORE_OBJECTTREESNAPSHOT_H
@@ -31,6 +31,13 @@ TimeKey* OpaKey::createClone()
     return newKey;
 }
 
+TimeKey* OpaKey::createSnapshot() const
+{
+    auto newKey = new OpaKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool OpaKey::serialize(Serializer& aOut) const
 {
     aOut.write(mData.easing());
@@ -37,6 +37,7 @@ public:
 
     virtual TimeKeyType type() const { return TimeKeyType_Opa; }
     virtual TimeKey* createClone();
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
@@ -2,6 +2,36 @@
 #include "core/PoseKey.h"
 #include "core/BoneKey.h"
 
+namespace
+{
+
+bool isSameTree(const core::Bone2& aLhs, const core::Bone2& aRhs)
+{
+    if (aLhs.children().size() != aRhs.children().size()) return false;
+
+    auto itr = aRhs.children().begin();
+    for (auto child : aLhs.children())
+    {
+        if (!isSameTree(*child, **itr)) return false;
+        ++itr;
+    }
+    return true;
+}
+
+void copyBoneValues(core::Bone2& aDst, const core::Bone2& aSrc)
+{
+    aDst.copyValues(aSrc);
+
+    auto itr = aSrc.children().begin();
+    for (auto child : aDst.children())
+    {
+        copyBoneValues(*child, **itr);
+        ++itr;
+    }
+}
+
+} // namespace
+
 namespace core
 {
 
@@ -24,6 +54,22 @@ PoseKey::Data::Data(const Data& aRhs)
 
 PoseKey::Data& PoseKey::Data::operator=(const Data& aRhs)
 {
+    if (this == &aRhs) return *this;
+
+    // reuse the current bones if possible. (this is called for each frame)
+    if (hasSameStructure(aRhs))
+    {
+        mEasing = aRhs.easing();
+
+        int index = 0;
+        for (Bone2* bone : mTopBones)
+        {
+            copyBoneValues(*bone, *aRhs.topBones().at(index));
+            ++index;
+        }
+        return *this;
+    }
+
     deleteAll();
     mEasing = aRhs.easing();
 
@@ -58,6 +104,17 @@ const QList<Bone2*>& PoseKey::Data::topBones() const
     return mTopBones;
 }
 
+bool PoseKey::Data::hasSameStructure(const Data& aRhs) const
+{
+    if (mTopBones.size() != aRhs.topBones().size()) return false;
+
+    for (int i = 0; i < mTopBones.size(); ++i)
+    {
+        if (!isSameTree(*mTopBones.at(i), *aRhs.topBones().at(i))) return false;
+    }
+    return true;
+}
+
 void PoseKey::Data::deleteAll()
 {
     qDeleteAll(mTopBones);
@@ -77,6 +134,13 @@ TimeKey* PoseKey::createClone()
     return newKey;
 }
 
+TimeKey* PoseKey::createSnapshot() const
+{
+    auto newKey = new PoseKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool PoseKey::serialize(Serializer& aOut) const
 {
     // easing
@@ -34,6 +34,7 @@ public:
         const QList<Bone2*>& topBones() const;
 
         bool isEmpty() const { return mTopBones.empty(); }
+        bool hasSameStructure(const Data& aRhs) const;
         void deleteAll();
     };
 
@@ -44,6 +45,7 @@ public:
 
     virtual TimeKeyType type() const { return TimeKeyType_Pose; }
     virtual TimeKey* createClone();
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
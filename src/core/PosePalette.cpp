@@ -1,87 +1,128 @@
+#include <algorithm>
+#include <vector>
 #include <QQuaternion>
+#include "gl/Global.h"
 #include "core/PosePalette.h"
 #include "util/MathUtil.h"
 
+namespace
+{
+
+// pre-order walk without the allocations of tree iterators
+template<typename tVisitor>
+bool visitBones(const core::Bone2* aBone, tVisitor& aVisitor)
+{
+    XC_PTR_ASSERT(aBone);
+    if (!aVisitor(aBone)) return false;
+
+    for (auto child : aBone->children())
+    {
+        if (!visitBones(child, aVisitor)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
 namespace core
 {
 
 int PosePalette::getBoneIndex(const BoneKey::Data& aData, const Bone2& aBone)
 {
     int count = 0;
+    bool found = false;
+    auto visitor = [&](const Bone2* aTarget)
+    {
+        if (aTarget == &aBone) { found = true; return false; }
+        ++count;
+        return true;
+    };
+
     for (auto topBone : aData.topBones())
     {
-        Bone2::ConstIterator itr(topBone);
-        while (itr.hasNext())
-        {
-            const Bone2* bone = itr.next();
-            XC_PTR_ASSERT(bone);
-            if (bone == &aBone) return count;
-            ++count;
-        }
+        if (!visitBones(topBone, visitor)) break;
     }
-    return -1;
+    return found ? count : -1;
 }
 
 PosePalette::PosePalette()
     : mData()
+    , mDualQuats()
+    , mCount(0)
     , mIsUnit(true)
+    , mBuffer()
+    , mUploadedCount(0)
+    , mIsUploaded(false)
 {
-    clearDualQuaternions();
 }
 
-int PosePalette::makeBoneOrigins(const KeyPairs& aSrc, BonePairs& aDst)
+PosePalette::~PosePalette()
+{
+    if (mBuffer)
+    {
+        gl::Global::makeCurrent();
+        mBuffer.reset();
+    }
+}
+
+int PosePalette::makeBoneOrigins(const KeyPair* aSrc, int aSrcCount, BonePairs& aDst)
 {
     int count = 0;
-    for (auto keyPair : aSrc)
+    auto visitor = [&](const Bone2* aBone)
     {
-        for (auto topBone : keyPair.origin->topBones())
+        aDst[count].origin = aBone;
+        return ++count < kMaxCount;
+    };
+
+    for (int i = 0; i < aSrcCount; ++i)
+    {
+        for (auto topBone : aSrc[i].origin->topBones())
         {
-            Bone2::ConstIterator itr(topBone);
-            while (itr.hasNext())
-            {
-                const Bone2* bone = itr.next();
-                XC_PTR_ASSERT(bone);
-                aDst[count].origin = bone;
-
-                ++count;
-                if (count >= kMaxCount) return count;
-            }
+            if (!visitBones(topBone, visitor)) return count;
         }
     }
     return count;
 }
 
-int PosePalette::makeBonePoses(const KeyPairs& aSrc, BonePairs& aDst)
+int PosePalette::makeBonePoses(const KeyPair* aSrc, int aSrcCount, BonePairs& aDst)
 {
     int count = 0;
-    for (auto keyPair : aSrc)
+    auto visitor = [&](const Bone2* aBone)
     {
-        for (auto topBone : keyPair.pose->topBones())
+        aDst[count].pose = aBone;
+        return ++count < kMaxCount;
+    };
+
+    for (int i = 0; i < aSrcCount; ++i)
+    {
+        for (auto topBone : aSrc[i].pose->topBones())
         {
-            Bone2::ConstIterator itr(topBone);
-            while (itr.hasNext())
-            {
-                const Bone2* bone = itr.next();
-                XC_PTR_ASSERT(bone);
-                aDst[count].pose = bone;
-
-                ++count;
-                if (count >= kMaxCount) return count;
-            }
+            if (!visitBones(topBone, visitor)) return count;
         }
     }
     return count;
 }
 
 void PosePalette::build(const KeyPairs& aKeyPairs)
+{
+    build(aKeyPairs.constData(), aKeyPairs.size());
+}
+
+void PosePalette::build(const KeyPair& aKeyPair)
+{
+    build(&aKeyPair, 1);
+}
+
+void PosePalette::build(const KeyPair* aKeyPairs, int aCount)
 {
     mIsUnit = false;
 
     BonePairs bonePairs;
-    int count = makeBoneOrigins(aKeyPairs, bonePairs);
-    int index = makeBonePoses(aKeyPairs, bonePairs);
+    int count = makeBoneOrigins(aKeyPairs, aCount, bonePairs);
+    int index = makeBonePoses(aKeyPairs, aCount, bonePairs);
 
     XC_MSG_ASSERT(count == index, "%d, %d", count, index); (void)index;
+    resetCount(count);
 
     for (int i = 0; i < count; ++i)
     {
@@ -112,45 +153,81 @@ void PosePalette::build(const KeyPairs& aKeyPairs)
             mDualQuats[i] = makeDualQuaternion(quat, trans);
         }
     }
-    for (int i = count; i < kMaxCount; ++i)
-    {
-        mData[i] = QMatrix4x4();
-        mDualQuats[i].real.set(1.0f, 0.0f, 0.0f, 0.0f);
-        mDualQuats[i].dual.set(0.0f, 0.0f, 0.0f, 0.0f);
-    }
 }
 
 void PosePalette::clear()
 {
     if (mIsUnit) return;
     mIsUnit = true;
-
-    for (int i = 0; i < kMaxCount; ++i)
-    {
-        mData[i] = QMatrix4x4();
-    }
-
-    clearDualQuaternions();
+    resetCount(0);
 }
 
-void PosePalette::clearDualQuaternions()
+void PosePalette::resetCount(int aCount)
 {
-    for (int i = 0; i < kMaxCount; ++i)
+    XC_ASSERT(0 <= aCount && aCount <= kMaxCount);
+
+    // the released range goes back to the identity. (the uploaded range too)
+    if (mDualQuats.size() < aCount)
     {
-        mDualQuats[i].real.set(1.0f, 0.0f, 0.0f, 0.0f);
-        mDualQuats[i].dual.set(0.0f, 0.0f, 0.0f, 0.0f);
+        mDualQuats.resize(aCount);
     }
-
+    for (int i = aCount; i < mCount; ++i)
+    {
+        mDualQuats[i] = unitDualQuaternion();
+    }
+    mData.resize(aCount);
+    mCount = aCount;
+    mIsUploaded = false;
 }
 
 util::ArrayBlock<const QMatrix4x4> PosePalette::matrices() const
 {
-    return util::ArrayBlock<const QMatrix4x4>(mData.data(), kMaxCount);
+    if (mCount <= 0) return util::ArrayBlock<const QMatrix4x4>();
+    return util::ArrayBlock<const QMatrix4x4>(mData.constData(), mCount);
 }
 
 util::ArrayBlock<const PosePalette::DualQuaternion> PosePalette::dualQuaternions() const
 {
-    return util::ArrayBlock<const DualQuaternion>(mDualQuats.data(), kMaxCount);
+    if (mCount <= 0) return util::ArrayBlock<const DualQuaternion>();
+    return util::ArrayBlock<const DualQuaternion>(mDualQuats.constData(), mCount);
+}
+
+const gl::BufferObject& PosePalette::dualQuaternionBuffer() const
+{
+    if (!mBuffer)
+    {
+        const std::vector<DualQuaternion> units(kMaxCount, unitDualQuaternion());
+        mBuffer.reset(new gl::BufferObject(GL_UNIFORM_BUFFER));
+        mBuffer->resetData<DualQuaternion>(kMaxCount, GL_DYNAMIC_DRAW, units.data());
+        mUploadedCount = 0;
+        mIsUploaded = false;
+    }
+
+    if (!mIsUploaded)
+    {
+        // overwrite the current range and the identities of the released range
+        const int count = std::max(mCount, mUploadedCount);
+        if (count > 0)
+        {
+            gl::Global::Functions& ggl = gl::Global::functions();
+            ggl.glBindBuffer(GL_UNIFORM_BUFFER, mBuffer->id());
+            ggl.glBufferSubData(GL_UNIFORM_BUFFER, 0,
+                                sizeof(DualQuaternion) * count, mDualQuats.constData());
+            ggl.glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            GL_CHECK_ERROR();
+        }
+        mUploadedCount = mCount;
+        mIsUploaded = true;
+    }
+    return *mBuffer;
+}
+
+PosePalette::DualQuaternion PosePalette::unitDualQuaternion()
+{
+    DualQuaternion dq;
+    dq.real.set(1.0f, 0.0f, 0.0f, 0.0f);
+    dq.dual.set(0.0f, 0.0f, 0.0f, 0.0f);
+    return dq;
 }
 
 PosePalette::DualQuaternion PosePalette::makeDualQuaternion(
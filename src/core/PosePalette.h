@@ -4,19 +4,22 @@
 #include <array>
 #include <QMatrix4x4>
 #include <QVector>
+#include <QScopedPointer>
 #include "XC.h"
 #include "util/ArrayBlock.h"
+#include "util/NonCopyable.h"
 #include "gl/Vector4.h"
+#include "gl/BufferObject.h"
 #include "core/BoneKey.h"
 #include "core/PoseKey.h"
 
 namespace core
 {
 
-class PosePalette
+class PosePalette : private util::NonCopyable
 {
 public:
-    enum { kMaxCount = 32 };
+    enum { kMaxCount = 256 };
 
     struct KeyPair
     {
@@ -35,25 +38,39 @@ public:
     static int getBoneIndex(const BoneKey::Data& aData, const Bone2& aBone);
 
     PosePalette();
+    ~PosePalette();
 
     void build(const KeyPairs& aKeyPairs);
+    void build(const KeyPair& aKeyPair);
     void clear();
 
+    // the bones which are not included are the identity.
+    int count() const { return mCount; }
     util::ArrayBlock<const QMatrix4x4> matrices() const;
     util::ArrayBlock<const DualQuaternion> dualQuaternions() const;
 
+    // an uniform buffer of vec4[2 * kMaxCount]. (std140)
+    // it's uploaded at the first call after each build.
+    const gl::BufferObject& dualQuaternionBuffer() const;
+
 private:
     struct BonePair { const Bone2* origin; const Bone2* pose; };
     typedef std::array<BonePair, kMaxCount> BonePairs;
-    int makeBoneOrigins(const KeyPairs& aSrc, BonePairs& aDst);
-    int makeBonePoses(const KeyPairs& aSrc, BonePairs& aDst);
-    void clearDualQuaternions();
+    void build(const KeyPair* aKeyPairs, int aCount);
+    int makeBoneOrigins(const KeyPair* aSrc, int aSrcCount, BonePairs& aDst);
+    int makeBonePoses(const KeyPair* aSrc, int aSrcCount, BonePairs& aDst);
+    void resetCount(int aCount);
+    static DualQuaternion unitDualQuaternion();
     static DualQuaternion makeDualQuaternion(
             const QQuaternion& aUnitQuat, const QVector3D& aTrans);
 
-    std::array<QMatrix4x4, kMaxCount> mData;
+    QVector<QMatrix4x4> mData;
+    QVector<DualQuaternion> mDualQuats;
+    int mCount;
     bool mIsUnit;
-    std::array<DualQuaternion, kMaxCount> mDualQuats;
+    mutable QScopedPointer<gl::BufferObject> mBuffer;
+    mutable int mUploadedCount;
+    mutable bool mIsUploaded;
 };
 
 } // namespace core
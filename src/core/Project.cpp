@@ -32,6 +32,9 @@ Project::Project(QString aFileName, Animator& aAnimator, Hook* aHookGrabbed)
     , mObjectTree()
     , mAnimator(aAnimator)
     , mHook(aHookGrabbed)
+    , mQueuedEvent()
+    , mQueuedUpdaters()
+    , mIsFlushing(false)
 {
     if (!aFileName.isEmpty())
     {
@@ -46,8 +49,12 @@ Project::Project(QString aFileName, Animator& aAnimator, Hook* aHookGrabbed)
     onTimeLineModified.connect(&mObjectTree, &ObjectTree::onTimeLineModified);
     onTreeRestructured.connect(&mObjectTree, &ObjectTree::onTreeRestructured);
     onResourceModified.connect(&mObjectTree, &ObjectTree::onResourceModified);
+    onNodeAttributeModified.connect(&mObjectTree, &ObjectTree::onNodeAttributeModified);
     onProjectAttributeModified.connect(&mObjectTree, &ObjectTree::onProjectAttributeModified);
 
+    // queued targets must be alive while they are notified
+    mCommandStack.setOnCommandInvoking([=]() { flushTimeLineEvents(); });
+
 #ifdef UNUSE_PARALLEL
 #else
     mParalleler->start();
@@ -56,6 +63,11 @@ Project::Project(QString aFileName, Animator& aAnimator, Hook* aHookGrabbed)
 
 Project::~Project()
 {
+    // discard queued events
+    mCommandStack.setOnCommandInvoking(nullptr);
+    mQueuedEvent = TimeLineEvent();
+    mQueuedUpdaters.clear();
+
     // clear all command firstly
     mCommandStack.clear();
 }
@@ -66,6 +78,61 @@ void Project::setFileName(const QString& aFileName)
     mResourceHolder.setRootPath(QFileInfo(aFileName).path());
 }
 
+void Project::queueTimeLineEvent(const TimeLineEvent& aEvent)
+{
+    if (!aEvent.hasAnyTargets()) return;
+
+    // events of different types are never merged
+    if (mQueuedEvent.hasAnyTargets() && mQueuedEvent.type() != aEvent.type())
+    {
+        flushTimeLineEvents();
+    }
+    mQueuedEvent.setType(aEvent.type());
+    mQueuedEvent.mergeTargets(aEvent);
+}
+
+void Project::queueTimeLineUpdater(const void* aOwner, const std::function<void()>& aUpdater)
+{
+    for (auto& updater : mQueuedUpdaters)
+    {
+        if (updater.first == aOwner)
+        {
+            updater.second = aUpdater;
+            return;
+        }
+    }
+    mQueuedUpdaters.push_back(std::make_pair(aOwner, aUpdater));
+}
+
+bool Project::hasQueuedTimeLineEvents() const
+{
+    return mQueuedEvent.hasAnyTargets() || !mQueuedUpdaters.empty();
+}
+
+void Project::flushTimeLineEvents()
+{
+    if (mIsFlushing || !hasQueuedTimeLineEvents()) return;
+    mIsFlushing = true;
+
+    // take the queue firstly, the listeners may queue next events
+    TimeLineEvent event = mQueuedEvent;
+    mQueuedEvent = TimeLineEvent();
+    std::vector<std::pair<const void*, std::function<void()>>> updaters;
+    updaters.swap(mQueuedUpdaters);
+
+    for (auto& updater : updaters)
+    {
+        updater.second();
+    }
+
+    if (event.hasAnyTargets())
+    {
+        onTimeLineModified(event, false);
+    }
+
+    mIsFlushing = false;
+}
+
 TimeInfo Project::currentTimeInfo() const
 {
     TimeInfo time;
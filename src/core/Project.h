@@ -5,6 +5,7 @@
 #include <QString>
 #include <QScopedPointer>
 #include <functional>
+#include <vector>
 #include "util/LifeLink.h"
 #include "util/Signaler.h"
 #include "util/NonCopyable.h"
@@ -85,6 +86,15 @@ public:
 
     Hook* hook() { return mHook.data(); }
 
+    // value changes of interactive editing are merged here and emitted once
+    // through onTimeLineModified by flushTimeLineEvents(). it is flushed before
+    // rendering and before any command is executed, undone or redone.
+    void queueTimeLineEvent(const TimeLineEvent& aEvent);
+    // a heavy update which runs once at the next flush. (the last one wins per aOwner)
+    void queueTimeLineUpdater(const void* aOwner, const std::function<void()>& aUpdater);
+    bool hasQueuedTimeLineEvents() const;
+    void flushTimeLineEvents();
+
     util::Signaler<void(TimeLineEvent&, bool)> onTimeLineModified;
     util::Signaler<void(ObjectNode&, bool)> onNodeAttributeModified;
     util::Signaler<void(ResourceEvent&, bool)> onResourceModified;
@@ -102,6 +112,9 @@ private:
     ObjectTree mObjectTree;
     Animator& mAnimator;
     QScopedPointer<Hook> mHook;
+    TimeLineEvent mQueuedEvent;
+    std::vector<std::pair<const void*, std::function<void()>>> mQueuedUpdaters;
+    bool mIsFlushing;
 };
 
 } // namespace core
@@ -22,6 +22,8 @@ public:
         , isGrid(false)
         , nonPosed(false)
         , originMesh(false)
+        , cachesStaticTree(false)
+        , isFlattening(false)
         , clippingId(0)
         , clippingFrame()
         , destTexturizer()
@@ -35,6 +37,8 @@ public:
     bool isGrid;
     bool nonPosed;
     bool originMesh;
+    bool cachesStaticTree; // flatten static folders into textures
+    bool isFlattening; // rendering into a flattened texture
     uint8 clippingId;
     ClippingFrame* clippingFrame;
     DestinationTexturizer* destTexturizer;
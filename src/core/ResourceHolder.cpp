@@ -1,6 +1,8 @@
 #include <QDir>
+#include <QHash>
 #include "img/BlendMode.h"
 #include "core/ResourceHolder.h"
+#include "core/ResourceSnapshot.h"
 
 namespace core
 {
@@ -45,6 +47,8 @@ void ResourceHolder::pushImageTree(
     data.topNode = &aGrabNode;
     data.filePath = relativeFilePath(aFilePath);
     mImageTrees.push_back(data);
+
+    shareSameImages(aGrabNode);
 }
 
 ResourceHolder::ImageTree ResourceHolder::popImageTree()
@@ -137,94 +141,56 @@ QString ResourceHolder::findRelativeFilePath(const img::ResourceNode& aTopNode)
     return QString();
 }
 
-void ResourceHolder::destroy()
+void ResourceHolder::shareSameImages(img::ResourceNode& aTopNode)
 {
-    for (auto data : mImageTrees)
+    // index of existing images
+    QHash<uint64, const img::ResourceData*> index;
+    for (auto& data : mImageTrees)
     {
-        delete data.topNode;
-    }
-    mImageTrees.clear();
-}
+        if (data.topNode == &aTopNode) continue;
 
-bool ResourceHolder::serialize(Serializer& aOut) const
-{
-    static const std::array<uint8, 8> kSignature =
-        { 'R', 'e', 's', 'o', 'u', 'r', 'c', 'e' };
-
-    // signature
-    auto pos = aOut.beginBlock(kSignature);
-
-    // top node count
-    aOut.write((int)mImageTrees.size());
+        img::ResourceNode::ConstIterator itr(data.topNode);
+        while (itr.hasNext())
+        {
+            auto& resData = itr.next()->data();
+            if (resData.hasImage() && !index.contains(resData.imageHash()))
+            {
+                index.insert(resData.imageHash(), &resData);
+            }
+        }
+    }
 
-    for (auto data : mImageTrees)
+    // share buffers of the same images
+    img::ResourceNode::Iterator itr(&aTopNode);
+    while (itr.hasNext())
     {
-        // file path
-        aOut.write(data.filePath);
+        auto& resData = itr.next()->data();
+        if (!resData.hasImage()) continue;
 
-        // write nodes
-        if (!serializeNode(aOut, *data.topNode))
+        auto found = index.find(resData.imageHash());
+        if (found == index.end())
         {
-            return false;
+            index.insert(resData.imageHash(), &resData);
+        }
+        else if (resData.hasSameImageWith(*found.value()))
+        {
+            resData.shareImage(*found.value());
         }
     }
-
-    // end block
-    aOut.endBlock(pos);
-
-    return aOut.checkStream();
 }
 
-bool ResourceHolder::serializeNode(Serializer& aOut, const img::ResourceNode& aNode) const
+void ResourceHolder::destroy()
 {
-    static const std::array<uint8, 8> kSignature =
-        { 'R', 'e', 's', 'N', 'o', 'd', 'e', '_' };
-
-    // block begin
-    auto pos = aOut.beginBlock(kSignature);
-
-    // identifier
-    aOut.write(aNode.data().identifier());
-
-    // child count
-    aOut.write((int)aNode.children().size());
-
-    // reference id
-    aOut.writeID(&aNode);
-
-    // is layer
-    aOut.write(aNode.data().isLayer());
-
-    // rect
-    aOut.write(QRect(aNode.data().pos(), aNode.data().image().pixelSize()));
-
-    // blend mode
-    aOut.writeFixedString(img::getQuadIdFromBlendMode(aNode.data().blendMode()), 4);
-
-    // memory block(null image is also ok)
-    aOut.writeImage(aNode.data().image().block(), aNode.data().image().pixelSize());
-
-    // block end
-    aOut.endBlock(pos);
-
-    // check failure
-    if (aOut.failure())
-    {
-        return false;
-    }
-
-    // iterate children
-    for (auto child : aNode.children())
+    for (auto data : mImageTrees)
     {
-        XC_PTR_ASSERT(child);
-
-        if (!serializeNode(aOut, *child))
-        {
-            return false;
-        }
+        delete data.topNode;
     }
+    mImageTrees.clear();
+}
 
-    return aOut.checkStream();
+bool ResourceHolder::serialize(Serializer& aOut) const
+{
+    return ResourceSnapshot(*this).serialize(aOut);
 }
 
 bool ResourceHolder::deserialize(Deserializer& aIn)
@@ -257,6 +223,7 @@ bool ResourceHolder::deserialize(Deserializer& aIn)
         }
 
         mImageTrees.push_back(data);
+        shareSameImages(*data.topNode);
 
         // progress report
         aIn.reportCurrent();
@@ -324,6 +291,14 @@ bool ResourceHolder::deserializeNode(Deserializer& aIn, img::ResourceNode** aDst
         nodePtr->data().setBlendMode(blendMode);
     }
 
+    // content hash of the image
+    uint64 imageHash = 0;
+    const bool hasHash = aIn.version() >= QVersionNumber(0, 6);
+    if (hasHash)
+    {
+        aIn.read(imageHash);
+    }
+
     // memory block
     XCMemBlock block;
     if (!aIn.readImage(block))
@@ -333,7 +308,14 @@ bool ResourceHolder::deserializeNode(Deserializer& aIn, img::ResourceNode** aDst
 
     if (block.data)
     {
-        nodePtr->data().grabImage(block, rect.size(), img::Format_RGBA8);
+        if (hasHash)
+        {
+            nodePtr->data().grabImage(block, rect.size(), img::Format_RGBA8, imageHash);
+        }
+        else
+        {
+            nodePtr->data().grabImage(block, rect.size(), img::Format_RGBA8);
+        }
     }
 
     // check block end
@@ -52,7 +52,7 @@ public:
 
 private:
     void destroy();
-    bool serializeNode(Serializer& aOut, const img::ResourceNode& aNode) const;
+    void shareSameImages(img::ResourceNode& aTopNode);
     bool deserializeNode(Deserializer& aIn, img::ResourceNode** aDst);
 
     std::list<ImageTree> mImageTrees;
@@ -0,0 +1,146 @@
+#include "core/ResourceSnapshot.h"
+#include "core/ResourceHolder.h"
+
+namespace core
+{
+
+//-------------------------------------------------------------------------------------------------
+ResourceSnapshot::Node::Node()
+    : identifier()
+    , childCount(0)
+    , serialAddress()
+    , isLayer()
+    , rect()
+    , blendMode(img::BlendMode_Normal)
+    , image()
+    , imageHash()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+ResourceSnapshot::ResourceSnapshot(const ResourceHolder& aHolder)
+    : mTrees()
+{
+    for (auto data : aHolder.imageTrees())
+    {
+        XC_PTR_ASSERT(data.topNode);
+        mTrees.push_back(Tree());
+        mTrees.back().filePath = data.filePath;
+        pushNodes(mTrees.back(), *data.topNode);
+    }
+}
+
+void ResourceSnapshot::pushNodes(Tree& aTree, const img::ResourceNode& aNode)
+{
+    Node node;
+    node.identifier = aNode.data().identifier();
+    node.childCount = (int)aNode.children().size();
+    node.serialAddress = &aNode;
+    node.isLayer = aNode.data().isLayer();
+    node.rect = QRect(aNode.data().pos(), aNode.data().image().pixelSize());
+    node.blendMode = aNode.data().blendMode();
+    node.image = aNode.data().sharedImage();
+    node.imageHash = aNode.data().imageHash();
+    aTree.nodes.push_back(node);
+
+    for (auto child : aNode.children())
+    {
+        XC_PTR_ASSERT(child);
+        pushNodes(aTree, *child);
+    }
+}
+
+int ResourceSnapshot::nodeCount() const
+{
+    int count = 0;
+    for (auto& tree : mTrees)
+    {
+        count += (int)tree.nodes.size();
+    }
+    return count;
+}
+
+bool ResourceSnapshot::serialize(Serializer& aOut, util::IProgressReporter* aReporter) const
+{
+    static const std::array<uint8, 8> kSignature =
+        { 'R', 'e', 's', 'o', 'u', 'r', 'c', 'e' };
+
+    if (aReporter)
+    {
+        aReporter->setMaximum(nodeCount());
+        aReporter->setProgress(0);
+    }
+    int progress = 0;
+
+    // signature
+    auto pos = aOut.beginBlock(kSignature);
+
+    // top node count
+    aOut.write((int)mTrees.size());
+
+    for (auto& tree : mTrees)
+    {
+        // file path
+        aOut.write(tree.filePath);
+
+        // write nodes
+        for (auto& node : tree.nodes)
+        {
+            if (!serializeNode(aOut, node))
+            {
+                return false;
+            }
+
+            if (aReporter)
+            {
+                aReporter->setProgress(++progress);
+                if (aReporter->wasCanceled()) return false;
+            }
+        }
+    }
+
+    // end block
+    aOut.endBlock(pos);
+
+    return aOut.checkStream();
+}
+
+bool ResourceSnapshot::serializeNode(Serializer& aOut, const Node& aNode) const
+{
+    static const std::array<uint8, 8> kSignature =
+        { 'R', 'e', 's', 'N', 'o', 'd', 'e', '_' };
+
+    // block begin
+    auto pos = aOut.beginBlock(kSignature);
+
+    // identifier
+    aOut.write(aNode.identifier);
+
+    // child count
+    aOut.write(aNode.childCount);
+
+    // reference id
+    aOut.writeID(aNode.serialAddress);
+
+    // is layer
+    aOut.write(aNode.isLayer);
+
+    // rect
+    aOut.write(aNode.rect);
+
+    // blend mode
+    aOut.writeFixedString(img::getQuadIdFromBlendMode(aNode.blendMode), 4);
+
+    // content hash of the image
+    aOut.write(aNode.imageHash);
+
+    // memory block(null image is also ok)
+    aOut.writeImage(aNode.image->block(), aNode.image->pixelSize());
+
+    // block end
+    aOut.endBlock(pos);
+
+    return aOut.checkStream();
+}
+
+} // namespace core
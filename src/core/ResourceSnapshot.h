@@ -0,0 +1,58 @@
+#ifndef CORE_RESOURCESNAPSHOT_H
+#define CORE_RESOURCESNAPSHOT_H
+
+#include <vector>
+#include <memory>
+#include <QRect>
+#include <QString>
+#include "util/IProgressReporter.h"
+#include "img/Buffer.h"
+#include "img/BlendMode.h"
+#include "core/Serializer.h"
+namespace img { class ResourceNode; }
+namespace core { class ResourceHolder; }
+
+namespace core
+{
+
+// An immutable copy of image trees.
+// Image buffers are shared and never modified, so it's cheap to create it and
+// it can be serialized on another thread while the holder is being edited.
+class ResourceSnapshot
+{
+public:
+    ResourceSnapshot(const ResourceHolder& aHolder);
+
+    int nodeCount() const;
+
+    bool serialize(Serializer& aOut, util::IProgressReporter* aReporter = nullptr) const;
+
+private:
+    struct Node
+    {
+        Node();
+        QString identifier;
+        int childCount;
+        const void* serialAddress; ///@note it's used as a key only
+        bool isLayer;
+        QRect rect;
+        img::BlendMode blendMode;
+        std::shared_ptr<const img::Buffer> image;
+        uint64 imageHash;
+    };
+
+    struct Tree
+    {
+        QString filePath;
+        std::vector<Node> nodes; // pre-ordered
+    };
+
+    void pushNodes(Tree& aTree, const img::ResourceNode& aNode);
+    bool serializeNode(Serializer& aOut, const Node& aNode) const;
+
+    std::vector<Tree> mTrees;
+};
+
+} // namespace core
+
+#endif // CORE_RESOURCESNAPSHOT_H
@@ -28,6 +28,13 @@ TimeKey* RotateKey::createClone()
     return newKey;
 }
 
+TimeKey* RotateKey::createSnapshot() const
+{
+    auto newKey = new RotateKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool RotateKey::serialize(Serializer& aOut) const
 {
     aOut.write(mData.easing());
@@ -29,6 +29,13 @@ TimeKey* ScaleKey::createClone()
     return newKey;
 }
 
+TimeKey* ScaleKey::createSnapshot() const
+{
+    auto newKey = new ScaleKey();
+    newKey->mData = this->mData;
+    return newKey;
+}
+
 bool ScaleKey::serialize(Serializer& aOut) const
 {
     aOut.write(mData.easing());
@@ -38,6 +38,7 @@ public:
 
     virtual TimeKeyType type() const { return TimeKeyType_Scale; }
     virtual TimeKey* createClone();
+    virtual TimeKey* createSnapshot() const;
     virtual bool serialize(Serializer& aOut) const;
     virtual bool deserialize(Deserializer& aIn);
 
@@ -1,5 +1,7 @@
+#include <memory>
 #include "core/Serializer.h"
 #include "util/PackBits.h"
+#include "util/ChannelUtil.h"
 
 namespace core
 {
@@ -7,6 +9,7 @@ namespace core
 Serializer::Serializer(util::StreamWriter& aOut)
     : mOut(aOut)
     , mIDAssigner()
+    , mAliases()
 {
     // set null to zero
     auto id = mIDAssigner.getId(nullptr);
@@ -23,6 +26,11 @@ void Serializer::write(int aValue)
     mOut.write((sint32)aValue);
 }
 
+void Serializer::write(uint64 aValue)
+{
+    mOut.write((uint64)aValue);
+}
+
 void Serializer::write(float aValue)
 {
     mOut.write((float32)aValue);
@@ -200,10 +208,15 @@ void Serializer::writeGL(const gl::Vector3* aArray, int aCount)
 
 void Serializer::writeID(const void *aData)
 {
-    auto id = mIDAssigner.getId(aData);
+    auto id = mIDAssigner.getId(mAliases.value(aData, aData));
     mOut.write(static_cast<sint32>(id));
 }
 
+void Serializer::setAlias(const void* aData, const void* aOrigin)
+{
+    mAliases[aData] = aOrigin;
+}
+
 void Serializer::writeImage(const XCMemBlock& aImage, const QSize& aSize)
 {
     const int w = aSize.width();
@@ -230,11 +243,9 @@ void Serializer::writeImage(const XCMemBlock& aImage, const QSize& aSize)
     const size_t wrkSize = (size_t)w;
     const size_t dstSize = util::PackBits::worstEncodedSize(wrkSize);
 
-    QScopedPointer<uint8> wrk(new uint8[wrkSize]);
-    QScopedPointer<uint8> dst(new uint8[dstSize]);
-    const XCMemBlock wrkBlock(wrk.data(), wrkSize);
-
-    util::PackBits encoder;
+    std::unique_ptr<uint8[]> wrk(new uint8[wrkSize * 4]);
+    std::unique_ptr<uint8[]> dst(new uint8[dstSize]);
+    uint8* planes[4] = { wrk.get(), wrk.get() + wrkSize, wrk.get() + wrkSize * 2, wrk.get() + wrkSize * 3 };
 
     // total length
     auto pos = mOut.reserveLength();
@@ -242,21 +253,19 @@ void Serializer::writeImage(const XCMemBlock& aImage, const QSize& aSize)
     // each line
     for (int y = 0; y < h; ++y)
     {
+        // separate channel bytes
+        util::ChannelUtil::split4(src, wrkSize, planes[0], planes[1], planes[2], planes[3]);
+
         // each channel
         for (int i = 0; i < 4; ++i)
         {
-            // separate channel bytes
-            const uint8* sp = src + i;
-            const uint8* we = wrk.data() + wrkSize;
-            for (uint8* wp = wrk.data(); wp < we; ++wp, sp += 4) *wp = *sp;
-
             // encode
-            size_t size = encoder.encode(wrkBlock, dst.data());
+            size_t size = util::PackBits::encode(planes[i], wrkSize, dst.get());
 
             // line length
             mOut.write((uint32)size);
             // compressed bytes
-            mOut.writeBytes(XCMemBlock(dst.data(), size), 1);
+            mOut.writeBytes(XCMemBlock(dst.get(), size), 1);
         }
         src += w * 4;
     }
@@ -9,6 +9,7 @@
 #include <QRectF>
 #include <QMatrix4x4>
 #include <QPolygonF>
+#include <QHash>
 #include <QGL>
 #include "XC.h"
 #include "util/Segment2D.h"
@@ -32,6 +33,7 @@ public:
 
     void write(bool aValue);
     void write(int aValue);
+    void write(uint64 aValue);
     void write(float aValue);
     void write(const QPoint& aValue);
     void write(const QVector2D& aValue);
@@ -56,6 +58,8 @@ public:
     void writeGL(const gl::Vector3* aArray, int aCount);
 
     void writeID(const void* aData);
+    // write the id of aOrigin instead of aData's one. (for copies of objects)
+    void setAlias(const void* aData, const void* aOrigin);
     void writeImage(const XCMemBlock& aImage, const QSize& aSize);
     void writeFixedString(const QString& aValue, int aSize);
 
@@ -77,6 +81,7 @@ public:
 private:
     util::StreamWriter& mOut;
     util::IDAssigner<const void*> mIDAssigner;
+    QHash<const void*, const void*> mAliases;
 };
 
 } // namespace core
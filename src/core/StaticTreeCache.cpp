@@ -0,0 +1,230 @@
+#include <array>
+#include <utility>
+#include "gl/Global.h"
+#include "gl/Util.h"
+#include "core/StaticTreeCache.h"
+
+namespace
+{
+static const int kAttachmentId = 0;
+}
+
+namespace core
+{
+
+//-------------------------------------------------------------------------------------------------
+StaticTreeCache::Slot::Slot()
+    : framebuffer()
+    , texture()
+    , camera()
+    , isValid(false)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+StaticTreeCache::StaticTreeCache()
+    : mSlots()
+    , mShader()
+    , mIndices()
+{
+}
+
+void StaticTreeCache::rearrange(const std::vector<int>& aPrevSlots)
+{
+    const int prevCount = (int)mSlots.size();
+    std::vector<std::unique_ptr<Slot>> slots(aPrevSlots.size());
+
+    for (size_t i = 0; i < aPrevSlots.size(); ++i)
+    {
+        const int prev = aPrevSlots[i];
+        if (0 <= prev && prev < prevCount && mSlots[prev])
+        {
+            slots[i] = std::move(mSlots[prev]);
+        }
+    }
+
+    // textures are kept for reuse
+    int remaining = 0;
+    for (auto& slot : slots)
+    {
+        if (slot) continue;
+
+        while (remaining < prevCount && !mSlots[remaining]) ++remaining;
+        if (remaining < prevCount)
+        {
+            slot = std::move(mSlots[remaining]);
+        }
+        else
+        {
+            slot.reset(new Slot());
+        }
+        slot->isValid = false;
+    }
+    mSlots.swap(slots);
+}
+
+void StaticTreeCache::invalidate()
+{
+    for (auto& slot : mSlots)
+    {
+        slot->isValid = false;
+    }
+}
+
+void StaticTreeCache::invalidate(int aSlot)
+{
+    mSlots.at(aSlot)->isValid = false;
+}
+
+bool StaticTreeCache::isSameView(const CameraInfo& aLhs, const CameraInfo& aRhs)
+{
+    return aLhs.deviceScreenSize() == aRhs.deviceScreenSize() &&
+            aLhs.screenSize() == aRhs.screenSize() &&
+            aLhs.imageSize() == aRhs.imageSize() &&
+            aLhs.center() == aRhs.center() &&
+            aLhs.scale() == aRhs.scale() &&
+            aLhs.rotate() == aRhs.rotate();
+}
+
+bool StaticTreeCache::isValid(int aSlot, const CameraInfo& aCamera) const
+{
+    const Slot& slot = *mSlots.at(aSlot);
+    return slot.isValid && isSameView(slot.camera, aCamera);
+}
+
+GLuint StaticTreeCache::beginCapture(int aSlot, const CameraInfo& aCamera)
+{
+    Slot& slot = *mSlots.at(aSlot);
+    const QSize size = aCamera.deviceScreenSize();
+
+    // resize as necessary
+    if (!slot.texture || slot.texture->size() != size)
+    {
+        slot.framebuffer.reset();
+        slot.texture.reset(new gl::Texture());
+        slot.texture->create(size);
+        slot.texture->setFilter(GL_NEAREST);
+        slot.texture->setWrap(GL_CLAMP_TO_EDGE);
+
+        slot.framebuffer.reset(new gl::Framebuffer());
+        slot.framebuffer->setColorAttachment(kAttachmentId, slot.texture->id());
+        XC_ASSERT(slot.framebuffer->isComplete());
+    }
+
+    auto& ggl = gl::Global::functions();
+    slot.framebuffer->bind();
+
+    const GLenum attachments[] = { GL_COLOR_ATTACHMENT0 };
+    ggl.glDrawBuffers(1, attachments);
+
+    gl::Util::resetRenderState();
+    gl::Util::clearColorBuffer(0.0f, 0.0f, 0.0f, 0.0f);
+
+    slot.camera = aCamera;
+    slot.isValid = false;
+    return slot.framebuffer->id();
+}
+
+void StaticTreeCache::endCapture(int aSlot, GLuint aFramebuffer)
+{
+    Slot& slot = *mSlots.at(aSlot);
+    slot.framebuffer->release();
+    slot.isValid = true;
+
+    // bind the destination again
+    gl::Global::functions().glBindFramebuffer(GL_FRAMEBUFFER, aFramebuffer);
+}
+
+GLuint StaticTreeCache::texture(int aSlot) const
+{
+    const Slot& slot = *mSlots.at(aSlot);
+    return slot.texture ? slot.texture->id() : 0;
+}
+
+void StaticTreeCache::composite(int aSlot)
+{
+    const Slot& slot = *mSlots.at(aSlot);
+    if (!slot.isValid || !slot.texture) return;
+
+    if (!mIndices)
+    {
+        createShader();
+    }
+
+    std::array<gl::Vector2, 4> positions;
+    positions[0].set(-1.0f, -1.0f);
+    positions[1].set(-1.0f,  1.0f);
+    positions[2].set( 1.0f,  1.0f);
+    positions[3].set( 1.0f, -1.0f);
+
+    std::array<gl::Vector2, 4> texCoords;
+    texCoords[0].set(0.0f, 0.0f);
+    texCoords[1].set(0.0f, 1.0f);
+    texCoords[2].set(1.0f, 1.0f);
+    texCoords[3].set(1.0f, 0.0f);
+
+    auto& ggl = gl::Global::functions();
+    gl::Util::resetRenderState();
+
+    // the texture has premultiplied colors
+    ggl.glEnable(GL_BLEND);
+    ggl.glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+
+    ggl.glActiveTexture(GL_TEXTURE0);
+    ggl.glBindTexture(GL_TEXTURE_2D, slot.texture->id());
+    {
+        mShader.bind();
+        mShader.setAttributeArray("inPosition", positions.data(), 4);
+        mShader.setAttributeArray("inTexCoord", texCoords.data(), 4);
+        mShader.setUniformValue("uTexture0", 0);
+        gl::Util::drawElements(GL_TRIANGLE_STRIP, GL_UNSIGNED_INT, *mIndices);
+        mShader.release();
+    }
+    ggl.glBindTexture(GL_TEXTURE_2D, 0);
+    ggl.glDisable(GL_BLEND);
+
+    GL_CHECK_ERROR();
+}
+
+void StaticTreeCache::createShader()
+{
+    static const char* kVertexShaderText =
+            "#version 330 \n"
+            "in vec2 inPosition;"
+            "in vec2 inTexCoord;"
+            "out vec2 vTexCoord;"
+            "void main(void){"
+            "  gl_Position = vec4(inPosition, 0.0, 1.0);"
+            "  vTexCoord = inTexCoord;"
+            "}";
+    static const char* kFragmentShaderText =
+            "#version 330 \n"
+            "uniform sampler2D uTexture0;"
+            "in vec2 vTexCoord;"
+            "layout(location = 0, index = 0) out vec4 oFragColor;"
+            "void main(void){"
+            "  oFragColor = texture(uTexture0, vTexCoord);"
+            "}";
+
+    if (!mShader.setVertexSource(QString(kVertexShaderText)))
+    {
+        XC_FATAL_ERROR("OpenGL Error", "Failed to compile vertex shader.",
+                       mShader.log());
+    }
+    if (!mShader.setFragmentSource(QString(kFragmentShaderText)))
+    {
+        XC_FATAL_ERROR("OpenGL Error", "Failed to compile fragment shader.",
+                       mShader.log());
+    }
+    if (!mShader.link())
+    {
+        XC_FATAL_ERROR("OpenGL Error", "Failed to link shader.",
+                       mShader.log());
+    }
+
+    static const GLuint kIndices[4] = { 0, 1, 3, 2 };
+    mIndices.reset(new gl::BufferObject(GL_ELEMENT_ARRAY_BUFFER));
+    mIndices->resetData(4, GL_STATIC_DRAW, kIndices);
+}
+
+} // namespace core
@@ -0,0 +1,60 @@
+#ifndef CORE_STATICTREECACHE_H
+#define CORE_STATICTREECACHE_H
+
+#include <memory>
+#include <vector>
+#include <QScopedPointer>
+#include "util/NonCopyable.h"
+#include "gl/Framebuffer.h"
+#include "gl/Texture.h"
+#include "gl/BufferObject.h"
+#include "gl/EasyShaderProgram.h"
+#include "core/CameraInfo.h"
+
+namespace core
+{
+
+// screen sized textures which hold flattened static subtrees
+// A slot is captured with premultiplied alpha, and composited by one quad.
+class StaticTreeCache : private util::NonCopyable
+{
+public:
+    StaticTreeCache();
+
+    // aPrevSlots[i] is the previous index of the slot i, or -1 for a new one.
+    // the moved slots stay valid, and the new ones reuse remaining textures.
+    void rearrange(const std::vector<int>& aPrevSlots);
+    int slotCount() const { return (int)mSlots.size(); }
+    void invalidate();
+    void invalidate(int aSlot);
+
+    bool isValid(int aSlot, const CameraInfo& aCamera) const;
+
+    // render the subtree into the returned framebuffer between them
+    GLuint beginCapture(int aSlot, const CameraInfo& aCamera);
+    void endCapture(int aSlot, GLuint aFramebuffer);
+    GLuint texture(int aSlot) const;
+
+    void composite(int aSlot);
+
+private:
+    struct Slot
+    {
+        Slot();
+        QScopedPointer<gl::Framebuffer> framebuffer;
+        QScopedPointer<gl::Texture> texture;
+        CameraInfo camera;
+        bool isValid;
+    };
+
+    static bool isSameView(const CameraInfo& aLhs, const CameraInfo& aRhs);
+    void createShader();
+
+    std::vector<std::unique_ptr<Slot>> mSlots;
+    gl::EasyShaderProgram mShader;
+    QScopedPointer<gl::BufferObject> mIndices;
+};
+
+} // namespace core
+
+#endif // CORE_STATICTREECACHE_H
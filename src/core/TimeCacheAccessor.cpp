@@ -1,58 +1,74 @@
 #include "core/TimeCacheAccessor.h"
 #include "core/TimeKeyBlender.h"
 #include "core/ObjectNode.h"
-#include "core/TimeCacheLock.h"
+#include "core/ObjectTree.h"
+#include "core/TimeCacheEpoch.h"
 #include "core/TimeKeyExpans.h"
 
 namespace core
 {
 
 TimeCacheAccessor::TimeCacheAccessor(
-        ObjectNode& aRootNode, TimeCacheLock& aLock,
+        ObjectTree& aTree, ObjectNode& aRootNode,
         const TimeInfo& aTime, bool aUseWorking)
-    : mLockRef(aUseWorking ? aLock.working : aLock.current)
+    : mEpochRef(aTree.timeCacheEpoch())
     , mUseWorking(aUseWorking)
+    , mEpoch(0)
 {
     TimeLine* timeLine = aRootNode.timeLine();
-    TimeKeyExpans* expans = nullptr;
-    if (timeLine)
+
+    if (mUseWorking)
     {
-        expans = aUseWorking ? &(timeLine->working()) : &(timeLine->current());
+        mEpochRef.working.lock();
+
+        if (!timeLine || !timeLine->working().hasMasterCache(aTime.frame))
+        {
+            TimeKeyBlender blender(aRootNode, true, nullptr, &aTree.timeCacheArena(true));
+            blender.updateCurrents(&aRootNode, aTime);
+        }
+        return;
     }
 
-    mLockRef.lockForRead();
+    mEpoch = mEpochRef.pin();
 
-    if (!timeLine || !expans->hasMasterCache(aTime.frame))
+    if (!timeLine || !timeLine->current(mEpoch).hasMasterCache(aTime.frame))
     {
-        mLockRef.unlock();
-        mLockRef.lockForWrite();
+        // an evaluator may wait for my epoch
+        mEpochRef.unpin(mEpoch);
 
-        TimeKeyBlender blender(aRootNode, aUseWorking);
+        TimeKeyBlender blender(aRootNode, false, &mEpochRef, &aTree.timeCacheArena(false));
         blender.updateCurrents(&aRootNode, aTime);
+
+        mEpoch = mEpochRef.pin();
     }
 }
 
 TimeCacheAccessor::~TimeCacheAccessor()
 {
-    mLockRef.unlock();
+    if (mUseWorking)
+    {
+        mEpochRef.working.unlock();
+    }
+    else
+    {
+        mEpochRef.unpin(mEpoch);
+    }
 }
 
 const TimeKeyExpans& TimeCacheAccessor::get(const ObjectNode& aNode) const
 {
     XC_PTR_ASSERT(aNode.timeLine());
-    return mUseWorking ?
-                aNode.timeLine()->working() :
-                aNode.timeLine()->current();
+    return get(*aNode.timeLine());
 }
 
 const TimeKeyExpans& TimeCacheAccessor::get(const TimeLine& aLine) const
 {
-    return mUseWorking ? aLine.working() : aLine.current();
+    return mUseWorking ? aLine.working() : aLine.current(mEpoch);
 }
 
 TimeKeyExpans& TimeCacheAccessor::get(TimeLine& aLine) const
 {
-    return mUseWorking ? aLine.working() : aLine.current();
+    return mUseWorking ? aLine.working() : aLine.current(mEpoch);
 }
 
 } // namespace core
@@ -1,24 +1,29 @@
 #ifndef CORE_TIMECACHEACCESSOR_H
 #define CORE_TIMECACHEACCESSOR_H
 
-#include <QReadWriteLock>
+#include "XC.h"
+namespace core { class ObjectTree; }
 namespace core { class ObjectNode; }
 namespace core { class TimeLine; }
 namespace core { class TimeInfo; }
-namespace core { class TimeCacheLock; }
+namespace core { class TimeCacheEpoch; }
 namespace core { class TimeKeyExpans; }
 
 namespace core
 {
 
+// an accessor of the current caches pins a published epoch, and reads it without locking.
+// an accessor of the working caches locks them while living.
 class TimeCacheAccessor
 {
-    QReadWriteLock& mLockRef;
+    TimeCacheEpoch& mEpochRef;
     bool mUseWorking;
+    uint64 mEpoch;
 
 public:
+    // aRootNode is evaluated with the epoch and the arena of aTree if need.
     TimeCacheAccessor(
-            ObjectNode& aRootNode, TimeCacheLock& aLock,
+            ObjectTree& aTree, ObjectNode& aRootNode,
             const TimeInfo& aTime, bool aUseWorking);
     ~TimeCacheAccessor();
     const TimeKeyExpans& get(const ObjectNode& aNode) const;
@@ -0,0 +1,93 @@
+#include "core/TimeCacheArena.h"
+#include "core/TimeKeyExpans.h"
+
+namespace core
+{
+
+TimeCacheArena::TimeCacheArena()
+    : mNodes()
+    , mExpans()
+    , mParents()
+    , mWorldMatrices()
+    , mLocalOpacities()
+    , mWorldOpacities()
+    , mLocalDepths()
+    , mWorldDepths()
+{
+}
+
+void TimeCacheArena::clear()
+{
+    // keep capacities for the next evaluation
+    mNodes.clear();
+    mExpans.clear();
+    mParents.clear();
+    mWorldMatrices.clear();
+    mLocalOpacities.clear();
+    mWorldOpacities.clear();
+    mLocalDepths.clear();
+    mWorldDepths.clear();
+}
+
+int TimeCacheArena::push(ObjectNode& aNode, TimeKeyExpans& aExpans, int aParent)
+{
+    const int index = count();
+    XC_ASSERT(aParent < index);
+
+    mNodes.push_back(&aNode);
+    mExpans.push_back(&aExpans);
+    mParents.push_back(aParent);
+    mWorldMatrices.push_back(QMatrix4x4());
+    mLocalOpacities.push_back(1.0f);
+    mWorldOpacities.push_back(1.0f);
+    mLocalDepths.push_back(0.0f);
+    mWorldDepths.push_back(0.0f);
+    return index;
+}
+
+void TimeCacheArena::setOpacity(int aIndex, float aLocal, float aBase)
+{
+    mLocalOpacities[aIndex] = aLocal;
+    mWorldOpacities[aIndex] = aBase;
+}
+
+void TimeCacheArena::setDepth(int aIndex, float aLocal, float aBase)
+{
+    mLocalDepths[aIndex] = aLocal;
+    mWorldDepths[aIndex] = aBase;
+}
+
+void TimeCacheArena::resolveWorlds()
+{
+    const int size = count();
+    const int* parents = mParents.data();
+
+    // a world value of a root holds its base until here
+    {
+        const float* local = mLocalOpacities.data();
+        float* world = mWorldOpacities.data();
+        for (int i = 0; i < size; ++i)
+        {
+            const int p = parents[i];
+            world[i] = (p >= 0 ? world[p] : world[i]) * local[i];
+        }
+    }
+    {
+        const float* local = mLocalDepths.data();
+        float* world = mWorldDepths.data();
+        for (int i = 0; i < size; ++i)
+        {
+            const int p = parents[i];
+            world[i] = (p >= 0 ? world[p] : world[i]) + local[i];
+        }
+    }
+
+    // write to the views
+    for (int i = 0; i < size; ++i)
+    {
+        mExpans[i]->setWorldOpacity(mWorldOpacities[i]);
+        mExpans[i]->setWorldDepth(mWorldDepths[i]);
+    }
+}
+
+} // namespace core
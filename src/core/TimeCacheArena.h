@@ -0,0 +1,56 @@
+#ifndef CORE_TIMECACHEARENA_H
+#define CORE_TIMECACHEARENA_H
+
+#include <vector>
+#include <QMatrix4x4>
+#include "XC.h"
+namespace core { class ObjectNode; }
+namespace core { class TimeKeyExpans; }
+
+namespace core
+{
+
+// hot evaluated states of a tree in structure of arrays.
+// nodes are indexed in pre-order, so that a parent always precedes its children.
+// the time key expans of each node are the views of the results.
+class TimeCacheArena
+{
+public:
+    TimeCacheArena();
+
+    void clear();
+
+    // aParent is the index of the nearest ancestor in the arena, or -1.
+    int push(ObjectNode& aNode, TimeKeyExpans& aExpans, int aParent);
+
+    int count() const { return (int)mNodes.size(); }
+    ObjectNode& node(int aIndex) const { return *mNodes[aIndex]; }
+    TimeKeyExpans& expans(int aIndex) const { return *mExpans[aIndex]; }
+    int parent(int aIndex) const { return mParents[aIndex]; }
+
+    void setWorldMatrix(int aIndex, const QMatrix4x4& aMtx) { mWorldMatrices[aIndex] = aMtx; }
+    const QMatrix4x4& worldMatrix(int aIndex) const { return mWorldMatrices[aIndex]; }
+
+    // a root takes aBase from the ancestor out of the arena
+    void setOpacity(int aIndex, float aLocal, float aBase = 1.0f);
+    void setDepth(int aIndex, float aLocal, float aBase = 0.0f);
+    float worldOpacity(int aIndex) const { return mWorldOpacities[aIndex]; }
+    float worldDepth(int aIndex) const { return mWorldDepths[aIndex]; }
+
+    // resolve world opacities and depths of all nodes, and write them to the views.
+    void resolveWorlds();
+
+private:
+    std::vector<ObjectNode*> mNodes;
+    std::vector<TimeKeyExpans*> mExpans;
+    std::vector<int> mParents;
+    std::vector<QMatrix4x4> mWorldMatrices;
+    std::vector<float> mLocalOpacities;
+    std::vector<float> mWorldOpacities;
+    std::vector<float> mLocalDepths;
+    std::vector<float> mWorldDepths;
+};
+
+} // namespace core
+
+#endif // CORE_TIMECACHEARENA_H
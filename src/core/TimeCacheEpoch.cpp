@@ -0,0 +1,80 @@
+#include "core/TimeCacheEpoch.h"
+
+namespace core
+{
+
+TimeCacheEpoch::TimeCacheEpoch()
+    : working()
+    , mPublished(0)
+    , mReaders()
+    , mWriting()
+    , mIsWaiting(false)
+    , mWaitLock()
+    , mWaitCondition()
+{
+    mReaders[0] = 0;
+    mReaders[1] = 0;
+}
+
+uint64 TimeCacheEpoch::published() const
+{
+    return mPublished.load();
+}
+
+uint64 TimeCacheEpoch::pin() const
+{
+    while (true)
+    {
+        const uint64 epoch = mPublished.load();
+        mReaders[epoch & 1].fetch_add(1);
+
+        // retry if an evaluator published a new epoch before the counting
+        if (mPublished.load() == epoch)
+        {
+            return epoch;
+        }
+        unpin(epoch);
+    }
+}
+
+void TimeCacheEpoch::unpin(uint64 aEpoch) const
+{
+    const int prev = mReaders[aEpoch & 1].fetch_sub(1);
+    XC_ASSERT(prev > 0);
+
+    // the last reader wakes a waiting evaluator
+    if (prev == 1 && mIsWaiting.load())
+    {
+        QMutexLocker locker(&mWaitLock);
+        mWaitCondition.wakeAll();
+    }
+}
+
+uint64 TimeCacheEpoch::beginWriting()
+{
+    mWriting.lock();
+    const uint64 epoch = mPublished.load() + 1;
+
+    // readers of (epoch - 2) may see the back buffers.
+    // (older readers were already waited by the previous evaluator)
+    if (mReaders[epoch & 1].load() > 0)
+    {
+        QMutexLocker locker(&mWaitLock);
+        mIsWaiting.store(true);
+        while (mReaders[epoch & 1].load() > 0)
+        {
+            mWaitCondition.wait(&mWaitLock);
+        }
+        mIsWaiting.store(false);
+    }
+    return epoch;
+}
+
+void TimeCacheEpoch::endWriting(uint64 aEpoch)
+{
+    XC_ASSERT(aEpoch == mPublished.load() + 1);
+    mPublished.store(aEpoch);
+    mWriting.unlock();
+}
+
+} // namespace core
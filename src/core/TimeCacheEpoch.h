@@ -0,0 +1,48 @@
+#ifndef CORE_TIMECACHEEPOCH_H
+#define CORE_TIMECACHEEPOCH_H
+
+#include <array>
+#include <atomic>
+#include <QMutex>
+#include <QWaitCondition>
+#include "XC.h"
+#include "util/NonCopyable.h"
+
+namespace core
+{
+
+// versions of the current time caches.
+// an evaluator writes back buffers of time lines and publishes them as a new epoch,
+// and a reader pins a published epoch and reads the buffers of it without locking.
+// evaluators are serialized, and an evaluator waits only for the readers which
+// still see the buffers to be overwritten.
+class TimeCacheEpoch : private util::NonCopyable
+{
+public:
+    TimeCacheEpoch();
+
+    uint64 published() const;
+
+    // a reader never blocks
+    uint64 pin() const;
+    void unpin(uint64 aEpoch) const;
+
+    // returns the epoch which is going to be published
+    uint64 beginWriting();
+    void endWriting(uint64 aEpoch);
+
+    // the working caches are a scratch space for a single evaluator
+    QMutex working;
+
+private:
+    std::atomic<uint64> mPublished;
+    mutable std::array<std::atomic<int>, 2> mReaders;
+    QMutex mWriting;
+    std::atomic<bool> mIsWaiting;
+    mutable QMutex mWaitLock;
+    mutable QWaitCondition mWaitCondition;
+};
+
+} // namespace core
+
+#endif // CORE_TIMECACHEEPOCH_H
@@ -1,12 +0,0 @@
-#include "core/TimeCacheLock.h"
-
-namespace core
-{
-
-TimeCacheLock::TimeCacheLock()
-    : working()
-    , current()
-{
-}
-
-} // namespace core
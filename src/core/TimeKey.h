@@ -45,6 +45,9 @@ public:
     void setSelect(util::LifeLink& aLink) { mSelect = aLink; }
 
     virtual TimeKey* createClone() = 0;
+    // an unchanging copy which is serialized on another thread
+    // while this key is being edited. it never draws anything.
+    virtual TimeKey* createSnapshot() const = 0;
 
     virtual bool serialize(Serializer& aOut) const = 0;
     virtual bool deserialize(Deserializer& aIn) = 0;
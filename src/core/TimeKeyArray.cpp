@@ -0,0 +1,93 @@
+#include "core/TimeKeyArray.h"
+
+namespace core
+{
+
+TimeKeyArray::TimeKeyArray()
+    : mFrames()
+    , mKeys()
+    , mCursor(0)
+{
+}
+
+void TimeKeyArray::assign(const QMap<int, TimeKey*>& aMap)
+{
+    mFrames.clear();
+    mKeys.clear();
+    mFrames.reserve(aMap.size());
+    mKeys.reserve(aMap.size());
+
+    for (auto itr = aMap.begin(); itr != aMap.end(); ++itr)
+    {
+        mFrames.push_back(itr.key());
+        mKeys.push_back(itr.value());
+    }
+    mCursor.store(0, std::memory_order_relaxed);
+}
+
+void TimeKeyArray::clear()
+{
+    mFrames.clear();
+    mKeys.clear();
+    mCursor.store(0, std::memory_order_relaxed);
+}
+
+bool TimeKeyArray::isUpperBound(int aIndex, int aFrame) const
+{
+    const int count = size();
+    return (aIndex == 0 || mFrames[aIndex - 1] <= aFrame) &&
+            (aIndex == count || aFrame < mFrames[aIndex]);
+}
+
+int TimeKeyArray::upperBound(int aFrame) const
+{
+    const int count = size();
+    int index = mCursor.load(std::memory_order_relaxed);
+
+    // same span, or the next span (forward playback)
+    if (index > count || !isUpperBound(index, aFrame))
+    {
+        if (index < count && isUpperBound(index + 1, aFrame))
+        {
+            ++index;
+        }
+        else
+        {
+            index = searchUpperBound(aFrame);
+        }
+        mCursor.store(index, std::memory_order_relaxed);
+    }
+    return index;
+}
+
+int TimeKeyArray::searchUpperBound(int aFrame) const
+{
+    const int count = size();
+    if (count == 0) return 0;
+
+    // the loop body is compiled into conditional moves
+    const int* first = mFrames.data();
+    const int* base = first;
+    int length = count;
+    while (length > 1)
+    {
+        const int half = length / 2;
+        base = (base[half] <= aFrame) ? base + half : base;
+        length -= half;
+    }
+    return (int)(base - first) + (*base <= aFrame ? 1 : 0);
+}
+
+int TimeKeyArray::find(int aFrame) const
+{
+    const int index = upperBound(aFrame) - 1;
+    return (index >= 0 && mFrames[index] == aFrame) ? index : -1;
+}
+
+TimeKey* TimeKeyArray::findLast(int aFrame) const
+{
+    const int index = upperBound(aFrame) - 1;
+    return index >= 0 ? mKeys[index] : nullptr;
+}
+
+} // namespace core
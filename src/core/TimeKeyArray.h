@@ -0,0 +1,51 @@
+#ifndef CORE_TIMEKEYARRAY_H
+#define CORE_TIMEKEYARRAY_H
+
+#include <vector>
+#include <atomic>
+#include <QMap>
+#include "XC.h"
+namespace core { class TimeKey; }
+
+namespace core
+{
+
+// a flat sorted copy of the keys of a time line
+// Lookups remember the last position, so sequential playback is
+// amortized O(1) and random access is a branch-light binary search.
+class TimeKeyArray
+{
+public:
+    TimeKeyArray();
+
+    void assign(const QMap<int, TimeKey*>& aMap);
+    void clear();
+
+    int size() const { return (int)mFrames.size(); }
+    bool isEmpty() const { return mFrames.empty(); }
+    int frame(int aIndex) const { return mFrames[aIndex]; }
+    TimeKey* key(int aIndex) const { return mKeys[aIndex]; }
+
+    // the index of the first key whose frame is greater than aFrame
+    int upperBound(int aFrame) const;
+    // the index of the key on aFrame, or -1
+    int find(int aFrame) const;
+    // the key on aFrame or the last key before aFrame
+    TimeKey* findLast(int aFrame) const;
+
+private:
+    TimeKeyArray(const TimeKeyArray&);
+    TimeKeyArray& operator=(const TimeKeyArray&);
+
+    bool isUpperBound(int aIndex, int aFrame) const;
+    int searchUpperBound(int aFrame) const;
+
+    std::vector<int> mFrames;
+    std::vector<TimeKey*> mKeys;
+    ///@note hint of the last result. it's shared by evaluating threads.
+    mutable std::atomic<int> mCursor;
+};
+
+} // namespace core
+
+#endif // CORE_TIMEKEYARRAY_H
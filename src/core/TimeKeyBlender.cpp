@@ -1,6 +1,6 @@
 #include "util/TreeIterator.h"
-#include "util/TreeSeekIterator.h"
 #include "util/MathUtil.h"
+#include "gl/Profiler.h"
 #include "core/TimeKeyExpans.h"
 #include "core/TimeKeyBlender.h"
 #include "core/LayerMesh.h"
@@ -34,7 +34,7 @@ public:
             data.objNode = node;
             data.expans = mUseCache ?
                         &(node->timeLine()->working()) :
-                        &(node->timeLine()->current());
+                        &(node->timeLine()->evaluating());
             return data;
         }
         return data;
@@ -158,8 +158,8 @@ BoneKey* TimeKeyBlender::getAreaBone(
 {
     if (aNode.timeLine())
     {
-        auto& map = aNode.timeLine()->map(TimeKeyType_Bone);
-        TimeKey* key = TimeKeyGatherer::findLastKey(map, aTime.frame);
+        auto& keys = aNode.timeLine()->keys(TimeKeyType_Bone);
+        TimeKey* key = TimeKeyGatherer::findLastKey(keys, aTime.frame);
         if (key)
         {
             TIMEKEY_PTR_TYPE_ASSERT(key, Bone);
@@ -212,16 +212,25 @@ QVector2D TimeKeyBlender::getCentroid(const ObjectNode& aNode, const TimeInfo& a
 TimeKeyBlender::TimeKeyBlender(ObjectTree& aTree)
     : mSeeker()
     , mRoot()
+    , mEpoch(&aTree.timeCacheEpoch())
+    , mLocalArena()
+    , mArena(&aTree.timeCacheArena(false))
 {
     static ObjectTreeSeeker sSeeker(false);
     mSeeker = &sSeeker;
     mRoot = sSeeker.position(aTree.topNode());
 }
 
-TimeKeyBlender::TimeKeyBlender(ObjectNode& aRootNode, bool aUseWorking)
+TimeKeyBlender::TimeKeyBlender(
+        ObjectNode& aRootNode, bool aUseWorking,
+        TimeCacheEpoch* aEpoch, TimeCacheArena* aArena)
     : mSeeker()
     , mRoot()
+    , mEpoch(aUseWorking ? nullptr : aEpoch)
+    , mLocalArena()
+    , mArena(aArena ? aArena : &mLocalArena)
 {
+    XC_ASSERT(aUseWorking || aEpoch);
     if (aUseWorking)
     {
         static ObjectTreeSeeker sSeeker(true);
@@ -239,44 +248,77 @@ TimeKeyBlender::TimeKeyBlender(ObjectNode& aRootNode, bool aUseWorking)
 TimeKeyBlender::TimeKeyBlender(SeekerType& aSeeker, PositionType aRoot)
     : mSeeker(&aSeeker)
     , mRoot(aRoot)
+    , mEpoch()
+    , mLocalArena()
+    , mArena(&mLocalArena)
 {
 }
 
 void TimeKeyBlender::updateCurrents(ObjectNode* aRootNode, const TimeInfo& aTime)
 {
-    {
-        util::TreeSeekIterator<SeekData, ObjectNode*> itr(*mSeeker, mRoot);
+    gl::ProfileScope profile("pipeline", "TimeKeyBlender");
 
-        while (itr.hasNext())
-        {
-            auto pos = itr.next();
-            XC_ASSERT(pos);
+    // write back buffers of the current caches
+    const uint64 epoch = mEpoch ? mEpoch->beginWriting() : 0;
 
-            // build move, rotate and scale
-            blendSRTKeys(pos, aTime);
+    // gather the tree into the arena
+    mArena->clear();
+    gatherNodes(mRoot, -1);
+    const int count = mArena->count();
 
-            // build depth
-            blendDepthKey(pos, aTime);
+    // build move, rotate and scale
+    for (int i = 0; i < count; ++i)
+    {
+        auto& expans = mArena->expans(i);
+        blendLocalSRTKeys(expans, mArena->node(i), aTime);
 
-            // build opa
-            blendOpaKey(pos, aTime);
+        const int parent = mArena->parent(i);
+        expans.srt().setParentMatrix(parent >= 0 ?
+                    mArena->worldMatrix(parent) :
+                    getParentWorldMatrix(mSeeker->position(&mArena->node(i)), aTime));
+        mArena->setWorldMatrix(i, expans.srt().worldCSRTMatrix());
+    }
 
-            // build mesh
-            blendMeshKey(pos, aTime);
+    // build depth and opa
+    for (int i = 0; i < count; ++i)
+    {
+        auto& expans = mArena->expans(i);
+        blendLocalDepthKey(expans, mArena->node(i), aTime);
+        blendLocalOpaKey(expans, mArena->node(i), aTime);
 
-            // build image
-            blendImageKey(pos, aTime);
+        if (mArena->parent(i) >= 0)
+        {
+            mArena->setDepth(i, expans.depth());
+            mArena->setOpacity(i, expans.opa().opacity());
+        }
+        else
+        {
+            auto pos = mSeeker->position(&mArena->node(i));
+            mArena->setDepth(i, expans.depth(), getParentWorldDepth(pos, aTime));
+            mArena->setOpacity(i, expans.opa().opacity(), getParentWorldOpacity(pos, aTime));
+        }
+    }
+    mArena->resolveWorlds();
 
-            // build bone
-            blendBoneKey(pos, aTime);
+    // build keys which don't depend on parents
+    for (int i = 0; i < count; ++i)
+    {
+        auto pos = mSeeker->position(&mArena->node(i));
 
-            // build pose
-            blendPoseKey(pos, aTime);
+        // build mesh
+        blendMeshKey(pos, aTime);
 
-            // build ffd
-            blendFFDKey(pos, aTime);
+        // build image
+        blendImageKey(pos, aTime);
 
-        }
+        // build bone
+        blendBoneKey(pos, aTime);
+
+        // build pose
+        blendPoseKey(pos, aTime);
+
+        // build ffd
+        blendFFDKey(pos, aTime);
     }
 
     // build skeletal animation matrix
@@ -287,8 +329,7 @@ void TimeKeyBlender::updateCurrents(ObjectNode* aRootNode, const TimeInfo& aTime
         PosePalette::KeyPairs pairs;
         buildPosePalette(*aRootNode, pairs);
 #else
-        PosePalette::KeyPair pair = {};
-        buildPosePalette(*aRootNode, pair);
+        buildPosePalette(*aRootNode, nullptr);
 #endif
         // set map
         setBoneInfluenceMaps(*aRootNode, nullptr, aTime);
@@ -297,18 +338,21 @@ void TimeKeyBlender::updateCurrents(ObjectNode* aRootNode, const TimeInfo& aTime
     }
 
     // set master cache
+    for (int i = 0; i < count; ++i)
     {
-        util::TreeSeekIterator<SeekData, ObjectNode*> itr(*mSeeker, mRoot);
+        mArena->expans(i).setMasterCache(aTime.frame);
 
-        while (itr.hasNext())
+        if (mEpoch)
         {
-            auto pos = itr.next();
-            XC_ASSERT(pos);
-            auto expans = mSeeker->data(pos).expans;
-            if (!expans) continue;
-            expans->setMasterCache(aTime.frame);
+            mArena->node(i).timeLine()->publishEvaluating(epoch);
         }
     }
+
+    // readers see the new caches after here
+    if (mEpoch)
+    {
+        mEpoch->endWriting(epoch);
+    }
 }
 
 void TimeKeyBlender::clearCaches(TimeLineEvent& aEvent)
@@ -316,6 +360,7 @@ void TimeKeyBlender::clearCaches(TimeLineEvent& aEvent)
     for (TimeLineEvent::Target& target : aEvent.targets())
     {
         target.pos.line()->current().clearCaches();
+        target.pos.line()->evaluating().clearCaches();
         target.pos.line()->working().clearCaches();
 
         // clear master caches of parents
@@ -327,6 +372,7 @@ void TimeKeyBlender::clearCaches(TimeLineEvent& aEvent)
             if (pline)
             {
                 pline->current().clearMasterCache();
+                pline->evaluating().clearMasterCache();
                 pline->working().clearMasterCache();
             }
             parent = parent->parent();
@@ -345,6 +391,7 @@ void TimeKeyBlender::clearCaches(ObjectNode* aRootNode)
         if (node->timeLine())
         {
             node->timeLine()->current().clearCaches();
+            node->timeLine()->evaluating().clearCaches();
             node->timeLine()->working().clearCaches();
         }
     }
@@ -359,6 +406,7 @@ void TimeKeyBlender::clearCaches(ObjectNode* aRootNode)
             if (pline)
             {
                 pline->current().clearMasterCache();
+                pline->evaluating().clearMasterCache();
                 pline->working().clearMasterCache();
             }
             parent = parent->parent();
@@ -383,6 +431,21 @@ float getEasingRateFromTwoKeys(const TimeKeyGatherer& aGatherer)
                 k0->data().easing(), -p0.relativeFrame, 0.0f, 1.0f, frame);
 }
 
+float TimeKeyBlender::getEasingRate(TimeKeyType aType, const TimeKeyGatherer& aGatherer)
+{
+    switch (aType)
+    {
+    case TimeKeyType_Move:   return getEasingRateFromTwoKeys<MoveKey>(aGatherer);
+    case TimeKeyType_Rotate: return getEasingRateFromTwoKeys<RotateKey>(aGatherer);
+    case TimeKeyType_Scale:  return getEasingRateFromTwoKeys<ScaleKey>(aGatherer);
+    case TimeKeyType_Depth:  return getEasingRateFromTwoKeys<DepthKey>(aGatherer);
+    case TimeKeyType_Opa:    return getEasingRateFromTwoKeys<OpaKey>(aGatherer);
+    case TimeKeyType_Pose:   return getEasingRateFromTwoKeys<PoseKey>(aGatherer);
+    case TimeKeyType_FFD:    return getEasingRateFromTwoKeys<FFDKey>(aGatherer);
+    default: XC_ASSERT(0); return 0.0f;
+    }
+}
+
 template<class tKey, TimeKeyType tType>
 typename tKey::Data getDefaultKeyData(const ObjectNode& aNode)
 {
@@ -394,10 +457,27 @@ typename tKey::Data getDefaultKeyData(const ObjectNode& aNode)
     return typename tKey::Data();
 }
 
+// blend rotations of two bone trees which have the same structure
+void blendBoneRotates(Bone2& aDst, const Bone2& aBone0, const Bone2& aBone1, float aRate)
+{
+    aDst.setRotate(aBone0.rotate() * (1.0f - aRate) + aBone1.rotate() * aRate);
+
+    auto itr0 = aBone0.children().begin();
+    auto itr1 = aBone1.children().begin();
+    for (auto child : aDst.children())
+    {
+        XC_ASSERT(itr0 != aBone0.children().end());
+        XC_ASSERT(itr1 != aBone1.children().end());
+        blendBoneRotates(*child, **itr0, **itr1, aRate);
+        ++itr0;
+        ++itr1;
+    }
+}
+
 void TimeKeyBlender::getMoveExpans(SRTExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
 {
     XC_ASSERT(aNode.timeLine());
-    TimeKeyGatherer blend(aNode.timeLine()->map(TimeKeyType_Move), aTime);
+    TimeKeyGatherer blend(aNode.timeLine()->keys(TimeKeyType_Move), aTime);
 
     if (blend.isEmpty())
     { // no key is exists
@@ -452,7 +532,7 @@ void TimeKeyBlender::getMoveExpans(SRTExpans& aExpans, const ObjectNode& aNode,
 void TimeKeyBlender::getRotateExpans(SRTExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
 {
     XC_ASSERT(aNode.timeLine());
-    TimeKeyGatherer blend(aNode.timeLine()->map(TimeKeyType_Rotate), aTime);
+    TimeKeyGatherer blend(aNode.timeLine()->keys(TimeKeyType_Rotate), aTime);
 
     if (blend.isEmpty())
     { // no key is exists
@@ -479,7 +559,7 @@ void TimeKeyBlender::getRotateExpans(SRTExpans& aExpans, const ObjectNode& aNode
 void TimeKeyBlender::getScaleExpans(SRTExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
 {
     XC_ASSERT(aNode.timeLine());
-    TimeKeyGatherer blend(aNode.timeLine()->map(TimeKeyType_Scale), aTime);
+    TimeKeyGatherer blend(aNode.timeLine()->keys(TimeKeyType_Scale), aTime);
 
     if (blend.isEmpty())
     { // no key is exists
@@ -503,82 +583,112 @@ void TimeKeyBlender::getScaleExpans(SRTExpans& aExpans, const ObjectNode& aNode,
     }
 }
 
+void TimeKeyBlender::gatherNodes(PositionType aPos, int aParent)
+{
+    auto seekData = mSeeker->data(aPos);
+    int index = aParent;
+    if (seekData.objNode && seekData.expans)
+    {
+        index = mArena->push(*seekData.objNode, *seekData.expans, aParent);
+    }
+
+    for (auto child = mSeeker->child(aPos); child; child = mSeeker->nextSib(child))
+    {
+        gatherNodes(child, index);
+    }
+}
+
 void TimeKeyBlender::blendSRTKeys(PositionType aPos, const TimeInfo& aTime)
 {
     auto seekData = mSeeker->data(aPos);
     if (!seekData.objNode || !seekData.expans) return;
-    auto& node = *seekData.objNode;
     auto& expans = *seekData.expans;
-    if (!node.timeLine()) return;
+    if (!seekData.objNode->timeLine()) return;
+
+    blendLocalSRTKeys(expans, *seekData.objNode, aTime);
+
+    // update matrix
+    expans.srt().setParentMatrix(getParentWorldMatrix(aPos, aTime));
+}
+
+void TimeKeyBlender::blendLocalSRTKeys(
+        TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
+{
     auto frame = aTime.frame;
 
-    expans.setKeyCache(TimeKeyType_Move, frame);
-    getMoveExpans(expans.srt(), node, aTime);
+    aExpans.setKeyCache(TimeKeyType_Move, frame);
+    getMoveExpans(aExpans.srt(), aNode, aTime);
 
-    expans.setKeyCache(TimeKeyType_Rotate, frame);
-    getRotateExpans(expans.srt(), node, aTime);
+    aExpans.setKeyCache(TimeKeyType_Rotate, frame);
+    getRotateExpans(aExpans.srt(), aNode, aTime);
 
-    expans.setKeyCache(TimeKeyType_Scale, frame);
-    getScaleExpans(expans.srt(), node, aTime);
+    aExpans.setKeyCache(TimeKeyType_Scale, frame);
+    getScaleExpans(aExpans.srt(), aNode, aTime);
+}
 
-    // update matrix
-    expans.srt().setParentMatrix(QMatrix4x4());
+QMatrix4x4 TimeKeyBlender::getParentWorldMatrix(PositionType aPos, const TimeInfo& aTime)
+{
+    auto frame = aTime.frame;
+    auto ppos = mSeeker->parent(aPos);
+    while (ppos)
     {
-        auto ppos = mSeeker->parent(aPos);
-        while (ppos)
+        auto pdata = mSeeker->data(ppos);
+        if (!pdata.expans)
         {
-            auto pdata = mSeeker->data(ppos);
-            if (!pdata.expans)
-            {
-                ppos = mSeeker->parent(ppos);
-                continue;
-            }
-
-            auto hasMoveCache = pdata.expans->hasKeyCache(TimeKeyType_Move, frame);
-            auto hasRotateCache = pdata.expans->hasKeyCache(TimeKeyType_Rotate, frame);
-            auto hasScaleCache = pdata.expans->hasKeyCache(TimeKeyType_Scale, frame);
+            ppos = mSeeker->parent(ppos);
+            continue;
+        }
 
-            if (!hasMoveCache || !hasRotateCache || !hasScaleCache)
-            {
-                blendSRTKeys(ppos, aTime);
-            }
+        auto hasMoveCache = pdata.expans->hasKeyCache(TimeKeyType_Move, frame);
+        auto hasRotateCache = pdata.expans->hasKeyCache(TimeKeyType_Rotate, frame);
+        auto hasScaleCache = pdata.expans->hasKeyCache(TimeKeyType_Scale, frame);
 
-            expans.srt().setParentMatrix(pdata.expans->srt().worldCSRTMatrix());
-            break;
+        if (!hasMoveCache || !hasRotateCache || !hasScaleCache)
+        {
+            blendSRTKeys(ppos, aTime);
         }
+        return pdata.expans->srt().worldCSRTMatrix();
     }
-
+    return QMatrix4x4();
 }
 
 void TimeKeyBlender::blendDepthKey(PositionType aPos, const TimeInfo& aTime)
 {
     auto seekData = mSeeker->data(aPos);
     if (!seekData.objNode || !seekData.expans) return;
-    auto& node = *seekData.objNode;
     auto& expans = *seekData.expans;
-    if (!node.timeLine()) return;
+    if (!seekData.objNode->timeLine()) return;
+
+    blendLocalDepthKey(expans, *seekData.objNode, aTime);
+
+    // sum depths of parents
+    expans.setWorldDepth(getParentWorldDepth(aPos, aTime) + expans.depth());
+}
 
+void TimeKeyBlender::blendLocalDepthKey(
+        TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
+{
     // set cache frame
-    expans.setKeyCache(TimeKeyType_Depth, aTime.frame);
+    aExpans.setKeyCache(TimeKeyType_Depth, aTime.frame);
 
     // get blend info
-    TimeKeyGatherer blend(node.timeLine()->map(TimeKeyType_Depth), aTime);
+    TimeKeyGatherer blend(aNode.timeLine()->keys(TimeKeyType_Depth), aTime);
 
     // no key is exists
     if (blend.isEmpty())
     {
-        auto defaultKey = (DepthKey*)node.timeLine()->defaultKey(TimeKeyType_Depth);
-        expans.setDepth(defaultKey ? defaultKey->depth() : DepthKey::Data().depth());
+        auto defaultKey = (const DepthKey*)aNode.timeLine()->defaultKey(TimeKeyType_Depth);
+        aExpans.setDepth(defaultKey ? defaultKey->depth() : DepthKey::Data().depth());
     }
     else if (blend.hasSameFrame())
     {
         // a key is exists
-        expans.setDepth(((const DepthKey*)blend.point(0).key)->depth());
+        aExpans.setDepth(((const DepthKey*)blend.point(0).key)->depth());
     }
     else if (blend.isSingle())
     {
         // perfect following
-        expans.setDepth(((const DepthKey*)blend.singlePoint().key)->depth());
+        aExpans.setDepth(((const DepthKey*)blend.singlePoint().key)->depth());
     }
     else
     {
@@ -587,57 +697,63 @@ void TimeKeyBlender::blendDepthKey(PositionType aPos, const TimeInfo& aTime)
         // calculate easing
         const float time = getEasingRateFromTwoKeys<DepthKey>(blend);
         // blend
-        expans.setDepth(k0->depth() * (1.0f - time) + k1->depth() * time);
+        aExpans.setDepth(k0->depth() * (1.0f - time) + k1->depth() * time);
     }
+}
 
-    // sum depths of parents
+float TimeKeyBlender::getParentWorldDepth(PositionType aPos, const TimeInfo& aTime)
+{
+    for (auto ppos = mSeeker->parent(aPos); ppos; ppos = mSeeker->parent(ppos))
     {
-        expans.setWorldDepth(expans.depth());
-        for (auto ppos = mSeeker->parent(aPos); ppos; ppos = mSeeker->parent(ppos))
+        auto pdata = mSeeker->data(ppos);
+        if (!pdata.expans) continue;
+        // check cache
+        if (!pdata.expans->hasKeyCache(TimeKeyType_Depth, aTime.frame))
         {
-            auto pdata = mSeeker->data(ppos);
-            if (!pdata.expans) continue;
-            // check cache
-            if (!pdata.expans->hasKeyCache(TimeKeyType_Depth, aTime.frame))
-            {
-                blendDepthKey(ppos, aTime);
-            }
-            // world depth
-            expans.setWorldDepth(pdata.expans->worldDepth() + expans.depth());
-            break;
+            blendDepthKey(ppos, aTime);
         }
+        return pdata.expans->worldDepth();
     }
+    return 0.0f;
 }
 
 void TimeKeyBlender::blendOpaKey(PositionType aPos, const TimeInfo& aTime)
 {
     auto seekData = mSeeker->data(aPos);
     if (!seekData.objNode || !seekData.expans) return;
-    auto& node = *seekData.objNode;
     auto& expans = *seekData.expans;
-    if (!node.timeLine()) return;
+    if (!seekData.objNode->timeLine()) return;
+
+    blendLocalOpaKey(expans, *seekData.objNode, aTime);
+
+    // multiply opacity of parents
+    expans.setWorldOpacity(getParentWorldOpacity(aPos, aTime) * expans.opa().opacity());
+}
 
+void TimeKeyBlender::blendLocalOpaKey(
+        TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime)
+{
     // set cache frame
-    expans.setKeyCache(TimeKeyType_Opa, aTime.frame);
+    aExpans.setKeyCache(TimeKeyType_Opa, aTime.frame);
 
     // get blend info
-    TimeKeyGatherer blend(node.timeLine()->map(TimeKeyType_Opa), aTime);
+    TimeKeyGatherer blend(aNode.timeLine()->keys(TimeKeyType_Opa), aTime);
 
     // no key is exists
     if (blend.isEmpty())
     {
-        auto defaultKey = (OpaKey*)node.timeLine()->defaultKey(TimeKeyType_Opa);
-        expans.opa() = defaultKey ? defaultKey->data() : OpaKey::Data();
+        auto defaultKey = (const OpaKey*)aNode.timeLine()->defaultKey(TimeKeyType_Opa);
+        aExpans.opa() = defaultKey ? defaultKey->data() : OpaKey::Data();
     }
     else if (blend.hasSameFrame())
     {
         // a key is exists
-        expans.opa() = ((const OpaKey*)blend.point(0).key)->data();
+        aExpans.opa() = ((const OpaKey*)blend.point(0).key)->data();
     }
     else if (blend.isSingle())
     {
         // perfect following
-        expans.opa() = ((const OpaKey*)blend.singlePoint().key)->data();
+        aExpans.opa() = ((const OpaKey*)blend.singlePoint().key)->data();
     }
     else
     {
@@ -646,28 +762,25 @@ void TimeKeyBlender::blendOpaKey(PositionType aPos, const TimeInfo& aTime)
         // calculate easing
         const float time = getEasingRateFromTwoKeys<OpaKey>(blend);
         // blend
-        expans.opa().setOpacity(k0->opacity() * (1.0f - time) + k1->opacity() * time);
+        aExpans.opa().setOpacity(k0->opacity() * (1.0f - time) + k1->opacity() * time);
     }
+}
 
-    // multiply opacity of parents
+float TimeKeyBlender::getParentWorldOpacity(PositionType aPos, const TimeInfo& aTime)
+{
+    for (auto ppos = mSeeker->parent(aPos); ppos; ppos = mSeeker->parent(ppos))
     {
-        expans.setWorldOpacity(expans.opa().opacity());
-        for (auto ppos = mSeeker->parent(aPos); ppos; ppos = mSeeker->parent(ppos))
+        // find a parent
+        auto pdata = mSeeker->data(ppos);
+        if (!pdata.expans) continue;
+        // check cache
+        if (!pdata.expans->hasKeyCache(TimeKeyType_Opa, aTime.frame))
         {
-            // find a parent
-            auto pdata = mSeeker->data(ppos);
-            if (!pdata.expans) continue;
-            // check cache
-            if (!pdata.expans->hasKeyCache(TimeKeyType_Opa, aTime.frame))
-            {
-                blendOpaKey(ppos, aTime);
-            }
-            // world opacity
-            expans.setWorldOpacity(
-                        pdata.expans->worldOpacity() * expans.opa().opacity());
-            break;
+            blendOpaKey(ppos, aTime);
         }
+        return pdata.expans->worldOpacity();
     }
+    return 1.0f;
 }
 
 void TimeKeyBlender::blendBoneKey(PositionType aPos, const TimeInfo& aTime)
@@ -715,7 +828,7 @@ void TimeKeyBlender::blendPoseKey(PositionType aPos, const TimeInfo& aTime)
 
     // get blend info
     TimeKeyGatherer blend(
-                node.timeLine()->map(TimeKeyType_Pose), aTime,
+                node.timeLine()->keys(TimeKeyType_Pose), aTime,
                 TimeKeyGatherer::ForceType_AssignedParent, areaBoneKey);
 
     // no key is exists
@@ -767,24 +880,10 @@ void TimeKeyBlender::blendPoseKey(PositionType aPos, const TimeInfo& aTime)
         {
             const Bone2* bone0 = key0->data().topBones().at(index);
             const Bone2* bone1 = key1->data().topBones().at(index);
+            blendBoneRotates(*bone, *bone0, *bone1, time);
 
-            Bone2::Iterator itr(bone);
-            Bone2::ConstIterator itr0(bone0);
-            Bone2::ConstIterator itr1(bone1);
-
-            while (itr.hasNext())
-            {
-                XC_ASSERT(itr0.hasNext());
-                XC_ASSERT(itr1.hasNext());
-
-                const float rotate =
-                        itr0.next()->rotate() * (1.0f - time) +
-                        itr1.next()->rotate() * time;
-
-                auto target = itr.next();
-                target->setRotate(rotate);
-                target->updateWorldTransform();
-            }
+            // update the whole tree at once
+            bone->updateWorldTransform();
             ++index;
         }
     }
@@ -806,8 +905,8 @@ void TimeKeyBlender::blendMeshKey(PositionType aPos, const TimeInfo& aTime)
 MeshKey* TimeKeyBlender::getMeshKey(const ObjectNode& aNode, const TimeInfo& aTime)
 {
     if (!aNode.timeLine()) return nullptr;
-    const TimeLine::MapType& map = aNode.timeLine()->map(TimeKeyType_Mesh);
-    return (MeshKey*)TimeKeyGatherer::findLastKey(map, aTime.frame);
+    const TimeKeyArray& keys = aNode.timeLine()->keys(TimeKeyType_Mesh);
+    return (MeshKey*)TimeKeyGatherer::findLastKey(keys, aTime.frame);
 }
 
 void TimeKeyBlender::blendFFDKey(PositionType aPos, const TimeInfo& aTime)
@@ -834,7 +933,7 @@ void TimeKeyBlender::blendFFDKey(PositionType aPos, const TimeInfo& aTime)
 
     // get blend info
     TimeKeyGatherer blend(
-                node.timeLine()->map(TimeKeyType_FFD), aTime,
+                node.timeLine()->keys(TimeKeyType_FFD), aTime,
                 TimeKeyGatherer::ForceType_AssignedParent, areaKey);
 
     // no key is exists
@@ -902,47 +1001,41 @@ void TimeKeyBlender::blendImageKey(PositionType aPos, const TimeInfo& aTime)
 ImageKey* TimeKeyBlender::getImageKey(const ObjectNode& aNode, const TimeInfo& aTime)
 {
     if (!aNode.timeLine()) return nullptr;
-    const TimeLine::MapType& map = aNode.timeLine()->map(TimeKeyType_Image);
-    auto imageKey = (ImageKey*)TimeKeyGatherer::findLastKey(map, aTime.frame);
+    const TimeKeyArray& keys = aNode.timeLine()->keys(TimeKeyType_Image);
+    auto imageKey = (ImageKey*)TimeKeyGatherer::findLastKey(keys, aTime.frame);
     return imageKey ? imageKey : (ImageKey*)aNode.timeLine()->defaultKey(TimeKeyType_Image);
 }
 
-void TimeKeyBlender::buildPosePalette(ObjectNode& aNode, PosePalette::KeyPair aPair)
+void TimeKeyBlender::buildPosePalette(ObjectNode& aNode, const PosePalette* aPalette)
 {
     if (aNode.timeLine())
     {
         XC_PTR_ASSERT(mSeeker->data(&aNode).expans);
         auto& expans = *(mSeeker->data(&aNode).expans);
 
+        // build once for each skeleton, and share it with the descendants
         if (expans.poseParent())
         {
             PosePalette::KeyPair pair = { &expans.poseParent()->data(), &expans.pose() };
-            aPair = pair;
-        }
-        else if (expans.bone().areaKey())
-        {
-            PosePalette::KeyPair pair = {};
-            aPair = pair;
-        }
-
-        // build
-        if (aPair.origin && aPair.pose)
-        {
-            PosePalette::KeyPairs pairs;
-            pairs.push_back(aPair);
-            expans.posePalette().build(pairs);
+            expans.posePalette().build(pair);
+            aPalette = &expans.posePalette();
         }
         else
         {
             expans.posePalette().clear();
+            if (expans.bone().areaKey())
+            {
+                aPalette = nullptr;
+            }
         }
+        expans.setSharedPosePalette(aPalette);
     }
 
     // iterate children
     for (auto child : aNode.children())
     {
         XC_PTR_ASSERT(child);
-        buildPosePalette(*child, aPair);
+        buildPosePalette(*child, aPalette);
     }
 }
 
@@ -1105,7 +1198,9 @@ void TimeKeyBlender::setBindingMatrices(
                 XC_ASSERT(boneIndex >= 0);
                 if (boneIndex < PosePalette::kMaxCount)
                 {
-                    auto transform = root.expans->posePalette().matrices()[boneIndex];
+                    auto palette = root.expans->sharedPosePalette().matrices();
+                    auto transform = boneIndex < palette.count() ?
+                                palette[boneIndex] : QMatrix4x4();
                     aBindingMtx = root.expans->bone().outerMatrix() * transform * expans.bone().bindingMatrix();
                     expans.bone().setOuterMatrix(aBindingMtx);
                     expans.bone().setInnerMatrix(QMatrix4x4());
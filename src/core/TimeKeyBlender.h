@@ -4,17 +4,19 @@
 #include <array>
 #include <QVector3D>
 #include "util/ITreeSeeker.h"
+#include "util/NonCopyable.h"
 #include "core/ObjectTree.h"
 #include "core/TimeInfo.h"
 #include "core/TimeLineEvent.h"
 #include "core/TimeKeyExpans.h"
 #include "core/TimeKeyGatherer.h"
-#include "core/TimeCacheLock.h"
+#include "core/TimeCacheEpoch.h"
+#include "core/TimeCacheArena.h"
 
 namespace core
 {
 
-class TimeKeyBlender
+class TimeKeyBlender : private util::NonCopyable
 {
 public:
     struct SeekData
@@ -46,9 +48,15 @@ public:
             ObjectNode& aNode, const TimeInfo& aTime);
     static QVector2D getCentroid(
             const ObjectNode& aNode, const TimeInfo& aTime);
+    // the eased rate between point(0) and point(1) of sandwiching keys.
+    // (the type should be blended by easing)
+    static float getEasingRate(TimeKeyType aType, const TimeKeyGatherer& aGatherer);
 
     TimeKeyBlender(ObjectTree& aTree);
-    TimeKeyBlender(ObjectNode& aRootNode, bool aUseWorking);
+    // the current caches are published with aEpoch. (required unless aUseWorking)
+    // aArena is reused over evaluations if it's given, otherwise a local one is used.
+    TimeKeyBlender(ObjectNode& aRootNode, bool aUseWorking,
+                   TimeCacheEpoch* aEpoch = nullptr, TimeCacheArena* aArena = nullptr);
     TimeKeyBlender(SeekerType& aSeeker, PositionType aRoot);
 
     void updateCurrents(ObjectNode* aRootNode, const TimeInfo& aTime);
@@ -64,6 +72,15 @@ private:
     static void getRotateExpans(SRTExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime);
     static void getScaleExpans(SRTExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime);
 
+    static void blendLocalSRTKeys(TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime);
+    static void blendLocalDepthKey(TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime);
+    static void blendLocalOpaKey(TimeKeyExpans& aExpans, const ObjectNode& aNode, const TimeInfo& aTime);
+
+    void gatherNodes(PositionType aPos, int aParent);
+    QMatrix4x4 getParentWorldMatrix(PositionType aPos, const TimeInfo& aTime);
+    float getParentWorldDepth(PositionType aPos, const TimeInfo& aTime);
+    float getParentWorldOpacity(PositionType aPos, const TimeInfo& aTime);
+
     void blendSRTKeys(PositionType aPos, const TimeInfo& aTime);
     void blendDepthKey(PositionType aPos, const TimeInfo& aTime);
     void blendOpaKey(PositionType aPos, const TimeInfo& aTime);
@@ -73,7 +90,7 @@ private:
     void blendFFDKey(PositionType aPos, const TimeInfo& aTime);
     void blendImageKey(PositionType aPos, const TimeInfo& aTime);
     //void buildPosePalette(ObjectNode& aNode, PosePalette::KeyPairs& aPairs);
-    void buildPosePalette(ObjectNode& aNode, PosePalette::KeyPair aPair);
+    void buildPosePalette(ObjectNode& aNode, const PosePalette* aPalette);
     void setBoneInfluenceMaps(ObjectNode& aNode, const BoneKey* aKey,
                               const TimeInfo& aTime);
     void setBinderBones(ObjectNode& aRootNode);
@@ -82,6 +99,9 @@ private:
 
     SeekerType* mSeeker;
     SeekerType::Position mRoot;
+    TimeCacheEpoch* mEpoch;
+    TimeCacheArena mLocalArena;
+    TimeCacheArena* mArena;
 };
 
 } // namespace core
@@ -15,6 +15,7 @@ TimeKeyExpans::TimeKeyExpans()
     , mPose()
     , mPoseParent()
     , mPosePalette()
+    , mSharedPosePalette()
     , mAreaMeshKey()
     , mFFD()
     , mFFDMesh()
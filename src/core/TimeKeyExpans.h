@@ -58,6 +58,10 @@ public:
     const BoneKey* poseParent() const { return mPoseParent; }
     PosePalette& posePalette() { return mPosePalette; }
     const PosePalette& posePalette() const { return mPosePalette; }
+    // the palette of the skeleton which poses me. (it may be an ancestor's one)
+    void setSharedPosePalette(const PosePalette* aPalette) { mSharedPosePalette = aPalette; }
+    const PosePalette& sharedPosePalette() const
+    { return mSharedPosePalette ? *mSharedPosePalette : mPosePalette; }
 
     void setAreaMeshKey(MeshKey* aKey) { mAreaMeshKey = aKey; }
     MeshKey* areaMeshKey() { return mAreaMeshKey; }
@@ -90,6 +94,7 @@ private:
     PoseKey::Data mPose;
     BoneKey* mPoseParent;
     PosePalette mPosePalette;
+    const PosePalette* mSharedPosePalette;
     MeshKey* mAreaMeshKey;
     FFDKey::Data mFFD;
     LayerMesh* mFFDMesh;
@@ -13,18 +13,9 @@ TimeKeyGatherer::Point::Point()
 }
 
 //-------------------------------------------------------------------------------------------------
-TimeKey* TimeKeyGatherer::findLastKey(const TimeLine::MapType& aMap, Frame aFrame)
+TimeKey* TimeKeyGatherer::findLastKey(const TimeKeyArray& aKeys, Frame aFrame)
 {
-    if (!aMap.isEmpty())
-    {
-        auto itr = aMap.upperBound(aFrame.get());
-        if (itr != aMap.begin())
-        {
-            --itr;
-            return itr.value();
-        }
-    }
-    return nullptr;
+    return aKeys.findLast(aFrame.get());
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -35,7 +26,7 @@ TimeKeyGatherer::TimeKeyGatherer()
 }
 
 TimeKeyGatherer::TimeKeyGatherer(
-        const TimeLine::MapType& aMap,
+        const TimeKeyArray& aKeys,
         const TimeInfo& aTimeInfo,
         ForceType aForceType,
         TimeKey* aAssignedParent)
@@ -54,14 +45,21 @@ TimeKeyGatherer::TimeKeyGatherer(
         mParent = aAssignedParent;
     }
 
-    if (aMap.isEmpty())
+    if (aKeys.isEmpty())
     {
         return;
     }
 
-    if (!aTimeInfo.frame.hasFraction() && aMap.contains(mFrame))
+    const int count = aKeys.size();
+    const int frameMax = aTimeInfo.frameMax;
+    const int loop = aTimeInfo.loop;
+
+    // one search for both of the same frame and the neighbors
+    const int upper = aKeys.upperBound(mFrame);
+
+    if (!aTimeInfo.frame.hasFraction() && upper > 0 && aKeys.frame(upper - 1) == mFrame)
     {
-        TimeKey* key = aMap.value(mFrame);
+        TimeKey* key = aKeys.key(upper - 1);
 
         if (mForceType != ForceType_AssignedParent || mParent == key->parent())
         {
@@ -74,12 +72,8 @@ TimeKeyGatherer::TimeKeyGatherer(
         }
     }
 
-    const int count = aMap.size();
-    const int frameMax = aTimeInfo.frameMax;
-    const int loop = aTimeInfo.loop;
-
-    auto forward = aMap.upperBound(mFrame);
-    auto backward = forward;
+    int forward = upper;
+    int backward = upper;
 
     // backward iterate
     do
@@ -87,11 +81,11 @@ TimeKeyGatherer::TimeKeyGatherer(
         Frame baseFrame = aTimeInfo.frame;
         bool isLooped = false;
 
-        if (backward == aMap.begin())
+        if (backward == 0)
         {
             if (loop && count > 1)
             {
-                backward = aMap.end();
+                backward = count;
                 baseFrame.add(frameMax + 1);
                 isLooped = true;
             }
@@ -104,41 +98,31 @@ TimeKeyGatherer::TimeKeyGatherer(
 
         // forced assigned parent, and mismatch
         if (mForceType == ForceType_AssignedParent &&
-                backward.value()->parent() != mParent)
+                aKeys.key(backward)->parent() != mParent)
         {
             break;
         }
         else if (mForceType == ForceType_SameParent)
         {// forced same parent
-            mParent = backward.value()->parent();
+            mParent = aKeys.key(backward)->parent();
         }
 
-        const int frame = backward.key();
-        mPoints[1].key = backward.value();
-        mPoints[1].frame = frame;
-        mPoints[1].relativeFrame = frame - baseFrame.getDecimal();
-        mPoints[1].looped = isLooped;
-        XC_PTR_ASSERT(mPoints[1].key);
+        setPoint(1, aKeys, backward, baseFrame, isLooped);
 
         for (int i = 0; i >= 0; --i)
         {
-            if (backward == aMap.begin())
+            if (backward == 0)
             {
                 break;
             }
             --backward;
 
-            if (forced && backward.value()->parent() != mParent)
+            if (forced && aKeys.key(backward)->parent() != mParent)
             {
                 break;
             }
 
-            const int frame = backward.key();
-            mPoints[i].key = backward.value();
-            mPoints[i].frame = frame;
-            mPoints[i].relativeFrame = frame - baseFrame.getDecimal();
-            mPoints[i].looped = isLooped;
-            XC_PTR_ASSERT(mPoints[i].key);
+            setPoint(i, aKeys, backward, baseFrame, isLooped);
         }
     }
     while(0);
@@ -149,11 +133,11 @@ TimeKeyGatherer::TimeKeyGatherer(
         Frame baseFrame = aTimeInfo.frame;
         bool isLooped = false;
 
-        if (forward == aMap.end())
+        if (forward == count)
         {
             if (loop && count > 1)
             {
-                forward = aMap.begin();
+                forward = 0;
                 baseFrame.add(-frameMax - 1);
                 isLooped = true;
             }
@@ -163,41 +147,43 @@ TimeKeyGatherer::TimeKeyGatherer(
             }
         }
 
-        if (forced && forward.value()->parent() != mParent)
+        if (forced && aKeys.key(forward)->parent() != mParent)
         {
             break;
         }
 
-        const int frame = forward.key();
-        mPoints[2].key = forward.value();
-        mPoints[2].frame = frame;
-        mPoints[2].relativeFrame = frame - baseFrame.getDecimal();
-        mPoints[2].looped = isLooped;
+        setPoint(2, aKeys, forward, baseFrame, isLooped);
         ++forward;
 
         for (int i = 3; i < 4; ++i)
         {
-            if (forward == aMap.end())
+            if (forward == count)
             {
                 break;
             }
 
-            if (forced && forward.value()->parent() != mParent)
+            if (forced && aKeys.key(forward)->parent() != mParent)
             {
                 break;
             }
 
-            const int frame = forward.key();
-            mPoints[i].key = forward.value();
-            mPoints[i].frame = frame;
-            mPoints[i].relativeFrame = frame - baseFrame.getDecimal();
-            mPoints[i].looped = isLooped;
+            setPoint(i, aKeys, forward, baseFrame, isLooped);
             ++forward;
-
-            XC_PTR_ASSERT(mPoints[i].key);
         }
     }
     while(0);
 }
 
+void TimeKeyGatherer::setPoint(
+        int aPoint, const TimeKeyArray& aKeys, int aIndex,
+        const Frame& aBaseFrame, bool aLooped)
+{
+    const int frame = aKeys.frame(aIndex);
+    mPoints[aPoint].key = aKeys.key(aIndex);
+    mPoints[aPoint].frame = frame;
+    mPoints[aPoint].relativeFrame = frame - aBaseFrame.getDecimal();
+    mPoints[aPoint].looped = aLooped;
+    XC_PTR_ASSERT(mPoints[aPoint].key);
+}
+
 } // namespace core
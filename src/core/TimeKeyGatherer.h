@@ -29,11 +29,11 @@ public:
         bool looped;
     };
 
-    static TimeKey* findLastKey(const TimeLine::MapType& aMap, Frame aFrame);
+    static TimeKey* findLastKey(const TimeKeyArray& aKeys, Frame aFrame);
 
     TimeKeyGatherer();
     TimeKeyGatherer(
-            const TimeLine::MapType& aMap,
+            const TimeKeyArray& aKeys,
             const TimeInfo& aTimeInfo,
             ForceType aForceType = ForceType_None,
             TimeKey* aAssignedParent = nullptr);
@@ -49,6 +49,9 @@ public:
 
     TimeKey* parent() const { return mParent; }
 private:
+    void setPoint(int aPoint, const TimeKeyArray& aKeys, int aIndex,
+                  const Frame& aBaseFrame, bool aLooped);
+
     std::array<Point, 4> mPoints;
     const int mFrame;
     ForceType mForceType;
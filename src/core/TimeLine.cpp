@@ -36,6 +36,61 @@ static const std::array<core::TimeKeyType, core::TimeKeyType_TERM> kTimeKeyTypeI
     core::TimeKeyType_Opa
 };
 
+// map commands which keep the flat array in sync
+class InsertKey : public cmnd::Stable
+{
+    core::TimeLine::MapType& mMap;
+    core::TimeKeyArray& mArray;
+    int mFrame;
+    core::TimeKey* mKey;
+public:
+    InsertKey(core::TimeLine::MapType& aMap, core::TimeKeyArray& aArray,
+              int aFrame, core::TimeKey* aKey)
+        : mMap(aMap), mArray(aArray), mFrame(aFrame), mKey(aKey)
+    {}
+
+    virtual void undo()
+    {
+        XC_ASSERT(mMap.contains(mFrame));
+        mMap.remove(mFrame);
+        mArray.assign(mMap);
+    }
+
+    virtual void redo()
+    {
+        XC_ASSERT(!mMap.contains(mFrame));
+        mMap.insert(mFrame, mKey);
+        mArray.assign(mMap);
+    }
+};
+
+class RemoveKey : public cmnd::Stable
+{
+    core::TimeLine::MapType& mMap;
+    core::TimeKeyArray& mArray;
+    int mFrame;
+    core::TimeKey* mPrev;
+public:
+    RemoveKey(core::TimeLine::MapType& aMap, core::TimeKeyArray& aArray, int aFrame)
+        : mMap(aMap), mArray(aArray), mFrame(aFrame), mPrev()
+    {}
+
+    virtual void undo()
+    {
+        XC_ASSERT(!mMap.contains(mFrame));
+        mMap.insert(mFrame, mPrev);
+        mArray.assign(mMap);
+    }
+
+    virtual void redo()
+    {
+        XC_ASSERT(mMap.contains(mFrame));
+        mPrev = mMap.value(mFrame);
+        mMap.remove(mFrame);
+        mArray.assign(mMap);
+    }
+};
+
 }
 
 namespace core
@@ -66,10 +121,17 @@ TimeKeyType TimeLine::getTimeKeyTypeInOrderOfOperations(int aIndex)
 
 TimeLine::TimeLine()
     : mMap()
-    , mCurrent(new TimeKeyExpans())
+    , mKeys()
+    , mCurrents()
+    , mCurrentEpochs()
     , mWorking(new TimeKeyExpans())
     , mDefaultKeys()
 {
+    for (int i = 0; i < 2; ++i)
+    {
+        mCurrents[i].reset(new TimeKeyExpans());
+        mCurrentEpochs[i] = 0;
+    }
 }
 
 TimeLine::~TimeLine()
@@ -120,6 +182,11 @@ const TimeLine::MapType& TimeLine::map(TimeKeyType aType) const
     return mMap.at(aType);
 }
 
+const TimeKeyArray& TimeLine::keys(TimeKeyType aType) const
+{
+    return mKeys.at(aType);
+}
+
 TimeKey* TimeLine::timeKey(TimeKeyType aType, int aIndex)
 {
     if (mMap.at(aType).contains(aIndex))
@@ -166,8 +233,38 @@ void TimeLine::clear()
         QList<TimeKey*> values = mMap[i].values();
         qDeleteAll(values.begin(), values.end());
         mMap[i].clear();
+        mKeys[i].clear();
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        mCurrents[i].reset(new TimeKeyExpans());
+        mCurrentEpochs[i] = 0;
     }
-    mCurrent.reset(new TimeKeyExpans());
+}
+
+void TimeLine::publishEvaluating(uint64 aEpoch)
+{
+    const int index = 1 - currentIndex();
+    XC_ASSERT(mCurrentEpochs[1 - index].load() < aEpoch);
+    mCurrentEpochs[index].store(aEpoch);
+}
+
+int TimeLine::currentIndex() const
+{
+    return mCurrentEpochs[1].load() > mCurrentEpochs[0].load() ? 1 : 0;
+}
+
+int TimeLine::currentIndex(uint64 aEpoch) const
+{
+    const uint64 epoch0 = mCurrentEpochs[0].load();
+    const uint64 epoch1 = mCurrentEpochs[1].load();
+
+    // the newest one at aEpoch
+    if (epoch1 > epoch0)
+    {
+        return epoch1 <= aEpoch ? 1 : 0;
+    }
+    return (epoch0 <= aEpoch || epoch1 > aEpoch) ? 0 : 1;
 }
 
 bool TimeLine::move(TimeKeyType aType, int aFrom, int aTo)
@@ -184,6 +281,7 @@ bool TimeLine::move(TimeKeyType aType, int aFrom, int aTo)
     map.remove(aFrom);
     map.insert(aTo, key);
     key->setFrame(aTo);
+    mKeys.at(aType).assign(map);
     return true;
 }
 
@@ -199,7 +297,7 @@ cmnd::Base* TimeLine::createPusher(TimeKeyType aType, int aFrame, TimeKey* aTime
             pushRemoveCommands(aType, aFrame, aCommands);
         }
         aTimeKey->setFrame(aFrame);
-        aCommands.push(new cmnd::InsertMap<int, TimeKey*>(map, aFrame, aTimeKey));
+        aCommands.push(new InsertKey(map, this->mKeys.at(aType), aFrame, aTimeKey));
     });
 }
 
@@ -234,7 +332,7 @@ void TimeLine::pushRemoveCommands(
         const int cframe = child->frame();
         XC_ASSERT(child == cmap.value(cframe));
         aCommands.push(new cmnd::PopBackTree<TimeKey>(&key->children()));
-        aCommands.push(new cmnd::RemoveMap<int, TimeKey*>(cmap, cframe));
+        aCommands.push(new RemoveKey(cmap, mKeys.at(child->type()), cframe));
         aCommands.push(new cmnd::Sleep(child));
         aCommands.push(new cmnd::GrabDeleteObject<TimeKey>(child));
     }
@@ -246,108 +344,11 @@ void TimeLine::pushRemoveCommands(
     }
 
     // remove
-    aCommands.push(new cmnd::RemoveMap<int, TimeKey*>(map, aFrame));
+    aCommands.push(new RemoveKey(map, mKeys.at(aType), aFrame));
     aCommands.push(new cmnd::Sleep(key));
     aCommands.push(new cmnd::GrabDeleteObject<TimeKey>(key));
 }
 
-int TimeLine::serializeTypeCount() const
-{
-    int count = 0;
-    for (int i = 0; i < TimeKeyType_TERM; ++i)
-    {
-        if (mDefaultKeys[i] || !mMap[i].isEmpty()) ++count;
-    }
-    return count;
-}
-
-bool TimeLine::serialize(Serializer& aOut) const
-{
-    static const std::array<uint8, 8> kSignature =
-        { 'T', 'i', 'm', 'e', 'L', 'i', 'n', 'e' };
-    static const std::array<uint8, 8> kMapSignature =
-        { 'T', 'i', 'm', 'e', 'M', 'a', 'p', '_' };
-
-    // signature
-    auto pos = aOut.beginBlock(kSignature);
-
-    // non empty type count (including default keys)
-    aOut.write(serializeTypeCount());
-
-    // each map
-    for (int i = 0; i < TimeKeyType_TERM; ++i)
-    {
-        const MapType& map = mMap[i];
-        auto defaultKey = mDefaultKeys[i].data();
-
-        if (!defaultKey && map.isEmpty()) continue;
-
-        // signature
-        auto mapPos = aOut.beginBlock(kMapSignature);
-
-        // type name
-        aOut.write(getTimeKeyName((TimeKeyType)i));
-
-        // default key is exists
-        aOut.write((bool)defaultKey);
-
-        // defautltKey
-        if (defaultKey)
-        {
-            if (!serializeTimeKey(aOut, *defaultKey))
-            {
-                return false;
-            }
-        }
-
-        // key count
-        aOut.write(map.count());
-
-        for (auto itr = map.begin(); itr != map.end(); ++itr)
-        {
-            // timekey index
-            aOut.write(itr.key());
-
-            const TimeKey* timeKey = itr.value();
-            XC_PTR_ASSERT(timeKey);
-
-            // time key
-            if (!serializeTimeKey(aOut, *timeKey))
-            {
-                return false;
-            }
-        }
-
-        aOut.endBlock(mapPos);
-    }
-
-    aOut.endBlock(pos);
-
-    return aOut.checkStream();
-}
-
-bool TimeLine::serializeTimeKey(Serializer& aOut, const TimeKey& aTimeKey) const
-{
-    // reference id
-    aOut.writeID(&aTimeKey);
-
-    // timekey value
-    if (!aTimeKey.serialize(aOut))
-    {
-        return false;
-    }
-
-    // child count
-    aOut.write((int)aTimeKey.children().size());
-
-    // references to children
-    for (const TimeKey* child : aTimeKey.children())
-    {
-        aOut.writeID(child);
-    }
-    return true;
-}
-
 bool TimeLine::deserialize(Deserializer& aIn)
 {
     clear();
@@ -410,6 +411,7 @@ bool TimeLine::deserialize(Deserializer& aIn)
                 return false;
             }
         }
+        mKeys[typeIndex].assign(mMap[typeIndex]);
 
         // check block end
         if (!aIn.endBlock())
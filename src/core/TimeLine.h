@@ -2,11 +2,13 @@
 #define CORE_TIMELINE_H
 
 #include <array>
+#include <atomic>
 #include <QMap>
 #include <QScopedPointer>
 #include "cmnd/Vector.h"
 #include "core/TimeKey.h"
 #include "core/TimeKeyType.h"
+#include "core/TimeKeyArray.h"
 #include "core/Serializer.h"
 #include "core/Deserializer.h"
 namespace core { class Project; }
@@ -38,6 +40,7 @@ public:
     int validTypeCount() const;
 
     const MapType& map(TimeKeyType aType) const;
+    const TimeKeyArray& keys(TimeKeyType aType) const;
 
     TimeKey* timeKey(TimeKeyType aType, int aIndex);
     const TimeKey* timeKey(TimeKeyType aType, int aIndex) const;
@@ -46,8 +49,16 @@ public:
     TimeKey* defaultKey(TimeKeyType aType);
     const TimeKey* defaultKey(TimeKeyType aType) const;
 
-    TimeKeyExpans& current() { return *mCurrent; }
-    const TimeKeyExpans& current() const { return *mCurrent; }
+    // the current caches are double buffered. (see TimeCacheEpoch)
+    // the latest published caches
+    TimeKeyExpans& current() { return *mCurrents[currentIndex()]; }
+    const TimeKeyExpans& current() const { return *mCurrents[currentIndex()]; }
+    // the caches which were published at aEpoch
+    TimeKeyExpans& current(uint64 aEpoch) { return *mCurrents[currentIndex(aEpoch)]; }
+    const TimeKeyExpans& current(uint64 aEpoch) const { return *mCurrents[currentIndex(aEpoch)]; }
+    // the back buffer which an evaluator writes
+    TimeKeyExpans& evaluating() { return *mCurrents[1 - currentIndex()]; }
+    void publishEvaluating(uint64 aEpoch);
 
     TimeKeyExpans& working() { return *mWorking; }
     const TimeKeyExpans& working() const { return *mWorking; }
@@ -56,19 +67,20 @@ public:
     cmnd::Base* createPusher(TimeKeyType aType, int aFrame, TimeKey* aTimeKey);
     cmnd::Base* createRemover(TimeKeyType aType, int aFrame, bool aOptional = false);
 
-    bool serialize(Serializer& aOut) const;
     bool deserialize(Deserializer& aIn);
 
 private:
     void clear();
-    int serializeTypeCount() const;
     void pushRemoveCommands(
             TimeKeyType aType, int aFrame, cmnd::Vector& aCommands);
-    bool serializeTimeKey(Serializer& aOut, const TimeKey& aTimeKey) const;
     bool deserializeTimeKey(Deserializer& aIn, TimeKeyType aType, int aIndex);
+    int currentIndex() const;
+    int currentIndex(uint64 aEpoch) const;
 
     std::array<MapType, TimeKeyType_TERM> mMap;
-    QScopedPointer<TimeKeyExpans> mCurrent;
+    std::array<TimeKeyArray, TimeKeyType_TERM> mKeys;
+    std::array<QScopedPointer<TimeKeyExpans>, 2> mCurrents;
+    std::array<std::atomic<uint64>, 2> mCurrentEpochs;
     QScopedPointer<TimeKeyExpans> mWorking;
     std::array<QScopedPointer<TimeKey>, TimeKeyType_TERM> mDefaultKeys;
 };
@@ -1,6 +1,44 @@
 #include "core/TimeLineEvent.h"
 #include "core/ObjectNode.h"
 
+namespace
+{
+
+bool isSameTarget(const core::TimeLineEvent::Target& aLhs, const core::TimeLineEvent::Target& aRhs)
+{
+    return aLhs.node == aRhs.node &&
+            aLhs.pos.line() == aRhs.pos.line() &&
+            aLhs.pos.type() == aRhs.pos.type() &&
+            aLhs.pos.index() == aRhs.pos.index() &&
+            aLhs.subIndex == aRhs.subIndex;
+}
+
+bool containsTarget(
+        const QVector<core::TimeLineEvent::Target>& aTargets,
+        const core::TimeLineEvent::Target& aTarget)
+{
+    for (auto& target : aTargets)
+    {
+        if (isSameTarget(target, aTarget)) return true;
+    }
+    return false;
+}
+
+void pushUniqueTargets(
+        QVector<core::TimeLineEvent::Target>& aDst,
+        const QVector<core::TimeLineEvent::Target>& aSrc)
+{
+    for (auto& target : aSrc)
+    {
+        if (!containsTarget(aDst, target))
+        {
+            aDst.push_back(target);
+        }
+    }
+}
+
+}
+
 namespace core
 {
 
@@ -45,4 +83,10 @@ void TimeLineEvent::pushDefaultTarget(ObjectNode& aNode, TimeKeyType aType)
     mDefaultTargets.push_back(target);
 }
 
+void TimeLineEvent::mergeTargets(const TimeLineEvent& aEvent)
+{
+    pushUniqueTargets(mTargets, aEvent.mTargets);
+    pushUniqueTargets(mDefaultTargets, aEvent.mDefaultTargets);
+}
+
 } // namespace core
@@ -45,6 +45,9 @@ public:
 
     void pushDefaultTarget(ObjectNode& aNode, TimeKeyType aType);
 
+    // push the targets of another event which are not contained yet.
+    void mergeTargets(const TimeLineEvent& aEvent);
+
     Type type() const { return mType; }
     QVector<Target>& targets() { return mTargets; }
     const QVector<Target>& targets() const { return mTargets; }
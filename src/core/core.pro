@@ -65,11 +65,14 @@ SOURCES += \
     TimeKey.cpp \
     BoneShape.cpp \
     TimeKeyGatherer.cpp \
+    TimeKeyArray.cpp \
     BoneInfluenceMap.cpp \
     TimeKeyBlender.cpp \
     TimeKeyExpans.cpp \
     MeshTransformer.cpp \
     ResourceHolder.cpp \
+    ResourceSnapshot.cpp \
+    ObjectTreeSnapshot.cpp \
     OpaKey.cpp \
     MeshKey.cpp \
     LayerMesh.cpp \
@@ -77,8 +80,10 @@ SOURCES += \
     FFDKeyUpdater.cpp \
     BoneKeyUpdater.cpp \
     ClippingFrame.cpp \
+    StaticTreeCache.cpp \
     ShaderHolder.cpp \
-    TimeCacheLock.cpp \
+    TimeCacheEpoch.cpp \
+    TimeCacheArena.cpp \
     TimeCacheAccessor.cpp \
     TimeLineEvent.cpp \
     MeshKeyUtil.cpp \
@@ -128,12 +133,15 @@ HEADERS += \
     ObjectTreeNotifier.h \
     BoneShape.h \
     TimeKeyGatherer.h \
+    TimeKeyArray.h \
     BoneInfluenceMap.h \
     TimeKeyBlender.h \
     TimeKeyExpans.h \
     SRTExpans.h \
     MeshTransformer.h \
     ResourceHolder.h \
+    ResourceSnapshot.h \
+    ObjectTreeSnapshot.h \
     OpaKey.h \
     MeshKey.h \
     LayerMesh.h \
@@ -141,8 +149,10 @@ HEADERS += \
     FFDKeyUpdater.h \
     BoneKeyUpdater.h \
     ClippingFrame.h \
+    StaticTreeCache.h \
     ShaderHolder.h \
-    TimeCacheLock.h \
+    TimeCacheEpoch.h \
+    TimeCacheArena.h \
     TimeCacheAccessor.h \
     Frame.h \
     MeshKeyUtil.h \
@@ -1,4 +1,5 @@
 #include "util/CollDetect.h"
+#include "gl/Profiler.h"
 #include "ctrl/Driver.h"
 
 namespace
@@ -212,15 +213,16 @@ void Driver::renderGL(
 
     if (aGridTarget && aGridTarget->renderer())
     {
+        gl::ProfileScope profile("pipeline", "grid", true);
         info.isGrid = true;
-        core::TimeCacheAccessor accessor(
-                    *aGridTarget, tree.timeCacheLock(), info.time, false);
+        core::TimeCacheAccessor accessor(tree, *aGridTarget, info.time, false);
         aGridTarget->renderer()->render(info, accessor);
     }
 }
 
 void Driver::renderQt(const core::RenderInfo& aRenderInfo, QPainter& aPainter)
 {
+    gl::ProfileScope profile("qt", "Driver::renderQt");
     auto info = aRenderInfo;
     if (mToolType == ToolType_Bone)
     {
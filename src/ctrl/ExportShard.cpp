@@ -0,0 +1,194 @@
+#include <cstdio>
+#include <cstdlib>
+#include <QFile>
+#include <QJsonDocument>
+#include "gl/Global.h"
+#include "gl/OffscreenContext.h"
+#include "core/Animator.h"
+#include "core/Project.h"
+#include "ctrl/ProjectLoader.h"
+#include "ctrl/ExportShard.h"
+
+namespace
+{
+
+class ShardAnimator : public core::Animator
+{
+public:
+    virtual core::Frame currentFrame() const { return core::Frame(0); }
+    virtual void stop() {}
+    virtual void suspend() {}
+    virtual void resume() {}
+    virtual bool isSuspended() const { return false; }
+};
+
+// report progress to the parent process by stdout
+class ShardReporter : public util::IProgressReporter
+{
+public:
+    ShardReporter() : mIsEnabled(false), mProgress(-1) {}
+    void setEnabled(bool aIsEnabled) { mIsEnabled = aIsEnabled; }
+    virtual void setSection(const QString&) {}
+    virtual void setMaximum(int) {}
+    virtual void setProgress(int aValue)
+    {
+        if (!mIsEnabled || mProgress == aValue) return;
+        mProgress = aValue;
+        std::fprintf(stdout, "progress %d\n", aValue);
+        std::fflush(stdout);
+    }
+    virtual bool wasCanceled() const { return false; }
+private:
+    bool mIsEnabled;
+    int mProgress;
+};
+
+void printError(const QString& aText)
+{
+    std::fprintf(stderr, "%s\n", aText.toLocal8Bit().constData());
+}
+
+} // namespace
+
+namespace ctrl
+{
+
+const char* const ExportShard::kArgument = "--export-shard";
+
+//-------------------------------------------------------------------------------------------------
+ExportShard::Job::Job()
+    : projectPath()
+    , common()
+    , image()
+    , shard()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+bool ExportShard::writeJob(const Job& aJob, const QString& aPath)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(QJsonDocument(toJson(aJob)).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+bool ExportShard::readJob(const QString& aPath, Job& aJob)
+{
+    QFile file(aPath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject())
+    {
+        return false;
+    }
+    aJob = fromJson(document.object());
+    return true;
+}
+
+QJsonObject ExportShard::toJson(const Job& aJob)
+{
+    QJsonObject common;
+    common["path"] = aJob.common.path;
+    common["width"] = aJob.common.size.width();
+    common["height"] = aJob.common.size.height();
+    common["frameMin"] = aJob.common.frame.min();
+    common["frameMax"] = aJob.common.frame.max();
+    common["fps"] = aJob.common.fps;
+    common["tileSize"] = aJob.common.tileSize;
+
+    QJsonObject image;
+    image["name"] = aJob.image.name;
+    image["suffix"] = aJob.image.suffix;
+    image["quality"] = aJob.image.quality;
+
+    QJsonObject shard;
+    shard["indexMin"] = aJob.shard.index.min();
+    shard["indexMax"] = aJob.shard.index.max();
+    shard["videoCommand"] = aJob.shard.videoCommand;
+    shard["videoInCodec"] = aJob.shard.videoInCodec;
+
+    QJsonObject root;
+    root["project"] = aJob.projectPath;
+    root["common"] = common;
+    root["image"] = image;
+    root["shard"] = shard;
+    return root;
+}
+
+ExportShard::Job ExportShard::fromJson(const QJsonObject& aJson)
+{
+    Job job;
+    job.projectPath = aJson["project"].toString();
+
+    const QJsonObject common = aJson["common"].toObject();
+    job.common.path = common["path"].toString();
+    job.common.size = QSize(common["width"].toInt(), common["height"].toInt());
+    job.common.frame = util::Range(common["frameMin"].toInt(), common["frameMax"].toInt());
+    job.common.fps = common["fps"].toInt();
+    job.common.tileSize = common["tileSize"].toInt();
+
+    const QJsonObject image = aJson["image"].toObject();
+    job.image.name = image["name"].toString();
+    job.image.suffix = image["suffix"].toString();
+    job.image.quality = image["quality"].toInt(-1);
+
+    const QJsonObject shard = aJson["shard"].toObject();
+    job.shard.index = util::Range(shard["indexMin"].toInt(), shard["indexMax"].toInt(-1));
+    job.shard.videoCommand = shard["videoCommand"].toString();
+    job.shard.videoInCodec = shard["videoInCodec"].toString();
+    return job;
+}
+
+//-------------------------------------------------------------------------------------------------
+int ExportShard::executeChild(const QString& aJobPath)
+{
+    Job job;
+    if (!readJob(aJobPath, job))
+    {
+        printError("Failed to read a job. " + aJobPath);
+        return EXIT_FAILURE;
+    }
+
+    gl::OffscreenContext context;
+    if (!context.create())
+    {
+        printError(context.log());
+        return EXIT_FAILURE;
+    }
+
+    ShardAnimator animator;
+    ShardReporter reporter;
+    int result = EXIT_SUCCESS;
+    {
+        // load the saved project
+        core::Project project(job.projectPath, animator, nullptr);
+        {
+            ProjectLoader loader;
+            if (!loader.load(job.projectPath, project, context.deviceInfo(), reporter))
+            {
+                printError(loader.log().join("\n"));
+                return EXIT_FAILURE;
+            }
+        }
+
+        // render the shard
+        reporter.setEnabled(true);
+        Exporter exporter(project);
+        exporter.setProgressReporter(reporter);
+        if (!exporter.executeShard(job.common, job.image, job.shard))
+        {
+            printError(exporter.log());
+            result = EXIT_FAILURE;
+        }
+        gl::Global::makeCurrent();
+    }
+    return result;
+}
+
+} // namespace ctrl
@@ -0,0 +1,40 @@
+#ifndef CTRL_EXPORTSHARD_H
+#define CTRL_EXPORTSHARD_H
+
+#include <QString>
+#include <QJsonObject>
+#include "ctrl/Exporter.h"
+
+namespace ctrl
+{
+
+// a job of a child process which renders a part of an export
+class ExportShard
+{
+public:
+    // the command line argument which is followed by a job file path
+    static const char* const kArgument;
+
+    struct Job
+    {
+        Job();
+        QString projectPath;
+        Exporter::CommonParam common;
+        Exporter::ImageParam image;
+        Exporter::ShardParam shard;
+    };
+
+    static bool writeJob(const Job& aJob, const QString& aPath);
+    static bool readJob(const QString& aPath, Job& aJob);
+
+    // the entry point of a child process. (returns an exit code)
+    static int executeChild(const QString& aJobPath);
+
+private:
+    static QJsonObject toJson(const Job& aJob);
+    static Job fromJson(const QJsonObject& aJson);
+};
+
+} // namespace ctrl
+
+#endif // CTRL_EXPORTSHARD_H
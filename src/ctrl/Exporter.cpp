@@ -1,9 +1,105 @@
+#include <cmath>
+#include <cstring>
 #include <QFileInfo>
 #include <QBuffer>
+#include <QFile>
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
 #include "util/SelectArgs.h"
+#include "util/Finally.h"
 #include "gl/Global.h"
 #include "gl/Util.h"
+#include "gl/Profiler.h"
+#include "gl/DeviceInfo.h"
+#include "core/ObjectNode.h"
+#include "core/TimeKeyGatherer.h"
 #include "ctrl/Exporter.h"
+#include "ctrl/ExportShard.h"
+
+namespace
+{
+// frames over this side length are rendered by tiles.
+static const int kMaxUntiledSide = 4096;
+static const int kDefaultTileSize = 1024;
+// overlaps of tiles in export pixels. (for the footprints of scaling filters)
+static const int kTileOverlap = 4;
+// a child process renders frames more than this.
+static const int kMinShardFrames = 8;
+
+inline void mixHash(quint64& aHash, quint64 aValue)
+{
+    aHash ^= aValue + 0x9e3779b97f4a7c15ULL + (aHash << 6) + (aHash >> 2);
+}
+
+inline bool isSteppedType(core::TimeKeyType aType)
+{
+    return aType == core::TimeKeyType_Bone ||
+            aType == core::TimeKeyType_Mesh ||
+            aType == core::TimeKeyType_Image;
+}
+
+// a hash of the keys which decide the scene on the time.
+// Equal hashes mean the same rendering result. Stepped types and keys without
+// easing hold the last key, and a blend between keys mixes the eased rate in.
+quint64 hashSceneState(core::ObjectNode& aTopNode, const core::TimeInfo& aTime)
+{
+    quint64 hash = 0;
+
+    for (core::ObjectNode::Iterator itr(&aTopNode); itr.hasNext();)
+    {
+        core::ObjectNode* node = itr.next();
+        const core::TimeLine* timeLine = node->timeLine();
+        if (!timeLine) continue;
+
+        for (int i = 0; i < core::TimeKeyType_TERM; ++i)
+        {
+            const core::TimeKeyType type = (core::TimeKeyType)i;
+            const core::TimeKeyArray& keys = timeLine->keys(type);
+            if (keys.isEmpty()) continue;
+
+            mixHash(hash, (quint64)(size_t)node);
+            mixHash(hash, (quint64)i);
+
+            // the blender evaluates them by the last key only
+            if (isSteppedType(type))
+            {
+                auto key = core::TimeKeyGatherer::findLastKey(keys, aTime.frame);
+                mixHash(hash, (quint64)(size_t)key);
+                continue;
+            }
+
+            const core::TimeKeyGatherer gatherer(keys, aTime);
+            if (gatherer.isSandwiched() && !gatherer.hasSameFrame())
+            {
+                const float rate = core::TimeKeyBlender::getEasingRate(type, gatherer);
+
+                if (rate == 0.0f)
+                { // it's the same as the previous key (e.g. no easing)
+                    mixHash(hash, (quint64)(size_t)gatherer.point(0).key);
+                }
+                else
+                {
+                    for (int k = -1; k <= 2; ++k)
+                    {
+                        mixHash(hash, (quint64)(size_t)gatherer.point(k).key);
+                    }
+                    // the exact rate, since a tiny difference may move many pixels
+                    quint32 bits = 0;
+                    std::memcpy(&bits, &rate, sizeof(bits));
+                    mixHash(hash, (quint64)bits);
+                }
+            }
+            else if (gatherer.isSingle())
+            {
+                mixHash(hash, (quint64)(size_t)gatherer.singlePoint().key);
+            }
+        }
+    }
+    return hash;
+}
+}
 
 namespace ctrl
 {
@@ -25,6 +121,7 @@ Exporter::CommonParam::CommonParam()
     , size()
     , frame()
     , fps()
+    , tileSize()
 {
 }
 
@@ -45,6 +142,11 @@ bool Exporter::CommonParam::isValid() const
         return false;
     }
 
+    if (tileSize < 0)
+    {
+        return false;
+    }
+
     return true;
 }
 
@@ -73,6 +175,14 @@ Exporter::VideoParam::VideoParam()
 {
 }
 
+//-------------------------------------------------------------------------------------------------
+Exporter::ShardParam::ShardParam()
+    : index()
+    , videoCommand()
+    , videoInCodec()
+{
+}
+
 //-------------------------------------------------------------------------------------------------
 Exporter::FFMpeg::FFMpeg()
     : mProcess()
@@ -178,16 +288,31 @@ Exporter::Exporter(core::Project& aProject)
     , mClippingFrame()
     , mDestinationTexturizer()
     , mTextureDrawer()
+    , mTileSize()
+    , mTileRenderSize()
+    , mTileOverlap()
+    , mTiledImage()
     , mOriginTimeInfo()
     , mOverwriteConfirmer()
     , mOverwriteConfirmation()
     , mProgressReporter()
     , mUILogger()
+    , mProfileDumpPath()
+    , mProfiling(false)
+    , mProfileHistoryCapacity(0)
+    , mShardCount(1)
     , mCommonParam()
     , mImageParam()
     , mVideoInCodec()
     , mVideoInCodecQuality()
     , mVideoExporting()
+    , mShardParam()
+    , mIsShard(false)
+    , mHasLastFrame(false)
+    , mLastFrameHash(0)
+    , mLastFrameBytes()
+    , mLastFramePath()
+    , mDuplicatedFrameCount(0)
     , mFFMpeg()
     , mExporting(false)
     , mIndex(0)
@@ -207,6 +332,16 @@ Exporter::~Exporter()
     destroyFramebuffers();
 }
 
+void Exporter::setProfileDumpPath(const QString& aPath)
+{
+    mProfileDumpPath = aPath;
+}
+
+void Exporter::setShardCount(int aCount)
+{
+    mShardCount = std::max(aCount, 0);
+}
+
 void Exporter::setOverwriteConfirmer(const OverwriteConfirmer& aConfirmer)
 {
     mOverwriteConfirmer = aConfirmer;
@@ -242,11 +377,17 @@ Exporter::Result Exporter::execute(const CommonParam& aCommon, const ImageParam&
     mCommonParam = aCommon;
     mImageParam = aImage;
     mVideoExporting = false;
+    mIsShard = false;
     mOriginTimeInfo = mProject.currentTimeInfo();
     mOverwriteConfirmation = false;
     mLog.clear();
     mIsCanceled = false;
 
+    const int shardCount = decideShardCount();
+    if (shardCount > 1)
+    {
+        return executeShards(shardCount, nullptr);
+    }
     return execute();
 }
 
@@ -316,110 +457,365 @@ Exporter::Result Exporter::execute(const CommonParam& aCommon, const VideoParam&
 
     mCommonParam = aCommon;
     mVideoExporting = true;
+    mIsShard = false;
     mOriginTimeInfo = mProject.currentTimeInfo();
     mLog.clear();
     mIsCanceled = false;
 
-#if 0
-    {
-        const QString out = " \"" + filePath.absoluteFilePath() + "\"";
-        //const QString ifps = " -r " + QString::number(mCommonParam.fps);
-        //const QString ofps = ifps;
-        const QString ifps = " -framerate " + QString::number(mCommonParam.fps);
-        const QString ofps = " -r " + QString::number(mCommonParam.fps);
-        const QString icodec = " -vcodec png";
-        //const QString icodec = " -vcodec ppm";
-        const QString ocodec =
-                !aVideo.codec.isEmpty() ? " -vcodec " + aVideo.codec : "";
-        const QString obps =
-                aVideo.bps > 0 ? " -b:v " + QString::number(aVideo.bps) : "";
-        const QString thrs = ""; //" -threads 8";
-
-        QString argments =
-                QString(" -y") + /// overwrite files without asking
-                " -f image2pipe" +
-                ifps + icodec + " -i -" +
-                obps + ofps + ocodec + thrs + out;
-
-        if (!mFFMpeg.start(argments))
-        {
-            mLog = "FFmpeg error occurred.\n" + mFFMpeg.errorString();
-            return mFFMpeg.errorCode() == QProcess::FailedToStart ?
-                        Result(ResultCode_FFMpegFailedToStart, mLog) :
-                        Result(ResultCode_FFMpegError, mLog);
-        }
+    // segments of gif can't be concatenated without reencoding
+    const int shardCount = decideShardCount();
+    if (shardCount > 1 && filePath.suffix().toLower() != "gif")
+    {
+        return executeShards(shardCount, &aVideo);
     }
-#else
+
+    QString inCodec;
+    const QString command = makeVideoCommand(aVideo, filePath.absoluteFilePath(), inCodec);
+    return executeVideo(command, inCodec);
+}
+
+Exporter::Result Exporter::executeShard(
+        const CommonParam& aCommon, const ImageParam& aImage, const ShardParam& aShard)
+{
+    // check param
+    if (!aCommon.isValid() || aShard.index.isNegative())
     {
-        const QString outPath = "\"" + filePath.absoluteFilePath() + "\"";
+        mLog = "Invalid shard parameters.";
+        return Result(ResultCode_InvalidOperation, mLog);
+    }
 
-        VideoCodec videoCodec;
-        if (aVideo.codecIndex != -1)
-        {
-            videoCodec = aVideo.format.codecs.at(aVideo.codecIndex);
-        }
-        else
+    mCommonParam = aCommon;
+    mImageParam = aImage;
+    mShardParam = aShard;
+    mIsShard = true;
+    mOriginTimeInfo = mProject.currentTimeInfo();
+    mOverwriteConfirmation = true; // confirmed by the parent process
+    mLog.clear();
+    mIsCanceled = false;
+
+    if (aShard.videoCommand.isEmpty())
+    {
+        mVideoExporting = false;
+        return execute();
+    }
+
+    mVideoExporting = true;
+    return executeVideo(aShard.videoCommand, aShard.videoInCodec);
+}
+
+QString Exporter::makeVideoCommand(
+        const VideoParam& aVideo, const QString& aOutPath, QString& aInCodec) const
+{
+    const QString outPath = "\"" + aOutPath + "\"";
+
+    VideoCodec videoCodec;
+    if (aVideo.codecIndex != -1)
+    {
+        videoCodec = aVideo.format.codecs.at(aVideo.codecIndex);
+    }
+    else
+    {
+        videoCodec.icodec = aVideo.format.icodec;
+    }
+    auto colorIndex = videoCodec.colorspace ? aVideo.colorIndex : 0;
+
+    if (videoCodec.icodec != "png" && videoCodec.icodec != "ppm" &&
+            videoCodec.icodec != "jpg" && videoCodec.icodec != "jpeg" &&
+            videoCodec.icodec != "bmp")
+    {
+        videoCodec.icodec = "png";
+    }
+    aInCodec = videoCodec.icodec;
+
+    if (videoCodec.command.isEmpty())
+    {
+        videoCodec.command = "-y -f image2pipe -framerate $ifps -vcodec $icodec -i - -b:v $obps -r $ofps $opath";
+    }
+    videoCodec.command.replace(QRegExp("\\$ifps(\\s|$)"), QString::number(mCommonParam.fps) + "\\1");
+    videoCodec.command.replace(QRegExp("\\$icodec(\\s|$)"), videoCodec.icodec + "\\1");
+    videoCodec.command.replace(QRegExp("\\$obps(\\s|$)"), QString::number(aVideo.bps) + "\\1");
+    videoCodec.command.replace(QRegExp("\\$ofps(\\s|$)"), QString::number(mCommonParam.fps) + "\\1");
+    videoCodec.command.replace(QRegExp("\\$ocodec(\\s|$)"), videoCodec.name + "\\1");
+    videoCodec.command.replace(QRegExp("\\$opath(\\s|$)"), outPath + "\\1");
+    videoCodec.command.replace(QRegExp("\\$pixfmt(\\s|$)"), aVideo.pixfmt + "\\1");
+    videoCodec.command.replace(QRegExp("\\$arg_colorfilter(\\s|$)"), (colorIndex == 0 ? QString("-vf colormatrix=bt601:bt709") : QString("")) + "\\1");
+    videoCodec.command.replace(QRegExp("\\$arg_colorspace(\\s|$)"), QString("-colorspace ") + (colorIndex == 0 ? QString("bt709") : QString("smpte170m")) + "\\1");
+    return videoCodec.command;
+}
+
+Exporter::Result Exporter::executeVideo(const QString& aCommand, const QString& aInCodec)
+{
+    mVideoInCodecQuality = -1;
+    if (aInCodec == "ppm")
+    {
+        mVideoInCodec = "PPM";
+    }
+    else if (aInCodec == "jpg")
+    {
+        mVideoInCodec = "JPG";
+    }
+    else if (aInCodec == "jpeg")
+    {
+        mVideoInCodec = "JPEG";
+    }
+    else if (aInCodec == "bmp")
+    {
+        mVideoInCodec = "BMP";
+    }
+    else
+    {
+        mVideoInCodec = "PNG";
+        mVideoInCodecQuality = 90;
+    }
+
+    qDebug() << aCommand;
+
+    if (!mFFMpeg.start(aCommand))
+    {
+        mLog = "FFmpeg error occurred.\n" + mFFMpeg.errorString();
+        return mFFMpeg.errorCode() == QProcess::FailedToStart ?
+                    Result(ResultCode_FFMpegFailedToStart, mLog) :
+                    Result(ResultCode_FFMpegError, mLog);
+    }
+
+    return execute();
+}
+
+int Exporter::decideShardCount() const
+{
+    if (mShardCount == 1) return 1;
+
+    // child processes load the saved project
+    if (mProject.fileName().isEmpty() || mProject.isModified() ||
+            !QFileInfo(mProject.fileName()).exists())
+    {
+        return 1;
+    }
+
+    // a profile of the export requires all frames in this process
+    if (!mProfileDumpPath.isEmpty() && gl::Profiler::instance())
+    {
+        return 1;
+    }
+
+    const int count = mShardCount > 0 ? mShardCount : QThread::idealThreadCount();
+    return std::max(std::min(count, getIndexCount() / kMinShardFrames), 1);
+}
+
+int Exporter::getIndexCount() const
+{
+    // same as the end condition of updateTime()
+    int count = 0;
+    for (;; ++count)
+    {
+        const double current = (count * mOriginTimeInfo.fps) / (double)mCommonParam.fps;
+        const double frame = mCommonParam.frame.min() + current;
+        if (0 < count && mCommonParam.frame.max() < frame) break;
+        if (mOriginTimeInfo.frameMax < (int)frame) break;
+    }
+    return count;
+}
+
+Exporter::Result Exporter::executeShards(int aCount, const VideoParam* aVideo)
+{
+    const int indexCount = getIndexCount();
+    mDigitCount = getDigitCount(mCommonParam.frame, mCommonParam.fps, mOriginTimeInfo.fps);
+
+    // confirm overwriting at once
+    if (!aVideo)
+    {
+        for (int i = 0; i < indexCount; ++i)
         {
-            videoCodec.icodec = aVideo.format.icodec;
+            QFileInfo path;
+            if (!decideImagePath(i, path))
+            {
+                mLog = "Exporting was canceled.";
+                mIsCanceled = true;
+                return Result(ResultCode_Canceled, mLog);
+            }
         }
-        auto colorIndex = videoCodec.colorspace ? aVideo.colorIndex : 0;
+    }
 
-        mVideoInCodecQuality = -1;
-        if (videoCodec.icodec == "png")
+    QTemporaryDir workDir;
+    if (!workDir.isValid())
+    {
+        mLog = "Failed to create a working directory.";
+        return Result(ResultCode_UnclassfiedError, mLog);
+    }
+
+    if (mProgressReporter)
+    {
+        mProgressReporter->setSection("Exporting...");
+        mProgressReporter->setMaximum(100);
+    }
+
+    // launch child processes
+    std::vector<std::unique_ptr<QProcess>> processes;
+    std::vector<int> sizes;
+    QStringList segments;
+    const QString suffix = QFileInfo(mCommonParam.path).suffix();
+
+    for (int i = 0; i < aCount; ++i)
+    {
+        ExportShard::Job job;
+        job.projectPath = mProject.fileName();
+        job.common = mCommonParam;
+        job.image = mImageParam;
+
+        const int begin = (int)((qint64)indexCount * i / aCount);
+        const int end = (int)((qint64)indexCount * (i + 1) / aCount);
+        job.shard.index = util::Range(begin, end - 1);
+
+        if (aVideo)
         {
-            mVideoInCodec = "PNG";
-            mVideoInCodecQuality = 90;
+            const QString segment = workDir.filePath(QString("segment%1.%2").arg(i).arg(suffix));
+            job.shard.videoCommand = makeVideoCommand(*aVideo, segment, job.shard.videoInCodec);
+            segments.push_back(segment);
         }
-        else if (videoCodec.icodec == "ppm")
+
+        const QString jobPath = workDir.filePath(QString("job%1.json").arg(i));
+        if (!ExportShard::writeJob(job, jobPath))
         {
-            mVideoInCodec = "PPM";
+            mLog = "Failed to write a job of the export.";
+            return Result(ResultCode_UnclassfiedError, mLog);
         }
-        else if (videoCodec.icodec == "jpg")
+
+        processes.emplace_back(new QProcess());
+        processes.back()->start(QCoreApplication::applicationFilePath(),
+                                QStringList() << ExportShard::kArgument << jobPath);
+        sizes.push_back(end - begin);
+    }
+
+    // wait for all shards
+    {
+        auto result = waitShards(processes, sizes);
+        if (!result) return result;
+    }
+
+    if (aVideo)
+    {
+        // concatenate segments without reencoding
+        const QString listPath = workDir.filePath("segments.txt");
+        QFile listFile(listPath);
+        if (!listFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
         {
-            mVideoInCodec = "JPG";
+            mLog = "Failed to write a list of segments.";
+            return Result(ResultCode_UnclassfiedError, mLog);
         }
-        else if (videoCodec.icodec == "jpeg")
         {
-            mVideoInCodec = "JPEG";
+            QTextStream stream(&listFile);
+            for (auto& segment : segments)
+            {
+                stream << "file '" << QString(segment).replace("'", "'\\''") << "'\n";
+            }
         }
-        else if (videoCodec.icodec == "bmp")
+        listFile.close();
+
+        const QString outPath = QFileInfo(mCommonParam.path).absoluteFilePath();
+        auto waiter = [=]()->bool { this->updateLog(); return true; };
+        if (!mFFMpeg.execute("-y -f concat -safe 0 -i \"" + listPath +
+                             "\" -c copy \"" + outPath + "\"", waiter) ||
+                mFFMpeg.errorOccurred())
         {
-            mVideoInCodec = "BMP";
+            mLog = "FFmpeg error occurred.\n" + mFFMpeg.errorString();
+            return mFFMpeg.errorCode() == QProcess::FailedToStart ?
+                        Result(ResultCode_FFMpegFailedToStart, mLog) :
+                        Result(ResultCode_FFMpegError, mLog);
         }
-        else
+    }
+
+    return Result(ResultCode_Success, "Success.");
+}
+
+Exporter::Result Exporter::waitShards(
+        std::vector<std::unique_ptr<QProcess>>& aProcesses, const std::vector<int>& aSizes)
+{
+    static const int kMSec = 100;
+    std::vector<int> progresses(aProcesses.size(), 0);
+    int total = 0;
+    for (auto size : aSizes) total += size;
+
+    auto killAll = [&]()
+    {
+        for (auto& process : aProcesses)
         {
-            videoCodec.icodec = "png";
-            mVideoInCodec = "PNG";
-            mVideoInCodecQuality = 90;
+            process->kill();
+            process->waitForFinished();
         }
+    };
+
+    auto hasFailed = [](const QProcess& aProcess)->bool
+    {
+        return aProcess.error() == QProcess::FailedToStart ||
+                aProcess.exitStatus() != QProcess::NormalExit ||
+                aProcess.exitCode() != 0;
+    };
 
-        if (videoCodec.command.isEmpty())
+    std::vector<bool> finished(aProcesses.size(), false);
+
+    while (1)
+    {
+        bool running = false;
+        for (size_t i = 0; i < aProcesses.size(); ++i)
         {
-            videoCodec.command = "-y -f image2pipe -framerate $ifps -vcodec $icodec -i - -b:v $obps -r $ofps $opath";
+            QProcess& process = *aProcesses[i];
+            if (process.state() != QProcess::NotRunning)
+            {
+                process.waitForFinished(kMSec / (int)aProcesses.size() + 1);
+            }
+
+            // a child reports "progress <percentage>" lines
+            while (process.canReadLine())
+            {
+                const QString line = QString(process.readLine()).trimmed();
+                if (line.startsWith("progress "))
+                {
+                    progresses[i] = line.mid(9).toInt();
+                }
+            }
+
+            if (process.state() != QProcess::NotRunning)
+            {
+                running = true;
+            }
+            else if (!finished[i])
+            {
+                finished[i] = true;
+
+                // the others are useless once a shard failed
+                if (hasFailed(process))
+                {
+                    const QString error(process.readAllStandardError());
+                    killAll();
+                    mLog = "A child process of the export failed.\n" + error;
+                    return Result(ResultCode_UnclassfiedError, mLog);
+                }
+            }
         }
-        videoCodec.command.replace(QRegExp("\\$ifps(\\s|$)"), QString::number(mCommonParam.fps) + "\\1");
-        videoCodec.command.replace(QRegExp("\\$icodec(\\s|$)"), videoCodec.icodec + "\\1");
-        videoCodec.command.replace(QRegExp("\\$obps(\\s|$)"), QString::number(aVideo.bps) + "\\1");
-        videoCodec.command.replace(QRegExp("\\$ofps(\\s|$)"), QString::number(mCommonParam.fps) + "\\1");
-        videoCodec.command.replace(QRegExp("\\$ocodec(\\s|$)"), videoCodec.name + "\\1");
-        videoCodec.command.replace(QRegExp("\\$opath(\\s|$)"), outPath + "\\1");
-        videoCodec.command.replace(QRegExp("\\$pixfmt(\\s|$)"), aVideo.pixfmt + "\\1");
-        videoCodec.command.replace(QRegExp("\\$arg_colorfilter(\\s|$)"), (colorIndex == 0 ? QString("-vf colormatrix=bt601:bt709") : QString("")) + "\\1");
-        videoCodec.command.replace(QRegExp("\\$arg_colorspace(\\s|$)"), QString("-colorspace ") + (colorIndex == 0 ? QString("bt709") : QString("smpte170m")) + "\\1");
-
-        qDebug() << videoCodec.command;
-
-        if (!mFFMpeg.start(videoCodec.command))
+
+        if (mProgressReporter)
         {
-            mLog = "FFmpeg error occurred.\n" + mFFMpeg.errorString();
-            return mFFMpeg.errorCode() == QProcess::FailedToStart ?
-                        Result(ResultCode_FFMpegFailedToStart, mLog) :
-                        Result(ResultCode_FFMpegError, mLog);
+            double done = 0.0;
+            for (size_t i = 0; i < aProcesses.size(); ++i)
+            {
+                done += aSizes[i] * progresses[i] * 0.01;
+            }
+            mProgress = total > 0 ? (float)(done / total) : 1.0f;
+            mProgressReporter->setProgress((int)(100 * mProgress));
+
+            if (mProgressReporter->wasCanceled())
+            {
+                killAll();
+                mLog = "Export was canceled.";
+                mIsCanceled = true;
+                return Result(ResultCode_Canceled, mLog);
+            }
         }
+
+        if (!running) break;
     }
-#endif
 
-    return execute();
+    return Result(ResultCode_Success, "Success.");
 }
 
 Exporter::Result Exporter::execute()
@@ -468,8 +864,10 @@ Exporter::Result Exporter::execute()
 Exporter::Result Exporter::start()
 {
     // reset value
-    mIndex = 0;
+    mIndex = mIsShard ? mShardParam.index.min() : 0;
     mProgress = 0.0f;
+    mHasLastFrame = false;
+    mDuplicatedFrameCount = 0;
     mDigitCount = getDigitCount(
                 mCommonParam.frame,
                 mCommonParam.fps,
@@ -486,16 +884,33 @@ Exporter::Result Exporter::start()
             Result(ResultCode_UnclassfiedError, mLog);
         }
 
+        // decide the size of render targets
+        decideTiling(mProject.attribute().imageSize(), mCommonParam.size);
+        const QSize renderSize = mTileSize.isEmpty() ?
+                    mProject.attribute().imageSize() : mTileRenderSize;
+        const QSize outputSize = mTileSize.isEmpty() ?
+                    mCommonParam.size : mTileSize;
+
         // framebuffers
-        createFramebuffers(mProject.attribute().imageSize(), mCommonParam.size);
+        createFramebuffers(renderSize, outputSize);
 
         // clipping frame
         mClippingFrame.reset(new core::ClippingFrame());
-        mClippingFrame->resize(mProject.attribute().imageSize());
+        mClippingFrame->resize(renderSize);
 
         // create texturizer for destination colors of the framebuffer
         mDestinationTexturizer.reset(new core::DestinationTexturizer());
-        mDestinationTexturizer->resize(mProject.attribute().imageSize());
+        mDestinationTexturizer->resize(renderSize);
+    }
+
+    // keep all frames of the export
+    auto profiler = gl::Profiler::instance();
+    if (profiler && !mProfileDumpPath.isEmpty())
+    {
+        mProfiling = true;
+        mProfileHistoryCapacity = profiler->historyCapacity();
+        profiler->clear();
+        profiler->setHistoryCapacity(0);
     }
 
     mExporting = true;
@@ -519,9 +934,20 @@ bool Exporter::updateTime(core::TimeInfo& aDst)
     {
         return false;
     }
+    if (mIsShard && mShardParam.index.max() < mIndex)
+    {
+        return false;
+    }
 
     aDst.frame = core::Frame::fromDecimal(frame);
-    mProgress = (float)current / range;
+    if (mIsShard)
+    {
+        mProgress = (float)(mIndex - mShardParam.index.min()) / (mShardParam.index.diff() + 1);
+    }
+    else
+    {
+        mProgress = (float)current / range;
+    }
 
     // to next index
     ++mIndex;
@@ -548,7 +974,90 @@ bool Exporter::update()
     // begin rendering
     gl::Global::makeCurrent();
     gl::Global::Functions& ggl = gl::Global::functions();
-    const QSize originSize = mProject.attribute().imageSize();
+
+    auto profiler = mProfiling ? gl::Profiler::instance() : nullptr;
+    if (profiler) profiler->beginFrame("export " + QString::number(currentIndex));
+    util::Finally frameEnder([=]() { if (profiler) profiler->endFrame(); });
+
+    // reuse the last frame while the scene is held
+    if (mProject.objectTree().topNode())
+    {
+        const quint64 hash = hashSceneState(*mProject.objectTree().topNode(), timeInfo);
+        const bool isHeld = mHasLastFrame && hash == mLastFrameHash;
+        mLastFrameHash = hash;
+
+        if (isHeld)
+        {
+            updateLog();
+            gl::ProfileScope profile("pipeline", "duplicate");
+            ++mDuplicatedFrameCount;
+            return exportDuplicate(currentIndex);
+        }
+    }
+
+    {
+        // create image
+        const QImage outImage = mTileSize.isEmpty() ?
+                    renderWhole(timeInfo) : renderTiles(timeInfo);
+
+        // flush
+        ggl.glFlush();
+
+        // update log if necessary
+        updateLog();
+
+        // export
+        gl::ProfileScope profile("pipeline", "encode");
+        if (!exportImage(outImage, currentIndex))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Exporter::decideTiling(const QSize& aOriginSize, const QSize& aExportSize)
+{
+    mTileSize = QSize();
+    mTileRenderSize = QSize();
+    mTileOverlap = 0;
+
+    int limit = kMaxUntiledSide;
+    if (gl::DeviceInfo::validInstanceExists())
+    {
+        auto& info = gl::DeviceInfo::instance();
+        limit = std::min(limit, (int)std::min(info.maxTextureSize, info.maxRenderBufferSize));
+    }
+
+    const int maxSide = std::max(
+                std::max(aOriginSize.width(), aOriginSize.height()),
+                std::max(aExportSize.width(), aExportSize.height()));
+    if (mCommonParam.tileSize <= 0 && maxSide <= limit)
+    {
+        return;
+    }
+
+    const double scaleX = aExportSize.width() / (double)aOriginSize.width();
+    const double scaleY = aExportSize.height() / (double)aOriginSize.height();
+    const double scaleMin = std::min(scaleX, scaleY);
+    mTileOverlap = (int)std::ceil(kTileOverlap / scaleMin);
+
+    // render size of a tile must be in the limit
+    const int tileMax = (int)((limit - 2 * mTileOverlap - 1) * scaleMin);
+    const int tileSize = std::max(std::min(
+                mCommonParam.tileSize > 0 ? mCommonParam.tileSize : kDefaultTileSize, tileMax), 16);
+
+    // every tile is rendered by the same size which covers overlaps
+    mTileSize = QSize(tileSize, tileSize);
+    mTileRenderSize = QSize(
+                (int)std::ceil(tileSize / scaleX) + 2 * mTileOverlap + 1,
+                (int)std::ceil(tileSize / scaleY) + 2 * mTileOverlap + 1);
+}
+
+void Exporter::renderCanvas(const core::TimeInfo& aTime, const core::CameraInfo& aCamera)
+{
+    QOpenGLFramebufferObject& framebuffer = *mFramebuffers.front();
 
     // clear clipping
     mClippingFrame->clearTexture();
@@ -558,22 +1067,22 @@ bool Exporter::update()
     mDestinationTexturizer->clearTexture();
 
     // bind framebuffer
-    if (!mFramebuffers.front()->bind())
+    if (!framebuffer.bind())
     {
         XC_FATAL_ERROR("OpenGL Error", "Failed to bind framebuffer.", "");
     }
 
     // setup
-    gl::Util::setViewportAsActualPixels(originSize);
+    gl::Util::setViewportAsActualPixels(aCamera.deviceScreenSize());
     gl::Util::clearColorBuffer(0.0, 0.0, 0.0, 0.0);
     gl::Util::resetRenderState();
 
     // render
     core::RenderInfo renderInfo;
-    renderInfo.camera.reset(originSize, 1.0, originSize, QPoint());
-    renderInfo.time = timeInfo;
-    renderInfo.framebuffer = mFramebuffers.front()->handle();
-    renderInfo.dest = mFramebuffers.front()->texture();
+    renderInfo.camera = aCamera;
+    renderInfo.time = aTime;
+    renderInfo.framebuffer = framebuffer.handle();
+    renderInfo.dest = framebuffer.texture();
     renderInfo.isGrid = false;
     renderInfo.clippingId = 0;
     renderInfo.clippingFrame = mClippingFrame.data();
@@ -584,50 +1093,112 @@ bool Exporter::update()
     mProject.objectTree().render(renderInfo, true);
 
     // unbind framebuffer
-    if (!mFramebuffers.front()->release())
+    if (!framebuffer.release())
     {
         XC_FATAL_ERROR("OpenGL Error", "Failed to bind framebuffer.", "");
     }
+}
 
-    // scaling
+void Exporter::scaleFramebuffers(const QRectF& aSrcRect, const QSize& aDstSize)
+{
+    gl::ProfileScope profile("pipeline", "scaling", true);
+    QRectF srcRect = aSrcRect;
+    QOpenGLFramebufferObject* prev = nullptr;
+    for (auto& fbo : mFramebuffers)
     {
-        QOpenGLFramebufferObject* prev = nullptr;
-        for (auto& fbo : mFramebuffers)
+        if (prev)
         {
-            if (prev)
-            {
-                fbo->bind();
+            fbo->bind();
 
-                const QSize size = fbo->size();
-                gl::Util::setViewportAsActualPixels(size);
-                gl::Util::clearColorBuffer(0.0, 0.0, 0.0, 0.0);
+            const QSize prevSize = prev->size();
+            const QSize size = fbo->size();
+            gl::Util::setViewportAsActualPixels(size);
+            gl::Util::clearColorBuffer(0.0, 0.0, 0.0, 0.0);
 
+            if (fbo == mFramebuffers.back())
+            {
+                // the source rect to the left top of the last buffer
+                mTextureDrawer.draw(prev->texture(), QRectF(QPointF(), QSizeF(aDstSize)), size,
+                                    srcRect, prevSize);
+            }
+            else
+            {
                 mTextureDrawer.draw(prev->texture());
 
-                fbo->release();
+                const double scaleX = size.width() / (double)prevSize.width();
+                const double scaleY = size.height() / (double)prevSize.height();
+                srcRect = QRectF(srcRect.x() * scaleX, srcRect.y() * scaleY,
+                                 srcRect.width() * scaleX, srcRect.height() * scaleY);
             }
-            prev = fbo.get();
+
+            fbo->release();
         }
+        prev = fbo.get();
     }
+}
 
-    {
-        // create image
-        auto outImage = mFramebuffers.back()->toImage();
+QImage Exporter::renderWhole(const core::TimeInfo& aTime)
+{
+    const QSize originSize = mProject.attribute().imageSize();
 
-        // flush
-        ggl.glFlush();
+    core::CameraInfo camera;
+    camera.reset(originSize, 1.0, originSize, QPoint());
+    renderCanvas(aTime, camera);
 
-        // update log if necessary
-        updateLog();
+    // scaling
+    scaleFramebuffers(QRectF(QPointF(), QSizeF(originSize)), mCommonParam.size);
 
-        // export
-        if (!exportImage(outImage, currentIndex))
+    gl::ProfileScope profile("pipeline", "readback");
+    return mFramebuffers.back()->toImage();
+}
+
+QImage Exporter::renderTiles(const core::TimeInfo& aTime)
+{
+    const QSize originSize = mProject.attribute().imageSize();
+    const QSize exportSize = mCommonParam.size;
+    const double scaleX = exportSize.width() / (double)originSize.width();
+    const double scaleY = exportSize.height() / (double)originSize.height();
+
+    for (int y = 0; y < exportSize.height(); y += mTileSize.height())
+    {
+        for (int x = 0; x < exportSize.width(); x += mTileSize.width())
         {
-            return false;
+            const QRect tile(x, y,
+                             std::min(mTileSize.width(), exportSize.width() - x),
+                             std::min(mTileSize.height(), exportSize.height() - y));
+
+            // the region of the tile on the origin image
+            const QRectF region(tile.x() / scaleX, tile.y() / scaleY,
+                                tile.width() / scaleX, tile.height() / scaleY);
+            const QPoint renderPos((int)std::floor(region.x()) - mTileOverlap,
+                                   (int)std::floor(region.y()) - mTileOverlap);
+
+            // render with the camera which is shifted to the tile
+            core::CameraInfo camera;
+            camera.reset(mTileRenderSize, 1.0, originSize, -renderPos);
+            renderCanvas(aTime, camera);
+
+            // scaling
+            scaleFramebuffers(region.translated(-renderPos), tile.size());
+
+            // readback and copy rows of the tile
+            gl::ProfileScope profile("pipeline", "readback");
+            const QImage tileImage = mFramebuffers.back()->toImage();
+            if (mTiledImage.size() != exportSize || mTiledImage.format() != tileImage.format())
+            {
+                mTiledImage = QImage(exportSize, tileImage.format());
+            }
+
+            const int pixelBytes = tileImage.depth() / 8;
+            const size_t rowBytes = (size_t)(tile.width() * pixelBytes);
+            for (int i = 0; i < tile.height(); ++i)
+            {
+                memcpy(mTiledImage.scanLine(tile.y() + i) + tile.x() * pixelBytes,
+                       tileImage.constScanLine(i), rowBytes);
+            }
         }
     }
-
-    return true;
+    return mTiledImage;
 }
 
 bool Exporter::exportImage(const QImage& aFboImage, int aIndex)
@@ -648,6 +1219,7 @@ bool Exporter::exportImage(const QImage& aFboImage, int aIndex)
         //aFboImage.save(&buffer, "PPM");
         buffer.close();
         mFFMpeg.write(byteArray);
+        mLastFrameBytes = byteArray;
 
         if (mFFMpeg.errorOccurred())
         {
@@ -661,8 +1233,44 @@ bool Exporter::exportImage(const QImage& aFboImage, int aIndex)
         //             aFboImage.height(), QImage::Format_ARGB32);
         //image.save(aFilePath);
         aFboImage.save(filePath.filePath(), Q_NULLPTR, mImageParam.quality);
+        mLastFramePath = filePath.filePath();
     }
 
+    mHasLastFrame = true;
+    return true;
+}
+
+bool Exporter::exportDuplicate(int aIndex)
+{
+    XC_ASSERT(mHasLastFrame);
+
+    if (mVideoExporting)
+    {
+        // the encoded frame is sent again
+        mFFMpeg.write(mLastFrameBytes);
+
+        if (mFFMpeg.errorOccurred())
+        {
+            mLog = "FFmpeg error occurred.\n" + mFFMpeg.errorString();
+            return false;
+        }
+    }
+    else
+    {
+        QFileInfo filePath;
+        if (!decideImagePath(aIndex, filePath))
+        {
+            return false;
+        }
+
+        // copy the last file
+        QFile::remove(filePath.filePath());
+        if (!QFile::copy(mLastFramePath, filePath.filePath()))
+        {
+            mLog = "Failed to copy a file. " + filePath.filePath();
+            return false;
+        }
+    }
     return true;
 }
 
@@ -689,9 +1297,34 @@ Exporter::Result Exporter::finish()
 
         mExporting = false;
     }
+    mTiledImage = QImage();
+    mLastFrameBytes.clear();
+    mHasLastFrame = false;
+
+    if (mProfiling)
+    {
+        dumpProfile();
+    }
     return result;
 }
 
+void Exporter::dumpProfile()
+{
+    mProfiling = false;
+
+    auto profiler = gl::Profiler::instance();
+    if (!profiler) return;
+
+    gl::Global::makeCurrent();
+    profiler->resolve(true);
+    if (!profiler->writeChromeTrace(mProfileDumpPath))
+    {
+        XC_REPORT() << "Failed to write a profile." << mProfileDumpPath;
+    }
+    profiler->clear();
+    profiler->setHistoryCapacity(mProfileHistoryCapacity);
+}
+
 void Exporter::destroyFramebuffers()
 {
     for (auto& fbo : mFramebuffers)
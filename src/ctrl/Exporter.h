@@ -2,6 +2,7 @@
 #define CTRL_EXPORTER_H
 
 #include <list>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <QString>
@@ -55,6 +56,9 @@ public:
         QSize size;
         util::Range frame;
         int fps;
+        // side length of render tiles in export pixels.
+        // (zero means that tiles are used only for frames over the gpu limit)
+        int tileSize;
         bool isValid() const;
     };
 
@@ -83,19 +87,37 @@ public:
         int quality;
     };
 
+    // a part of an export which is rendered by a child process
+    struct ShardParam
+    {
+        ShardParam();
+        util::Range index; ///< export indices
+        QString videoCommand; ///< empty if exporting images
+        QString videoInCodec;
+    };
+
     Exporter(core::Project& aProject);
     ~Exporter();
 
     void setOverwriteConfirmer(const OverwriteConfirmer& aConfirmer);
     void setProgressReporter(util::IProgressReporter& aReporter);
     void setUILogger(ctrl::UILogger& aLogger);
+    // dump a chrome trace of the export if a gl::Profiler exists
+    void setProfileDumpPath(const QString& aPath);
+    // the number of child processes which render frames in parallel.
+    // (zero means the ideal thread count, one means rendering in this process)
+    void setShardCount(int aCount);
 
     Result execute(const CommonParam& aCommon, const ImageParam& aImage);
     Result execute(const CommonParam& aCommon, const GifParam& aGif);
     Result execute(const CommonParam& aCommon, const VideoParam& aVideo);
+    Result executeShard(const CommonParam& aCommon, const ImageParam& aImage,
+                        const ShardParam& aShard);
 
     const QString& log() const { return mLog; }
     bool isCanceled() const { return mIsCanceled; }
+    // the number of frames which reused the last one on this process
+    int duplicatedFrameCount() const { return mDuplicatedFrameCount; }
 
 private:
     typedef std::unique_ptr<QOpenGLFramebufferObject> FramebufferPtr;
@@ -124,11 +146,25 @@ private:
     };
 
     Result execute();
+    Result executeVideo(const QString& aCommand, const QString& aInCodec);
+    Result executeShards(int aCount, const VideoParam* aVideo);
+    Result waitShards(std::vector<std::unique_ptr<QProcess>>& aProcesses,
+                      const std::vector<int>& aSizes);
+    QString makeVideoCommand(const VideoParam& aVideo, const QString& aOutPath,
+                             QString& aInCodec) const;
+    int decideShardCount() const;
+    int getIndexCount() const;
     Result start();
     bool update();
     Result finish();
     bool updateTime(core::TimeInfo& aDst);
+    void decideTiling(const QSize& aOriginSize, const QSize& aExportSize);
+    void renderCanvas(const core::TimeInfo& aTime, const core::CameraInfo& aCamera);
+    void scaleFramebuffers(const QRectF& aSrcRect, const QSize& aDstSize);
+    QImage renderWhole(const core::TimeInfo& aTime);
+    QImage renderTiles(const core::TimeInfo& aTime);
     bool exportImage(const QImage& aFboImage, int aIndex);
+    bool exportDuplicate(int aIndex);
     void destroyFramebuffers();
     void createFramebuffers(const QSize& aOriginSize, const QSize& aExportSize);
     void setTextureParam(QOpenGLFramebufferObject& aFbo);
@@ -136,23 +172,41 @@ private:
     bool decideImagePath(int aIndex, QFileInfo& aPath);
     bool checkOverwriting(const QFileInfo& aPath);
     void updateLog();
+    void dumpProfile();
 
     core::Project& mProject;
     FramebufferList mFramebuffers;
     QScopedPointer<core::ClippingFrame> mClippingFrame;
     QScopedPointer<core::DestinationTexturizer> mDestinationTexturizer;
     gl::EasyTextureDrawer mTextureDrawer;
+    QSize mTileSize;
+    QSize mTileRenderSize;
+    int mTileOverlap;
+    QImage mTiledImage;
     core::TimeInfo mOriginTimeInfo;
     OverwriteConfirmer mOverwriteConfirmer;
     bool mOverwriteConfirmation;
     util::IProgressReporter* mProgressReporter;
     ctrl::UILogger* mUILogger;
+    QString mProfileDumpPath;
+    bool mProfiling;
+    int mProfileHistoryCapacity;
+    int mShardCount;
 
     CommonParam mCommonParam;
     ImageParam mImageParam;
     const char* mVideoInCodec;
     int mVideoInCodecQuality;
     bool mVideoExporting;
+    ShardParam mShardParam;
+    bool mIsShard;
+
+    // a cache of the last frame for held poses
+    bool mHasLastFrame;
+    quint64 mLastFrameHash;
+    QByteArray mLastFrameBytes;
+    QString mLastFramePath;
+    int mDuplicatedFrameCount;
 
     FFMpeg mFFMpeg;
     bool mExporting;
@@ -5,12 +5,27 @@
 namespace ctrl
 {
 
+//-------------------------------------------------------------------------------------------------
+ProjectSaver::Snapshot::Snapshot(const core::Project& aProject)
+    : mAttribute(aProject.attribute())
+    , mResources(aProject.resourceHolder())
+    , mObjectTree(aProject.objectTree())
+{
+}
+
+//-------------------------------------------------------------------------------------------------
 ProjectSaver::ProjectSaver()
     : mLog()
 {
 }
 
 bool ProjectSaver::save(const QString& aFilePath, const core::Project& aProject)
+{
+    return save(aFilePath, Snapshot(aProject));
+}
+
+bool ProjectSaver::save(const QString& aFilePath, const Snapshot& aSnapshot,
+                        util::IProgressReporter* aReporter)
 {
     std::ofstream file(aFilePath.toLocal8Bit(), std::ios::out | std::ios::binary);
 
@@ -28,7 +43,7 @@ bool ProjectSaver::save(const QString& aFilePath, const core::Project& aProject)
         return false;
     }
 
-    if (!writeGlobalBlock(out, aProject))
+    if (!writeGlobalBlock(out, aSnapshot.mAttribute))
     {
         mLog = "Failed to write global block.";
         return false;
@@ -36,14 +51,13 @@ bool ProjectSaver::save(const QString& aFilePath, const core::Project& aProject)
 
     core::Serializer serializer(out);
 
-    if (!aProject.resourceHolder().serialize(serializer))
+    if (!aSnapshot.mResources.serialize(serializer, aReporter))
     {
         mLog = "Failed to write resources block.";
         return false;
     }
 
-    // write object tree
-    if (!aProject.objectTree().serialize(serializer))
+    if (!aSnapshot.mObjectTree.serialize(serializer))
     {
         mLog = "Failed to write object tree block.";
         return false;
@@ -75,16 +89,16 @@ bool ProjectSaver::writeHeader(util::StreamWriter& aOut)
     return !aOut.isFailed();
 }
 
-bool ProjectSaver::writeGlobalBlock(util::StreamWriter& aOut, const core::Project& aProject)
+bool ProjectSaver::writeGlobalBlock(util::StreamWriter& aOut, const core::Project::Attribute& aAttribute)
 {
     static const std::array<sint8, 4> kSignature{ 'G', 'L', 'B', 'L' };
     static const uint32 kBlockLength = 64;
     static const int kReserveSize = 47;
 
-    const QSize imageSize = aProject.attribute().imageSize();
-    const int maxFrame = aProject.attribute().maxFrame();
-    const int fps = aProject.attribute().fps();
-    const bool loop = aProject.attribute().loop();
+    const QSize imageSize = aAttribute.imageSize();
+    const int maxFrame = aAttribute.maxFrame();
+    const int fps = aAttribute.fps();
+    const bool loop = aAttribute.loop();
     XC_ASSERT(maxFrame > 0);
     XC_ASSERT(fps > 0);
 
@@ -3,7 +3,10 @@
 
 #include <QString>
 #include "util/StreamWriter.h"
+#include "util/IProgressReporter.h"
 #include "core/Project.h"
+#include "core/ResourceSnapshot.h"
+#include "core/ObjectTreeSnapshot.h"
 
 namespace ctrl
 {
@@ -11,13 +14,32 @@ namespace ctrl
 class ProjectSaver
 {
 public:
+    // An immutable copy of a project. (create it on the main thread)
+    // Nothing is serialized at creation, all blocks are written by save().
+    class Snapshot
+    {
+    public:
+        Snapshot(const core::Project& aProject);
+
+    private:
+        friend class ProjectSaver;
+        core::Project::Attribute mAttribute;
+        core::ResourceSnapshot mResources;
+        core::ObjectTreeSnapshot mObjectTree;
+    };
+
     ProjectSaver();
     bool save(const QString& aFilePath, const core::Project& aProject);
+
+    // it's allowed to call this on a worker thread
+    bool save(const QString& aFilePath, const Snapshot& aSnapshot,
+              util::IProgressReporter* aReporter = nullptr);
+
     QString log() const { return mLog; }
 
 private:
     bool writeHeader(util::StreamWriter& aWriter);
-    bool writeGlobalBlock(util::StreamWriter& aWriter, const core::Project& aProject);
+    bool writeGlobalBlock(util::StreamWriter& aWriter, const core::Project::Attribute& aAttribute);
     QString mLog;
 };
 
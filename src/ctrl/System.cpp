@@ -1,5 +1,7 @@
+#include <atomic>
 #include <QDir>
 #include <QFile>
+#include <QThread>
 #include "gl/Global.h"
 #include "gl/DeviceInfo.h"
 #include "ctrl/System.h"
@@ -16,6 +18,67 @@ static const int kStandardFps = 60;
 
 namespace ctrl
 {
+//-------------------------------------------------------------------------------------------------
+class System::SaveTask
+        : public thr::Task
+        , public util::IProgressReporter
+{
+public:
+    SaveTask(core::Project& aProject, const QString& aCachePath)
+        : mProject(aProject)
+        , mCachePath(aCachePath)
+        , mOutputPath(aProject.fileName())
+        , mSnapshot(aProject)
+        , mEditingOrigin(aProject.commandStack().editingOrigin())
+        , mModificationCount(aProject.commandStack().modificationCount())
+        , mSuccess()
+        , mLog()
+        , mMaximum(0)
+        , mProgress(0)
+    {
+    }
+
+    core::Project& project() const { return mProject; }
+    const QString& cachePath() const { return mCachePath; }
+    const QString& outputPath() const { return mOutputPath; }
+    int editingOrigin() const { return mEditingOrigin; }
+    int modificationCount() const { return mModificationCount; }
+
+    // valid after finishing
+    bool success() const { return mSuccess; }
+    const QString& log() const { return mLog; }
+
+    int percentage() const
+    {
+        const int max = mMaximum;
+        return max > 0 ? (100 * (int)mProgress) / max : 0;
+    }
+
+    virtual void setSection(const QString&) {}
+    virtual void setMaximum(int aMax) { mMaximum = aMax; }
+    virtual void setProgress(int aValue) { mProgress = aValue; }
+    virtual bool wasCanceled() const { return false; }
+
+private:
+    virtual void run()
+    {
+        ctrl::ProjectSaver saver;
+        mSuccess = saver.save(mCachePath, mSnapshot, this);
+        mLog = saver.log();
+    }
+
+    core::Project& mProject;
+    QString mCachePath;
+    QString mOutputPath;
+    ctrl::ProjectSaver::Snapshot mSnapshot;
+    int mEditingOrigin;
+    int mModificationCount;
+    bool mSuccess;
+    QString mLog;
+    std::atomic<int> mMaximum;
+    std::atomic<int> mProgress;
+};
+
 //-------------------------------------------------------------------------------------------------
 System::SaveResult::SaveResult()
     : success()
@@ -64,7 +127,10 @@ System::System(const QString& aResourceDir, const QString& aCacheDir)
     , mCacheDir(aCacheDir)
     , mProjects()
     , mAnimator()
+    , mSaveThread(1)
+    , mSaveTask()
 {
+    mSaveThread.start(QThread::LowPriority);
 }
 
 System::~System()
@@ -151,6 +217,26 @@ System::LoadResult System::openProject(
 
 System::SaveResult System::saveProject(core::Project& aProject)
 {
+    auto result = beginSaving(aProject);
+    if (!result)
+    {
+        return result;
+    }
+    return endSaving();
+}
+
+System::SaveResult System::beginSaving(core::Project& aProject)
+{
+    // only one cache file exists
+    if (mSaveTask)
+    {
+        auto result = endSaving();
+        if (!result)
+        {
+            return result;
+        }
+    }
+
     const int index = mProjects.indexOf(&aProject);
 
     if (index < 0 || mProjects.count() <= index)
@@ -162,37 +248,73 @@ System::SaveResult System::saveProject(core::Project& aProject)
 
     if (project && !project->isNameless())
     {
-        const QString outputPath = project->fileName();
-        const QString cachePath = mCacheDir + "/lastproject.cache";
-
         // create cache directory
         if (!makeSureCacheDirectory(mCacheDir))
         {
             return SaveResult(false, "Failed to create cache directory.");
         }
 
-        ctrl::ProjectSaver saver;
+        // take a snapshot here, and write it on the worker
+        mSaveTask.reset(new SaveTask(*project, mCacheDir + "/lastproject.cache"));
+        mSaveThread.push(*mSaveTask);
+        mSaveThread.wakeAll();
+        return SaveResult(true, "Success.");
+    }
 
-        if (!saver.save(cachePath, *project))
-        {
-            return SaveResult(false, "Failed to save project. (" + saver.log() + ")");
-        }
+    return SaveResult(false, "Invalid operation.");
+}
 
-        if (!safeRename(cachePath, outputPath))
-        {
-            return SaveResult(false, "Failed to rename the project file.");
-        }
+System::SaveResult System::endSaving()
+{
+    if (!mSaveTask)
+    {
+        return SaveResult(false, "Invalid operation.");
+    }
 
-        project->commandStack().resetEditingOrigin();
-        qDebug() << "save the project file. " << outputPath;
-        return SaveResult(true, "Success.");
+    QScopedPointer<SaveTask> task(mSaveTask.take());
+
+    // a pushed task is idle until a worker takes it
+    task->waitFinish();
+
+    if (!task->success())
+    {
+        return SaveResult(false, "Failed to save project. (" + task->log() + ")");
     }
 
-    return SaveResult(false, "Invalid operation.");
+    if (!safeRename(task->cachePath(), task->outputPath()))
+    {
+        return SaveResult(false, "Failed to rename the project file.");
+    }
+
+    // edits after the snapshot are still remaining
+    task->project().commandStack().resetEditingOrigin(
+                task->editingOrigin(), task->modificationCount());
+    qDebug() << "save the project file. " << task->outputPath();
+    return SaveResult(true, "Success.");
+}
+
+bool System::isSavingFinished() const
+{
+    return mSaveTask && mSaveTask->isFinished();
+}
+
+int System::savingProgress() const
+{
+    return mSaveTask ? mSaveTask->percentage() : 0;
+}
+
+const core::Project* System::savingProject() const
+{
+    return mSaveTask ? &mSaveTask->project() : nullptr;
 }
 
 bool System::closeProject(core::Project& aProject)
 {
+    if (savingProject() == &aProject)
+    {
+        endSaving();
+    }
+
     const int index = mProjects.indexOf(&aProject);
 
     if (0 <= index && index < mProjects.count())
@@ -207,6 +329,11 @@ bool System::closeProject(core::Project& aProject)
 
 void System::closeAllProjects()
 {
+    if (mSaveTask)
+    {
+        endSaving();
+    }
+
     qDeleteAll(mProjects);
     mProjects.clear();
 }
@@ -2,8 +2,10 @@
 #define CTRL_SYSTEM_H
 
 #include <QString>
+#include <QScopedPointer>
 #include "util/NonCopyable.h"
 #include "util/IProgressReporter.h"
+#include "thr/Paralleler.h"
 #include "gl/DeviceInfo.h"
 #include "core/Project.h"
 
@@ -52,6 +54,15 @@ public:
 
     SaveResult saveProject(core::Project& aProject);
 
+    // save a project on a worker thread
+    // The project can be edited until endSaving(), which renames the file.
+    SaveResult beginSaving(core::Project& aProject);
+    SaveResult endSaving(); // wait for finishing
+    bool isSaving() const { return !mSaveTask.isNull(); }
+    bool isSavingFinished() const;
+    int savingProgress() const; // percentage
+    const core::Project* savingProject() const;
+
     bool closeProject(core::Project& aProject);
 
     void closeAllProjects();
@@ -64,6 +75,8 @@ public:
     const core::Project* project(int aIndex) const;
 
 private:
+    class SaveTask;
+
     static bool makeSureCacheDirectory(const QString& aCacheDir);
     static bool safeRename(const QString& aSrc, const QString& aDst);
 
@@ -71,6 +84,8 @@ private:
     const QString mCacheDir;
     QVector<core::Project*> mProjects;
     core::Animator* mAnimator;
+    thr::Paralleler mSaveThread;
+    QScopedPointer<SaveTask> mSaveTask;
 };
 
 } // namespace ctrl
@@ -32,7 +32,8 @@ TimeLineEditor::TimeLineEditor()
     , mState(State_Standby)
     , mTimeCurrent(kTimeLineMargin)
     , mTimeScale()
-    , mFocus(mRows, mTimeScale, kTimeLineMargin)
+    , mKeySummary()
+    , mFocus(mRows, mTimeScale, mKeySummary, kTimeLineMargin)
     , mMoveRef()
     , mMoveFrame()
     , mOnUpdatingKey(false)
@@ -63,6 +64,7 @@ void TimeLineEditor::setMaxFrame(int aValue)
 void TimeLineEditor::setProject(Project* aProject)
 {
     clearRows();
+    mKeySummary.clear();
     mProject.reset();
 
     if (aProject)
@@ -108,14 +110,21 @@ void TimeLineEditor::updateRowSelection(const core::ObjectNode* aRepresent)
     }
 }
 
-void TimeLineEditor::updateKey()
+void TimeLineEditor::updateKey(const core::TimeLineEvent& aEvent)
 {
+    mKeySummary.update(aEvent);
+
     if (!mOnUpdatingKey)
     {
         clearState();
     }
 }
 
+void TimeLineEditor::updateTree()
+{
+    mKeySummary.clear();
+}
+
 void TimeLineEditor::updateProjectAttribute()
 {
     clearState();
@@ -305,6 +314,7 @@ bool TimeLineEditor::modifyMoveKeys(const QPoint& aWorldPos)
 
         mOnUpdatingKey = true;
         int clampedAdd = addFrame;
+        mProject->commandStack().markModified();
         if (mMoveRef->modifyMove(modEvent, addFrame, util::Range(0, mTimeMax), &clampedAdd))
         {
             mMoveFrame = newFrame;
@@ -508,6 +518,7 @@ void TimeLineEditor::render(QPainter& aPainter, const CameraInfo& aCamera, const
     renderer.setMargin(margin);
     renderer.setRange(util::Range(bgn, end));
     renderer.setTimeScale(mTimeScale);
+    renderer.setKeySummary(mKeySummary);
 
     renderer.renderLines(mRows, camRect, cullRect);
     renderer.renderHeader(kHeaderHeight, kTimeLineFpsA);
@@ -17,6 +17,7 @@
 #include "ctrl/time/time_Current.h"
 #include "ctrl/time/time_Scaler.h"
 #include "ctrl/time/time_Focuser.h"
+#include "ctrl/time/time_KeySummary.h"
 
 namespace ctrl
 {
@@ -40,7 +41,8 @@ public:
 
     UpdateFlags updateCursor(const core::AbstractCursor& aCursor);
     void updateWheel(int aDelta, bool aInvertScaling);
-    void updateKey();
+    void updateKey(const core::TimeLineEvent& aEvent);
+    void updateTree();
     void updateProjectAttribute();
 
     void clearRows();
@@ -80,6 +82,7 @@ private:
     State mState;
     time::Current mTimeCurrent;
     time::Scaler mTimeScale;
+    time::KeySummary mKeySummary;
     time::Focuser mFocus;
 
     TimeLineUtil::MoveFrameOfKey* mMoveRef;
@@ -184,6 +184,7 @@ void EraseInflMode::assignInfluence(
     // modify
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
+        stack.markModified();
         mCommandRef->push(aTarget, aPrev, aNext);
     }
     else
@@ -203,7 +204,7 @@ void EraseInflMode::notifyAssign()
     // singleshot notify
     auto eventType = TimeLineEvent::Type_ChangeKeyValue;
     Notifier notifier(mProject, mTarget, *mKeyOwner.key, eventType);
-    notifier.notify();
+    notifier.queue();
 }
 
 } // namespace bone
@@ -132,11 +132,12 @@ void InfluenceMode::assignInfluence(core::Bone2& aTarget, int aIndex, const QVec
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
         XC_ASSERT(aIndex == mCommandRef->index());
+        stack.markModified();
         mCommandRef->modifyValue(aRange);
 
         // singleshot notify
         Notifier notifier(mProject, mTarget, *mKeyOwner.key, eventType);
-        notifier.notify();
+        notifier.queue();
     }
     else
     {
@@ -89,11 +89,12 @@ void MoveJointMode::moveBone(core::Bone2& aTarget, const QVector2D& aMove)
     // modify
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
+        stack.markModified();
         mCommandRef->modifyValue(nextPos);
 
         // singleshot notify
         Notifier notifier(mProject, mTarget, *mKeyOwner.key, eventType);
-        notifier.notify();
+        notifier.queue();
     }
     else
     {
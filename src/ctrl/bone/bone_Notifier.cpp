@@ -23,6 +23,31 @@ Notifier::Notifier(
 }
 
 void Notifier::notify(bool aIsUndo)
+{
+    updateBones();
+
+    // write bone influence map
+    mKey.resetCaches(mProject, mTarget);
+
+    // notify timeline modified
+    mProject.onTimeLineModified(mEvent, aIsUndo);
+}
+
+void Notifier::queue()
+{
+    updateBones();
+
+    // write bone influence map at once in the next flush
+    core::Project* project = &mProject;
+    core::ObjectNode* target = &mTarget;
+    core::BoneKey* key = &mKey;
+    mProject.queueTimeLineUpdater(key, [=]() { key->resetCaches(*project, *target); });
+
+    // notify timeline modified later
+    mProject.queueTimeLineEvent(mEvent);
+}
+
+void Notifier::updateBones()
 {
     // update pose keys
     for (auto child : mKey.children())
@@ -39,12 +64,6 @@ void Notifier::notify(bool aIsUndo)
 
     // create bone shape
     bone::GeoBuilder::build(mKey.data().topBones());
-
-    // write bone influence map
-    mKey.resetCaches(mProject, mTarget);
-
-    // notify timeline modified
-    mProject.onTimeLineModified(mEvent, aIsUndo);
 }
 
 } // namespace bone
@@ -147,6 +147,7 @@ void PaintInflMode::assignInfluence(
     // modify
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
+        stack.markModified();
         mCommandRef->push(aTarget, aPrev, aNext);
     }
     else
@@ -166,7 +167,7 @@ void PaintInflMode::notifyAssign()
     // singleshot notify
     auto eventType = TimeLineEvent::Type_ChangeKeyValue;
     Notifier notifier(mProject, mTarget, *mKeyOwner.key, eventType);
-    notifier.notify();
+    notifier.queue();
 }
 
 } // namespace bone
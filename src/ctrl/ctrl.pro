@@ -73,6 +73,7 @@ SOURCES += \
     ffd/ffd_Task.cpp \
     bone/bone_GeoBuilder.cpp \
     Exporter.cpp \
+    ExportShard.cpp \
     bone/bone_PaintInflMode.cpp \
     bone/bone_EraseInflMode.cpp \
     MeshEditor.cpp \
@@ -98,6 +99,7 @@ SOURCES += \
     Painter.cpp \
     KeyBinding.cpp \
     time/time_Focuser.cpp \
+    time/time_KeySummary.cpp \
     time/time_Renderer.cpp \
     time/time_Scaler.cpp \
     TimeLineRow.cpp \
@@ -155,6 +157,7 @@ HEADERS += \
     bone/bone_Target.h \
     pose/pose_Target.h \
     Exporter.h \
+    ExportShard.h \
     bone/bone_PaintInflMode.h \
     bone/bone_EraseInflMode.h \
     MeshEditor.h \
@@ -188,6 +191,7 @@ HEADERS += \
     Painter.h \
     KeyBinding.h \
     time/time_Focuser.h \
+    time/time_KeySummary.h \
     time/time_Renderer.h \
     time/time_Scaler.h \
     time/time_Current.h \
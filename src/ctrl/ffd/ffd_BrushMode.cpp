@@ -211,6 +211,7 @@ bool BrushMode::executeDrawTask(const QVector2D& aCenter, const QVector2D& aMove
         else
         {
             const bool modifiable = stack.isModifiable(mStatus.commandRef);
+            if (modifiable) stack.markModified();
             TimeLineEvent event;
             event.setType(TimeLineEvent::Type_ChangeKeyValue);
 
@@ -239,7 +240,7 @@ bool BrushMode::executeDrawTask(const QVector2D& aCenter, const QVector2D& aMove
             // notify
             if (event.targets().size())
             {
-                mProject.onTimeLineModified(event, false);
+                mProject.queueTimeLineEvent(event);
             }
 
             return modifiable;
@@ -240,13 +240,14 @@ void DragMode::assignDragging(const QVector2D& aMove)
     else
     {
         // modify value
+        stack.markModified();
         mCommandRef->modifyValue(newPos);
 
         // notify
         TimeLineEvent event;
         event.setType(TimeLineEvent::Type_ChangeKeyValue);
         event.pushTarget(*node, TimeKeyType_FFD, frame);
-        mProject.onTimeLineModified(event, false);
+        mProject.queueTimeLineEvent(event);
     }
 }
 
@@ -119,11 +119,12 @@ void CreateMode::moveVtx(MeshVtx& aVtx, const QVector2D& aPos)
     if (mMoverRef && mMoverRef->currentVtx() == &aVtx && stack.isModifiable(mMoverRef))
     {
         // modify
+        stack.markModified();
         mMoverRef->modify(aPos);
 
         // single shot
         Notifier notifier(mProject, mTarget, *mKeyOwner.key, eventType);
-        notifier.notify();
+        notifier.queue();
     }
     else
     {
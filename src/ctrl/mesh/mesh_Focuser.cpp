@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <QPolygonF>
 #include "util/CollDetect.h"
 #include "ctrl/mesh/mesh_Focuser.h"
@@ -6,6 +7,12 @@ namespace
 {
 static const float kVtxSqRadius = 8.0f * 8.0f;
 static const float kEdgeSqRadius = 8.0f * 8.0f;
+static const float kSearchRadius = 8.0f;
+
+QRectF getBoundingRect(const QVector2D& aPos0, const QVector2D& aPos1)
+{
+    return QRectF(aPos0.toPointF(), aPos1.toPointF()).normalized();
+}
 }
 
 namespace ctrl {
@@ -13,6 +20,12 @@ namespace mesh {
 
 Focuser::Focuser()
     : mMesh()
+    , mVtxGrid()
+    , mEdgeGrid()
+    , mFaceGrid()
+    , mIndexSpace()
+    , mIndexedData()
+    , mIndexedRevision()
     , mTargetMtx()
     , mFocus()
     , mFocusChanged()
@@ -24,6 +37,7 @@ Focuser::Focuser()
 void Focuser::setMesh(MeshAccessor& aMesh)
 {
     mMesh = &aMesh;
+    mIndexedData = nullptr;
 }
 
 void Focuser::setTargetMatrix(const QMatrix4x4& aMtx)
@@ -38,65 +52,135 @@ void Focuser::update(const core::CameraInfo& aCamera, const core::AbstractCursor
 
     if (!mMesh) return;
 
+    updateIndex();
+
     const QVector2D focusPos = aCursor.screenPos();
+    const QRectF searchRect = getModelRect(aCamera, focusPos, kSearchRadius);
 
     // vertex
     if (mEnable[0])
     {
-        for (auto& vtx : mMesh->vertices())
+        float nearest = kVtxSqRadius;
+        mVtxGrid.visit(searchRect, [&](MeshVtx* aVtx)
         {
-            const QVector2D vtxPos = getScreenPos(aCamera, vtx->vec());
-
-            if ((focusPos - vtxPos).lengthSquared() < kVtxSqRadius)
+            const QVector2D vtxPos = getScreenPos(aCamera, aVtx->vec());
+            const float distance = (focusPos - vtxPos).lengthSquared();
+            if (distance < nearest)
             {
-                mFocus.vtx = vtx;
-                updateFocusChanged(prev, mFocus);
-                return;
+                nearest = distance;
+                mFocus.vtx = aVtx;
             }
+            return true;
+        });
+
+        if (mFocus.vtx)
+        {
+            updateFocusChanged(prev, mFocus);
+            return;
         }
     }
 
     // edge
     if (mEnable[1])
     {
-        for (auto& edge : mMesh->edges())
+        float nearest = kEdgeSqRadius;
+        mEdgeGrid.visit(searchRect, [&](MeshEdge* aEdge)
         {
-            const QVector2D v0 = getScreenPos(aCamera, edge->vtx(0)->vec());
-            const QVector2D v1 = getScreenPos(aCamera, edge->vtx(1)->vec());
+            const QVector2D v0 = getScreenPos(aCamera, aEdge->vtx(0)->vec());
+            const QVector2D v1 = getScreenPos(aCamera, aEdge->vtx(1)->vec());
             auto c = util::CollDetect::getPosOnSegment(
                         util::Segment2D(v0, v1 - v0), focusPos);
-            if ((focusPos - c).lengthSquared() < kEdgeSqRadius)
+            const float distance = (focusPos - c).lengthSquared();
+            if (distance < nearest)
             {
-                mFocus.edge = edge;
-                updateFocusChanged(prev, mFocus);
-                return;
+                nearest = distance;
+                mFocus.edge = aEdge;
             }
+            return true;
+        });
+
+        if (mFocus.edge)
+        {
+            updateFocusChanged(prev, mFocus);
+            return;
         }
     }
 
     // face
     if (mEnable[2])
     {
-        for (auto& face : mMesh->faces())
+        // a face which contains the cursor overlaps the cell of the cursor
+        const QRectF pointRect(searchRect.center(), QSizeF());
+        QPolygonF poly(3);
+        mFaceGrid.visit(pointRect, [&](MeshFace* aFace)
         {
-            auto vtx = face->vertices();
-            QPolygonF poly;
-            poly.push_back(getScreenPos(aCamera, vtx[0]->vec()).toPointF());
-            poly.push_back(getScreenPos(aCamera, vtx[1]->vec()).toPointF());
-            poly.push_back(getScreenPos(aCamera, vtx[2]->vec()).toPointF());
+            auto vtx = aFace->vertices();
+            poly[0] = getScreenPos(aCamera, vtx[0]->vec()).toPointF();
+            poly[1] = getScreenPos(aCamera, vtx[1]->vec()).toPointF();
+            poly[2] = getScreenPos(aCamera, vtx[2]->vec()).toPointF();
 
             if (poly.containsPoint(focusPos.toPointF(), Qt::OddEvenFill))
             {
-                mFocus.face = face;
-                updateFocusChanged(prev, mFocus);
-                return;
+                mFocus.face = aFace;
+                return false;
             }
-        }
+            return true;
+        });
     }
 
     updateFocusChanged(prev, mFocus);
 }
 
+void Focuser::updateIndex()
+{
+    auto data = mMesh->data();
+    if (data && data == mIndexedData && data->revision() == mIndexedRevision) return;
+
+    mIndexedData = data;
+    mIndexedRevision = data ? data->revision() : 0;
+    mVtxGrid.clear();
+    mEdgeGrid.clear();
+    mFaceGrid.clear();
+    mIndexSpace = QRectF();
+
+    if (!data || data->vertices().isEmpty()) return;
+
+    // the bounds of the mesh
+    {
+        const QVector2D first = data->vertices().front()->vec();
+        QVector2D minPos = first;
+        QVector2D maxPos = first;
+        for (auto vtx : data->vertices())
+        {
+            minPos.setX(std::min(minPos.x(), vtx->x));
+            minPos.setY(std::min(minPos.y(), vtx->y));
+            maxPos.setX(std::max(maxPos.x(), vtx->x));
+            maxPos.setY(std::max(maxPos.y(), vtx->y));
+        }
+        mIndexSpace = getBoundingRect(minPos, maxPos);
+    }
+
+    mVtxGrid.reset(mIndexSpace, data->vertices().count());
+    for (auto vtx : data->vertices())
+    {
+        mVtxGrid.push(vtx, QRectF(vtx->vec().toPointF(), QSizeF()));
+    }
+
+    mEdgeGrid.reset(mIndexSpace, data->edges().count());
+    for (auto edge : data->edges())
+    {
+        mEdgeGrid.push(edge, getBoundingRect(edge->vtx(0)->vec(), edge->vtx(1)->vec()));
+    }
+
+    mFaceGrid.reset(mIndexSpace, data->faces().count());
+    for (auto face : data->faces())
+    {
+        auto vtx = face->vertices();
+        mFaceGrid.push(face, getBoundingRect(vtx[0]->vec(), vtx[1]->vec()).united(
+                           getBoundingRect(vtx[2]->vec(), vtx[2]->vec())));
+    }
+}
+
 void Focuser::updateFocusChanged(const Focus& aPrev, const Focus& aNext)
 {
     mFocusChanged =
@@ -111,6 +195,38 @@ QVector2D Focuser::getScreenPos(
     return aCamera.toScreenPos(mTargetMtx * QVector3D(aModelPos)).toVector2D();
 }
 
+QRectF Focuser::getModelRect(
+        const core::CameraInfo& aCamera, const QVector2D& aScreenPos, float aRadius) const
+{
+    bool invertible = false;
+    const QMatrix4x4 invMtx = mTargetMtx.inverted(&invertible);
+    if (!invertible) return mIndexSpace;
+
+    // the bounds of the corners of a screen square
+    QPointF minPos;
+    QPointF maxPos;
+    for (int i = 0; i < 4; ++i)
+    {
+        const QVector2D corner(
+                    aScreenPos.x() + ((i & 1) ? aRadius : -aRadius),
+                    aScreenPos.y() + ((i & 2) ? aRadius : -aRadius));
+        const QPointF pos = (invMtx * QVector3D(aCamera.toWorldPos(corner))).toPointF();
+        if (i == 0)
+        {
+            minPos = pos;
+            maxPos = pos;
+        }
+        else
+        {
+            minPos.setX(std::min(minPos.x(), pos.x()));
+            minPos.setY(std::min(minPos.y(), pos.y()));
+            maxPos.setX(std::max(maxPos.x(), pos.x()));
+            maxPos.setY(std::max(maxPos.y(), pos.y()));
+        }
+    }
+    return QRectF(minPos, maxPos);
+}
+
 void Focuser::setFocusEnable(bool aVtx, bool aEdge, bool aFace)
 {
     mEnable[0] = aVtx;
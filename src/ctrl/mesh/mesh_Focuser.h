@@ -1,6 +1,7 @@
 #ifndef CTRL_MESH_FOCUSER_H
 #define CTRL_MESH_FOCUSER_H
 
+#include "util/UniformGrid2D.h"
 #include "core/AbstractCursor.h"
 #include "core/CameraInfo.h"
 #include "ctrl/mesh/mesh_MeshAccessor.h"
@@ -47,9 +48,18 @@ public:
 
 private:
     QVector2D getScreenPos(const core::CameraInfo&, const QVector2D& aModelPos) const;
+    QRectF getModelRect(const core::CameraInfo&, const QVector2D& aScreenPos, float aRadius) const;
     void updateFocusChanged(const Focus& aPrev, const Focus& aNext);
+    void updateIndex();
 
     MeshAccessor* mMesh;
+    // spatial index in model space
+    util::UniformGrid2D<MeshVtx*> mVtxGrid;
+    util::UniformGrid2D<MeshEdge*> mEdgeGrid;
+    util::UniformGrid2D<MeshFace*> mFaceGrid;
+    QRectF mIndexSpace;
+    const core::MeshKey::Data* mIndexedData;
+    uint32 mIndexedRevision;
     QMatrix4x4 mTargetMtx;
     Focus mFocus;
     bool mFocusChanged;
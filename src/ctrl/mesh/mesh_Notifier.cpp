@@ -29,6 +29,15 @@ void Notifier::notify(bool aIsUndo)
     mProject.onTimeLineModified(mEvent, aIsUndo);
 }
 
+void Notifier::queue()
+{
+    // setup rendering attributes
+    mKey.updateGLAttribute();
+
+    // notify timeline modified later
+    mProject.queueTimeLineEvent(mEvent);
+}
+
 } // namespace mesh
 } // namespace ctrl
 
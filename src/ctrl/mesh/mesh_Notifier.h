@@ -19,6 +19,8 @@ public:
             core::TimeLineEvent::Type aType);
 
     void notify(bool aIsUndo = false);
+    // notify at the next flush of the project. (for continuous modifications)
+    void queue();
 
     virtual void onExecuted()
     {
@@ -149,13 +149,14 @@ void DrawBoneMode::pullBone(Bone2& aTarget, const QVector2D& aPull, float aPullP
         // modify
         if (mCommandRef && stack.isModifiable(mCommandRef))
         {
+            stack.markModified();
             mCommandRef->modifyValue(nextRots);
 
             // notify
             TimeLineEvent event;
             event.setType(TimeLineEvent::Type_ChangeKeyValue);
             event.pushTarget(mTarget, TimeKeyType_Pose, frame);
-            mProject.onTimeLineModified(event, false);
+            mProject.queueTimeLineEvent(event);
         }
         else
         {
@@ -88,13 +88,14 @@ void ErasePoseMode::updatePaint()
     // modify
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
+        stack.markModified();
         mCommandRef->modifyValue(nextRots);
 
         // notify
         TimeLineEvent event;
         event.setType(TimeLineEvent::Type_ChangeKeyValue);
         event.pushTarget(mTarget, TimeKeyType_Pose, frame);
-        mProject.onTimeLineModified(event, false);
+        mProject.queueTimeLineEvent(event);
     }
     else
     {
@@ -106,6 +106,7 @@ void TransBoneMode::rotateBone(Bone2& aTarget, float aRotate)
     // modify
     if (mCommandRef && stack.isModifiable(mCommandRef))
     {
+        stack.markModified();
         mCommandRef->modifyValue(nextRot);
         aTarget.updateWorldTransform();
 
@@ -113,7 +114,7 @@ void TransBoneMode::rotateBone(Bone2& aTarget, float aRotate)
         TimeLineEvent event;
         event.setType(TimeLineEvent::Type_ChangeKeyValue);
         event.pushTarget(mTarget, TimeKeyType_Pose, frame);
-        mProject.onTimeLineModified(event, false);
+        mProject.queueTimeLineEvent(event);
     }
     else
     {
@@ -122,13 +122,14 @@ void CentroidMode::moveCentroid(const QVector2D& aNewCentroid, const QVector2D&
     if (mCommandRef && mProject.commandStack().isModifiable(mCommandRef))
     {
         // modify command
+        mProject.commandStack().markModified();
         mCommandRef->modifyValue(centroidMove, positionMove);
 
         // singleshot notify
         TimeLineEvent event;
         event.setType(TimeLineEvent::Type_ChangeKeyValue);
         event.pushTarget(mTarget, TimeKeyType_Move, frame);
-        mProject.onTimeLineModified(event, false);
+        mProject.queueTimeLineEvent(event);
     }
     else
     {
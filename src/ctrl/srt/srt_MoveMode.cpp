@@ -184,7 +184,7 @@ void MoveMode::notifyAssignModification(TimeKeyType aKeyType)
     TimeLineEvent event;
     event.setType(TimeLineEvent::Type_ChangeKeyValue);
     event.pushTarget(mTarget, aKeyType, frame);
-    mProject.onTimeLineModified(event, false);
+    mProject.queueTimeLineEvent(event);
 }
 
 void MoveMode::assignMoveKey(MoveKey::Data& aNewData)
@@ -201,6 +201,7 @@ void MoveMode::assignMoveKey(MoveKey::Data& aNewData)
     {
         // modify command
         XC_ASSERT(!mKeyOwner.ownsMoveKey);
+        stack.markModified();
         mAssignMoveRef->modifyValue(aNewData);
         notifyAssignModification(TimeKeyType_Move);
     }
@@ -239,6 +240,7 @@ void MoveMode::assignRotateKey(RotateKey::Data& aNewData)
     {
         // modify command
         XC_ASSERT(!mKeyOwner.ownsRotateKey);
+        stack.markModified();
         mAssignRotateRef->modifyValue(aNewData);
         notifyAssignModification(TimeKeyType_Rotate);
     }
@@ -277,6 +279,7 @@ void MoveMode::assignScaleKey(ScaleKey::Data& aNewData)
     {
         // modify command
         XC_ASSERT(!mKeyOwner.ownsScaleKey);
+        stack.markModified();
         mAssignScaleRef->modifyValue(aNewData);
         notifyAssignModification(TimeKeyType_Scale);
     }
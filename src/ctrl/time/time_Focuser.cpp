@@ -21,9 +21,11 @@ bool Focuser::SingleFocus::isValid() const
 Focuser::Focuser(
         const QVector<TimeLineRow>& aRows,
         const Scaler& aScale,
+        KeySummary& aKeySummary,
         int aMargin)
     : mRows(aRows)
     , mScale(aScale)
+    , mKeySummary(aKeySummary)
     , mFocusLink()
     , mPoint()
     , mRange()
@@ -111,6 +113,13 @@ void Focuser::moveBoundingRect(int aAddFrame)
     mRange.setRight(mRange.right() + aAddFrame);
 }
 
+bool Focuser::hasChildKeysInRange(const TimeLineRow& aRow)
+{
+    // skip descendants of a closed folder quickly
+    if (!aRow.node) return false;
+    return mKeySummary.hasChildKeys(*aRow.node, util::Range(mRange.left(), mRange.right()));
+}
+
 bool Focuser::select(TimeLineEvent& aEvent)
 {
     const QRect box = boundingRect();
@@ -120,6 +129,7 @@ bool Focuser::select(TimeLineEvent& aEvent)
     {
         if (!line.rect.intersects(box)) continue;
 
+        const bool walkChildren = line.closedFolder && hasChildKeysInRange(line);
         ObjectNode::Iterator nodeItr(line.node);
         while (nodeItr.hasNext())
         {
@@ -153,7 +163,7 @@ bool Focuser::select(TimeLineEvent& aEvent)
                     ++itr;
                 }
             }
-            if (!line.closedFolder) break;
+            if (!walkChildren) break;
         }
     }
     return found;
@@ -171,6 +181,7 @@ Focuser::SingleFocus Focuser::updateImpl(bool aForceSingle)
     {
         if (!line.rect.intersects(box)) continue;
 
+        const bool walkChildren = line.closedFolder && hasChildKeysInRange(line);
         ObjectNode::Iterator nodeItr(line.node);
         while (nodeItr.hasNext())
         {
@@ -211,7 +222,7 @@ Focuser::SingleFocus Focuser::updateImpl(bool aForceSingle)
                     ++itr;
                 }
             }
-            if (!line.closedFolder) break;
+            if (!walkChildren) break;
         }
     }
     return single;
@@ -8,6 +8,7 @@
 #include "core/TimeLineEvent.h"
 #include "ctrl/TimeLineRow.h"
 #include "ctrl/time/time_Scaler.h"
+#include "ctrl/time/time_KeySummary.h"
 
 namespace ctrl {
 namespace time {
@@ -26,6 +27,7 @@ public:
     Focuser(
             const QVector<TimeLineRow>& aRows,
             const Scaler& aScale,
+            KeySummary& aKeySummary,
             int aMargin);
 
     SingleFocus reset(const QPoint& aPoint);
@@ -41,9 +43,11 @@ public:
 private:
     SingleFocus updateImpl(bool aForceSingle);
     QRect boundingRect() const;
+    bool hasChildKeysInRange(const TimeLineRow& aRow);
 
     const QVector<TimeLineRow>& mRows;
     const Scaler& mScale;
+    KeySummary& mKeySummary;
     util::PlacePointer<util::LifeLink> mFocusLink;
     QPoint mPoint;
     QRect mRange;
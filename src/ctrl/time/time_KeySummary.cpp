@@ -0,0 +1,157 @@
+#include <set>
+#include "ctrl/time/time_KeySummary.h"
+
+using namespace core;
+
+namespace ctrl {
+namespace time {
+
+KeySummary::KeySummary()
+    : mEntries()
+    , mEmpty()
+{
+}
+
+void KeySummary::clear()
+{
+    mEntries.clear();
+}
+
+void KeySummary::update(const TimeLineEvent& aEvent)
+{
+    // not built yet
+    if (mEntries.empty()) return;
+
+    // frames of keys aren't changed
+    if (aEvent.type() == TimeLineEvent::Type_ChangeKeyValue) return;
+
+    std::set<const ObjectNode*> nodes;
+    for (auto& target : aEvent.targets())
+    {
+        if (target.node) nodes.insert(target.node);
+    }
+
+    for (auto node : nodes)
+    {
+        if (!updateNode(*node))
+        {
+            // unknown nodes, rebuild later
+            clear();
+            return;
+        }
+    }
+}
+
+bool KeySummary::updateNode(const ObjectNode& aNode)
+{
+    auto found = mEntries.find(&aNode);
+    if (found == mEntries.end()) return false;
+
+    FrameCounts own;
+    makeOwnKeys(aNode, own);
+
+    // difference from the previous keys
+    FrameCounts delta = own;
+    for (auto& prev : found->second.own)
+    {
+        addKeys(delta, prev.first, -prev.second);
+    }
+
+    if (!delta.empty())
+    {
+        // apply to ancestors
+        for (auto parent = aNode.parent(); parent; parent = parent->parent())
+        {
+            auto entry = mEntries.find(parent);
+            if (entry == mEntries.end()) return false;
+
+            for (auto& diff : delta)
+            {
+                addKeys(entry->second.children, diff.first, diff.second);
+            }
+        }
+    }
+
+    found->second.own.swap(own);
+    return true;
+}
+
+const KeySummary::FrameCounts& KeySummary::childKeys(const ObjectNode& aNode)
+{
+    auto found = mEntries.find(&aNode);
+    if (found == mEntries.end())
+    {
+        // build whole of the tree
+        const ObjectNode* top = &aNode;
+        while (top->parent()) top = top->parent();
+        build(*top);
+
+        found = mEntries.find(&aNode);
+        if (found == mEntries.end()) return mEmpty;
+    }
+    return found->second.children;
+}
+
+bool KeySummary::hasChildKeys(const ObjectNode& aNode, const util::Range& aRange)
+{
+    const FrameCounts& keys = childKeys(aNode);
+    auto itr = keys.lower_bound(aRange.min());
+    return itr != keys.end() && itr->first <= aRange.max();
+}
+
+void KeySummary::build(const ObjectNode& aNode)
+{
+    ///@note references of unordered_map's elements are kept over insertions
+    Entry& entry = mEntries[&aNode];
+    entry.own.clear();
+    entry.children.clear();
+    makeOwnKeys(aNode, entry.own);
+
+    for (auto child : aNode.children())
+    {
+        build(*child);
+
+        const Entry& childEntry = mEntries[child];
+        for (auto& key : childEntry.own)
+        {
+            addKeys(entry.children, key.first, key.second);
+        }
+        for (auto& key : childEntry.children)
+        {
+            addKeys(entry.children, key.first, key.second);
+        }
+    }
+}
+
+void KeySummary::makeOwnKeys(const ObjectNode& aNode, FrameCounts& aDst)
+{
+    if (!aNode.timeLine()) return;
+    const TimeLine& timeLine = *(aNode.timeLine());
+
+    for (int i = 0; i < TimeKeyType_TERM; ++i)
+    {
+        const TimeLine::MapType& map = timeLine.map((TimeKeyType)i);
+        for (auto itr = map.begin(); itr != map.end(); ++itr)
+        {
+            addKeys(aDst, itr.key(), 1);
+        }
+    }
+}
+
+void KeySummary::addKeys(FrameCounts& aDst, int aFrame, int aCount)
+{
+    if (aCount == 0) return;
+
+    auto itr = aDst.find(aFrame);
+    if (itr == aDst.end())
+    {
+        aDst.insert(FrameCounts::value_type(aFrame, aCount));
+    }
+    else if ((itr->second += aCount) == 0)
+    {
+        aDst.erase(itr);
+    }
+}
+
+} // namespace time
+} // namespace ctrl
@@ -0,0 +1,48 @@
+#ifndef CTRL_TIME_KEYSUMMARY_H
+#define CTRL_TIME_KEYSUMMARY_H
+
+#include <map>
+#include <unordered_map>
+#include "util/Range.h"
+#include "core/ObjectNode.h"
+#include "core/TimeLineEvent.h"
+
+namespace ctrl {
+namespace time {
+
+// an index of frames which have keys under each node
+// It's built lazily and updated incrementally by time line events.
+class KeySummary
+{
+public:
+    typedef std::map<int, int> FrameCounts; // frame to key count
+
+    KeySummary();
+
+    void clear();
+    void update(const core::TimeLineEvent& aEvent);
+
+    // keys of descendants (the node itself is excluded)
+    const FrameCounts& childKeys(const core::ObjectNode& aNode);
+    bool hasChildKeys(const core::ObjectNode& aNode, const util::Range& aRange);
+
+private:
+    struct Entry
+    {
+        FrameCounts own;
+        FrameCounts children;
+    };
+
+    static void makeOwnKeys(const core::ObjectNode& aNode, FrameCounts& aDst);
+    static void addKeys(FrameCounts& aDst, int aFrame, int aCount);
+    bool updateNode(const core::ObjectNode& aNode);
+    void build(const core::ObjectNode& aTopNode);
+
+    std::unordered_map<const core::ObjectNode*, Entry> mEntries;
+    const FrameCounts mEmpty;
+};
+
+} // namespace time
+} // namespace ctrl
+
+#endif // CTRL_TIME_KEYSUMMARY_H
@@ -11,6 +11,7 @@ Renderer::Renderer(QPainter& aPainter, const CameraInfo& aCamera)
     , mMargin()
     , mRange()
     , mScale()
+    , mKeySummary()
 {
 }
 
@@ -235,38 +236,25 @@ void Renderer::drawKeys(const ObjectNode* aNode, const TimeLineRow& aRow)
 
 void Renderer::drawChildKeys(const ObjectNode* aNode, const QPoint& aPos)
 {
+    XC_PTR_ASSERT(mKeySummary);
     const QBrush kBrushKey(QColor(170, 170, 170, 255));
 
     mPainter.setPen(QPen(kBrushKey, 1));
     mPainter.setBrush(kBrushKey);
 
-    for (auto child : aNode->children())
-    {
-        ObjectNode::ConstIterator treeItr(child);
-        while (treeItr.hasNext())
-        {
-            const ObjectNode* node = treeItr.next();
-            if (!node->timeLine()) continue;
-            const TimeLine& timeLine = *(node->timeLine());
+    // keys on a same frame are drawn once
+    const KeySummary::FrameCounts& keys = mKeySummary->childKeys(*aNode);
 
-            for (int i = 0; i < TimeKeyType_TERM; ++i)
-            {
-                auto type = TimeLine::getTimeKeyTypeInOrderOfOperations(i);
-                const TimeLine::MapType& map = timeLine.map(type);
-
-                auto itr = map.lowerBound(mRange.min());
-                while (itr != map.end() && itr.key() <= mRange.max())
-                {
-                    auto attr = mScale->attribute(itr.key());
-                    QPointF pos[3];
-                    pos[0] = QPointF(aPos.x() + attr.grid.x() + 0.5f, aPos.y());
-                    pos[1] = pos[0] + QPointF( 3, -5);
-                    pos[2] = pos[0] + QPointF(-3, -5);
-                    mPainter.drawConvexPolygon(pos, 3);
-                    ++itr;
-                }
-            }
-        }
+    auto itr = keys.lower_bound(mRange.min());
+    while (itr != keys.end() && itr->first <= mRange.max())
+    {
+        auto attr = mScale->attribute(itr->first);
+        QPointF pos[3];
+        pos[0] = QPointF(aPos.x() + attr.grid.x() + 0.5f, aPos.y());
+        pos[1] = pos[0] + QPointF( 3, -5);
+        pos[2] = pos[0] + QPointF(-3, -5);
+        mPainter.drawConvexPolygon(pos, 3);
+        ++itr;
     }
 }
 
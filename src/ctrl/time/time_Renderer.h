@@ -8,6 +8,7 @@
 #include "core/ObjectNode.h"
 #include "ctrl/TimeLineRow.h"
 #include "ctrl/time/time_Scaler.h"
+#include "ctrl/time/time_KeySummary.h"
 
 namespace ctrl {
 namespace time {
@@ -20,6 +21,7 @@ public:
     void setMargin(int aMargin) { mMargin = aMargin; }
     void setRange(const util::Range& aRange) { mRange = aRange; }
     void setTimeScale(const Scaler& aScale) { mScale = &aScale; }
+    void setKeySummary(KeySummary& aSummary) { mKeySummary = &aSummary; }
 
     void renderLines(const QVector<TimeLineRow>& aRows, const QRect& aCameraRect, const QRect& aCullRect);
     void renderHeader(int aHeight, int aFps);
@@ -36,6 +38,7 @@ private:
     int mMargin;
     util::Range mRange;
     const Scaler* mScale;
+    KeySummary* mKeySummary;
 };
 
 } // namespace time
@@ -4,8 +4,8 @@
 namespace
 {
 gl::Global::Functions* gGLGlobalFunctions = nullptr;
-//QOpenGLContext* gGLGlobalContext = nullptr;
-//QSurface* gGlobalSurface = nullptr;
+QOpenGLContext* gGLGlobalContext = nullptr;
+QSurface* gGlobalSurface = nullptr;
 QOpenGLWidget* gGLGlobalWidget = nullptr;
 }
 QGLFormat::OpenGLVersionFlag gl::Global::kVersionFlag = QGLFormat::OpenGL_Version_4_0;
@@ -30,53 +30,46 @@ Global::Functions& Global::functions()
     return *gGLGlobalFunctions;
 }
 
-#if 0
 void Global::setContext(QOpenGLContext& aContext, QSurface& aSurface)
 {
-    XC_ASSERT(!gGLGlobalContext);
+    XC_ASSERT(!gGLGlobalContext && !gGLGlobalWidget);
     gGLGlobalContext = &aContext;
     gGlobalSurface = &aSurface;
 }
 
-void Global::clearContext()
-{
-    gGLGlobalContext = nullptr;
-}
-
-void Global::makeCurrent()
-{
-    XC_PTR_ASSERT(gGLGlobalContext);
-    gGLGlobalContext->makeCurrent(gGlobalSurface);
-}
-
-void Global::doneCurrent()
-{
-    XC_PTR_ASSERT(gGLGlobalContext);
-    gGLGlobalContext->doneCurrent();
-}
-#else
 void Global::setContext(QOpenGLWidget& aWidget)
 {
-    XC_ASSERT(!gGLGlobalWidget);
+    XC_ASSERT(!gGLGlobalContext && !gGLGlobalWidget);
     gGLGlobalWidget = &aWidget;
 }
 
 void Global::clearContext()
 {
+    gGLGlobalContext = nullptr;
+    gGlobalSurface = nullptr;
     gGLGlobalWidget = nullptr;
 }
 
 void Global::makeCurrent()
 {
+    if (gGLGlobalContext)
+    {
+        gGLGlobalContext->makeCurrent(gGlobalSurface);
+        return;
+    }
     XC_PTR_ASSERT(gGLGlobalWidget);
     gGLGlobalWidget->makeCurrent();
 }
 
 void Global::doneCurrent()
 {
+    if (gGLGlobalContext)
+    {
+        gGLGlobalContext->doneCurrent();
+        return;
+    }
     XC_PTR_ASSERT(gGLGlobalWidget);
     gGLGlobalWidget->doneCurrent();
 }
-#endif
 
 } // namespace gl
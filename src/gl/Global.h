@@ -23,7 +23,8 @@ public:
     static void clearFunctions();
     static Functions& functions();
 
-    //static void setContext(QOpenGLContext& aContext, QSurface& aSurface);
+    // for a headless context (ex. the benchmark)
+    static void setContext(QOpenGLContext& aContext, QSurface& aSurface);
     static void setContext(QOpenGLWidget& aWidget);
     static void clearContext();
     static void makeCurrent();
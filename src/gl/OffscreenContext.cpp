@@ -0,0 +1,84 @@
+#include "XC.h"
+#include "gl/OffscreenContext.h"
+
+namespace gl
+{
+
+OffscreenContext::OffscreenContext()
+    : mContext()
+    , mSurface()
+    , mFunctions()
+    , mDeviceInfo()
+    , mDefaultVAO()
+    , mIsValid(false)
+    , mLog()
+{
+}
+
+OffscreenContext::~OffscreenContext()
+{
+    if (mIsValid)
+    {
+        Global::makeCurrent();
+        mDefaultVAO.reset();
+        DeviceInfo::setInstance(nullptr);
+        Global::clearFunctions();
+        Global::doneCurrent();
+        Global::clearContext();
+    }
+}
+
+bool OffscreenContext::create()
+{
+    XC_ASSERT(!mIsValid);
+
+    QSurfaceFormat format;
+#if defined(USE_GL_CORE_PROFILE)
+    format.setVersion(Global::kMajorVersion, Global::kMinorVersion);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+#endif
+
+    mContext.reset(new QOpenGLContext());
+    mContext->setFormat(format);
+    if (!mContext->create())
+    {
+        mLog = "Failed to create an opengl context.";
+        return false;
+    }
+
+    mSurface.reset(new QOffscreenSurface());
+    mSurface->setFormat(mContext->format());
+    mSurface->create();
+    if (!mSurface->isValid() || !mContext->makeCurrent(mSurface.data()))
+    {
+        mLog = "Failed to create an offscreen surface.";
+        return false;
+    }
+
+    // initialize opengl functions
+    mFunctions = mContext->versionFunctions<Global::Functions>();
+    if (!mFunctions || !mFunctions->initializeOpenGLFunctions())
+    {
+        mLog = "Failed to initialize opengl functions.";
+        return false;
+    }
+
+    // setup global info
+    Global::setContext(*mContext, *mSurface);
+    Global::setFunctions(*mFunctions);
+
+    // initialize opengl device info
+    mDeviceInfo.load();
+    DeviceInfo::setInstance(&mDeviceInfo);
+
+#ifdef USE_GL_CORE_PROFILE
+    // initialize default vao
+    mDefaultVAO.reset(new VertexArrayObject());
+    mDefaultVAO->bind(); // keep binding
+#endif
+
+    mIsValid = true;
+    return true;
+}
+
+} // namespace gl
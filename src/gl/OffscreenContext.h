@@ -0,0 +1,39 @@
+#ifndef GL_OFFSCREENCONTEXT_H
+#define GL_OFFSCREENCONTEXT_H
+
+#include <QScopedPointer>
+#include <QOpenGLContext>
+#include <QOffscreenSurface>
+#include "util/NonCopyable.h"
+#include "gl/Global.h"
+#include "gl/DeviceInfo.h"
+#include "gl/VertexArrayObject.h"
+
+namespace gl
+{
+
+// a headless opengl context. (for benchmarks and child processes of exports)
+class OffscreenContext : private util::NonCopyable
+{
+public:
+    OffscreenContext();
+    ~OffscreenContext();
+
+    bool create();
+    bool isValid() const { return mIsValid; }
+    const QString& log() const { return mLog; }
+    const DeviceInfo& deviceInfo() const { return mDeviceInfo; }
+
+private:
+    QScopedPointer<QOpenGLContext> mContext;
+    QScopedPointer<QOffscreenSurface> mSurface;
+    Global::Functions* mFunctions;
+    DeviceInfo mDeviceInfo;
+    QScopedPointer<VertexArrayObject> mDefaultVAO;
+    bool mIsValid;
+    QString mLog;
+};
+
+} // namespace gl
+
+#endif // GL_OFFSCREENCONTEXT_H
@@ -275,6 +275,7 @@ PrimitiveDrawer::PrimitiveDrawer(int aVtxCountOfSlot, int aSlotCount)
     , mScheduledState()
     , mPosBuffer()
     , mSubBuffer()
+    , mTriangulator()
 {
     // create shader
     mPlaneShader.init();
@@ -624,17 +625,15 @@ void PrimitiveDrawer::drawPolygonImpl(const QVector<gl::Vector2>& aTriangles)
 
 void PrimitiveDrawer::drawPolygon(const QPoint* aPoints, int aCount)
 {
-    Triangulator tri(aPoints, aCount);
-    if (!tri) return;
-    drawPolygonImpl(tri.triangles());
+    if (!mTriangulator.reset(aPoints, aCount)) return;
+    drawPolygonImpl(mTriangulator.triangles());
     drawOutline([=](int aIndex){ return QPointF(aPoints[aIndex]); }, aCount);
 }
 
 void PrimitiveDrawer::drawPolygon(const QPointF* aPoints, int aCount)
 {
-    Triangulator tri(aPoints, aCount);
-    if (!tri) return;
-    drawPolygonImpl(tri.triangles());
+    if (!mTriangulator.reset(aPoints, aCount)) return;
+    drawPolygonImpl(mTriangulator.triangles());
     drawOutline([=](int aIndex){ return aPoints[aIndex]; }, aCount);
 }
 
@@ -9,6 +9,7 @@
 #include "gl/BufferObject.h"
 #include "gl/EasyShaderProgram.h"
 #include "gl/Texture.h"
+#include "gl/Triangulator.h"
 
 namespace gl
 {
@@ -211,6 +212,7 @@ private:
 
     QVector<gl::Vector2> mPosBuffer;
     QVector<gl::Vector2> mSubBuffer;
+    Triangulator mTriangulator;
 
 };
 
@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "XC.h"
+#include "gl/Profiler.h"
+
+namespace
+{
+static gl::Profiler* sProfilerPtr = nullptr;
+static const int kQueryAllocCount = 64;
+static const size_t kLooseScopeMax = 1024;
+
+QJsonObject makeTraceEvent(const QString& aName, const char* aCategory,
+                           qint64 aBegin, qint64 aEnd, int aThreadId)
+{
+    QJsonObject event;
+    event["name"] = aName;
+    event["cat"] = QString(aCategory);
+    event["ph"] = QString("X");
+    event["ts"] = aBegin * 1e-3; // usecs
+    event["dur"] = std::max(aEnd - aBegin, (qint64)0) * 1e-3;
+    event["pid"] = 1;
+    event["tid"] = aThreadId;
+    return event;
+}
+
+QJsonObject makeThreadName(const QString& aName, int aThreadId)
+{
+    QJsonObject args;
+    args["name"] = aName;
+    QJsonObject event;
+    event["name"] = QString("thread_name");
+    event["ph"] = QString("M");
+    event["pid"] = 1;
+    event["tid"] = aThreadId;
+    event["args"] = args;
+    return event;
+}
+
+} // namespace
+
+namespace gl
+{
+
+//-------------------------------------------------------------------------------------------------
+Profiler::Scope::Scope()
+    : category("")
+    , name()
+    , depth(0)
+    , cpuBegin(0)
+    , cpuEnd(0)
+    , gpuBegin(-1)
+    , gpuEnd(-1)
+    , query(-1)
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+Profiler::Frame::Frame()
+    : name()
+    , index(0)
+    , cpuBegin(0)
+    , cpuEnd(0)
+    , scopes()
+    , queries()
+{
+}
+
+double Profiler::Frame::gpuMSec() const
+{
+    qint64 begin = 0;
+    qint64 end = 0;
+    bool exists = false;
+    for (auto& scope : scopes)
+    {
+        if (!scope.hasGpu()) continue;
+        begin = exists ? std::min(begin, scope.gpuBegin) : scope.gpuBegin;
+        end = exists ? std::max(end, scope.gpuEnd) : scope.gpuEnd;
+        exists = true;
+    }
+    return (end - begin) * 1e-6;
+}
+
+//-------------------------------------------------------------------------------------------------
+void Profiler::setInstance(Profiler* aInstance)
+{
+    sProfilerPtr = aInstance;
+}
+
+Profiler* Profiler::instance()
+{
+    return sProfilerPtr;
+}
+
+Profiler::Profiler()
+    : mThread(QThread::currentThread())
+    , mTimer()
+    , mInFrame(false)
+    , mFrameCount(0)
+    , mCurrent()
+    , mLoose()
+    , mStack()
+    , mPending()
+    , mHistory()
+    , mFreeQueries()
+    , mAllQueries()
+    , mHistoryCapacity(120)
+{
+    mTimer.start();
+}
+
+Profiler::~Profiler()
+{
+    if (sProfilerPtr == this)
+    {
+        sProfilerPtr = nullptr;
+    }
+
+    if (!mAllQueries.empty())
+    {
+        Global::functions().glDeleteQueries((GLsizei)mAllQueries.size(), mAllQueries.data());
+    }
+}
+
+void Profiler::beginFrame(const QString& aName)
+{
+    XC_ASSERT(!mInFrame);
+    Global::Functions& ggl = Global::functions();
+
+    // close loose scopes which are left open
+    closeOpenScopes(mLoose);
+
+    mCurrent = Frame();
+    mCurrent.name = aName;
+    mCurrent.index = mFrameCount++;
+    mCurrent.cpuBegin = mTimer.nsecsElapsed();
+
+    // the origin of gpu timestamps
+    mCurrent.queries.push_back(acquireQuery());
+    ggl.glQueryCounter(mCurrent.queries.front(), GL_TIMESTAMP);
+
+    // take over loose scopes
+    const int offset = (int)mCurrent.queries.size();
+    for (auto& scope : mLoose.scopes)
+    {
+        if (scope.query >= 0) scope.query += offset;
+        mCurrent.scopes.push_back(scope);
+    }
+    mCurrent.queries.insert(mCurrent.queries.end(), mLoose.queries.begin(), mLoose.queries.end());
+    mLoose = Frame();
+
+    mInFrame = true;
+}
+
+void Profiler::endFrame()
+{
+    XC_ASSERT(mInFrame);
+    if (!mInFrame) return;
+
+    closeOpenScopes(mCurrent);
+    mCurrent.cpuEnd = mTimer.nsecsElapsed();
+
+    mPending.push_back(Frame());
+    std::swap(mPending.back(), mCurrent);
+    mInFrame = false;
+
+    resolve(false);
+}
+
+int Profiler::pushScope(const char* aCategory, const QString& aName, bool aUseGpu)
+{
+    if (QThread::currentThread() != mThread) return -1;
+
+    Frame& target = mInFrame ? mCurrent : mLoose;
+    if (!mInFrame && target.scopes.size() >= kLooseScopeMax) return -1;
+
+    Scope scope;
+    scope.category = aCategory;
+    scope.name = aName;
+    scope.depth = (int)mStack.size();
+
+    if (aUseGpu)
+    {
+        scope.query = (int)target.queries.size();
+        target.queries.push_back(acquireQuery());
+        target.queries.push_back(acquireQuery());
+        Global::functions().glQueryCounter(target.queries[scope.query], GL_TIMESTAMP);
+    }
+    scope.cpuBegin = mTimer.nsecsElapsed();
+
+    const int id = (int)target.scopes.size();
+    target.scopes.push_back(scope);
+    mStack.push_back(id);
+    return id;
+}
+
+void Profiler::popScope(int aId)
+{
+    Frame& target = mInFrame ? mCurrent : mLoose;
+
+    // ignore unbalanced scopes (ex. a scope which crossed a frame boundary)
+    if (aId < 0 || mStack.empty() || mStack.back() != aId) return;
+    mStack.pop_back();
+
+    closeScope(target, target.scopes[aId]);
+}
+
+void Profiler::closeScope(Frame& aFrame, Scope& aScope)
+{
+    aScope.cpuEnd = mTimer.nsecsElapsed();
+    if (aScope.query >= 0)
+    {
+        Global::functions().glQueryCounter(aFrame.queries[aScope.query + 1], GL_TIMESTAMP);
+    }
+}
+
+void Profiler::closeOpenScopes(Frame& aFrame)
+{
+    while (!mStack.empty())
+    {
+        const int id = mStack.back();
+        mStack.pop_back();
+        if (id < (int)aFrame.scopes.size())
+        {
+            closeScope(aFrame, aFrame.scopes[id]);
+        }
+    }
+}
+
+void Profiler::resolve(bool aWait)
+{
+    while (!mPending.empty())
+    {
+        if (!resolveFrame(mPending.front(), aWait)) break;
+
+        pushHistory(mPending.front());
+        mPending.pop_front();
+    }
+}
+
+bool Profiler::resolveFrame(Frame& aFrame, bool aWait)
+{
+    if (aFrame.queries.empty()) return true;
+    Global::Functions& ggl = Global::functions();
+
+    if (!aWait)
+    {
+        for (auto query : aFrame.queries)
+        {
+            GLint available = 0;
+            ggl.glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) return false;
+        }
+    }
+
+    std::vector<GLuint64> stamps(aFrame.queries.size());
+    for (size_t i = 0; i < stamps.size(); ++i)
+    {
+        ggl.glGetQueryObjectui64v(aFrame.queries[i], GL_QUERY_RESULT, &stamps[i]);
+    }
+
+    // convert into the cpu time line
+    const qint64 origin = (qint64)stamps.front();
+    for (auto& scope : aFrame.scopes)
+    {
+        if (scope.query < 0) continue;
+        scope.gpuBegin = aFrame.cpuBegin + ((qint64)stamps[scope.query] - origin);
+        scope.gpuEnd = aFrame.cpuBegin + ((qint64)stamps[scope.query + 1] - origin);
+    }
+
+    releaseQueries(aFrame);
+    return true;
+}
+
+void Profiler::pushHistory(Frame& aFrame)
+{
+    mHistory.push_back(Frame());
+    std::swap(mHistory.back(), aFrame);
+
+    if (mHistoryCapacity > 0)
+    {
+        while ((int)mHistory.size() > mHistoryCapacity)
+        {
+            mHistory.pop_front();
+        }
+    }
+}
+
+void Profiler::setHistoryCapacity(int aCount)
+{
+    mHistoryCapacity = std::max(aCount, 0);
+
+    if (mHistoryCapacity > 0)
+    {
+        while ((int)mHistory.size() > mHistoryCapacity)
+        {
+            mHistory.pop_front();
+        }
+    }
+}
+
+void Profiler::clear()
+{
+    for (auto& frame : mPending)
+    {
+        releaseQueries(frame);
+    }
+    mPending.clear();
+    mHistory.clear();
+
+    if (!mInFrame)
+    {
+        closeOpenScopes(mLoose);
+        releaseQueries(mLoose);
+        mLoose = Frame();
+    }
+}
+
+GLuint Profiler::acquireQuery()
+{
+    if (mFreeQueries.empty())
+    {
+        GLuint queries[kQueryAllocCount] = {};
+        Global::functions().glGenQueries(kQueryAllocCount, queries);
+        mFreeQueries.insert(mFreeQueries.end(), queries, queries + kQueryAllocCount);
+        mAllQueries.insert(mAllQueries.end(), queries, queries + kQueryAllocCount);
+    }
+    const GLuint query = mFreeQueries.back();
+    mFreeQueries.pop_back();
+    return query;
+}
+
+void Profiler::releaseQueries(Frame& aFrame)
+{
+    mFreeQueries.insert(mFreeQueries.end(), aFrame.queries.begin(), aFrame.queries.end());
+    aFrame.queries.clear();
+}
+
+QJsonDocument Profiler::toChromeTrace() const
+{
+    static const int kCpuThread = 1;
+    static const int kGpuThread = 2;
+
+    QJsonArray events;
+    events.append(makeThreadName("CPU", kCpuThread));
+    events.append(makeThreadName("GPU", kGpuThread));
+
+    for (auto& frame : mHistory)
+    {
+        QJsonObject args;
+        args["index"] = frame.index;
+        QJsonObject event = makeTraceEvent(
+                    frame.name, "frame", frame.cpuBegin, frame.cpuEnd, kCpuThread);
+        event["args"] = args;
+        events.append(event);
+
+        for (auto& scope : frame.scopes)
+        {
+            events.append(makeTraceEvent(
+                              scope.name, scope.category,
+                              scope.cpuBegin, scope.cpuEnd, kCpuThread));
+            if (scope.hasGpu())
+            {
+                events.append(makeTraceEvent(
+                                  scope.name, scope.category,
+                                  scope.gpuBegin, scope.gpuEnd, kGpuThread));
+            }
+        }
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = QString("ms");
+    return QJsonDocument(root);
+}
+
+bool Profiler::writeChromeTrace(const QString& aFilePath) const
+{
+    QFile file(aFilePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(toChromeTrace().toJson(QJsonDocument::Compact)) >= 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+ProfileScope::ProfileScope(const char* aCategory, const char* aName, bool aUseGpu)
+    : mProfiler(Profiler::instance())
+    , mId(-1)
+{
+    if (mProfiler)
+    {
+        mId = mProfiler->pushScope(aCategory, QString(aName), aUseGpu);
+    }
+}
+
+ProfileScope::ProfileScope(const char* aCategory, const QString& aName, bool aUseGpu)
+    : mProfiler(Profiler::instance())
+    , mId(-1)
+{
+    if (mProfiler)
+    {
+        mId = mProfiler->pushScope(aCategory, aName, aUseGpu);
+    }
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (mProfiler && mId >= 0)
+    {
+        mProfiler->popScope(mId);
+    }
+}
+
+} // namespace gl
@@ -0,0 +1,118 @@
+#ifndef GL_PROFILER_H
+#define GL_PROFILER_H
+
+#include <deque>
+#include <vector>
+#include <QString>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QJsonDocument>
+#include "util/NonCopyable.h"
+#include "gl/Global.h"
+
+namespace gl
+{
+
+// a per frame profiler of the rendering pipeline.
+// cpu scopes are timed by QElapsedTimer, gpu scopes are timed by timestamp queries
+// which are collected some frames later, so that it never stalls the pipeline.
+// (scopes on other threads than the creator's one are ignored.)
+class Profiler : private util::NonCopyable
+{
+public:
+    struct Scope
+    {
+        Scope();
+        double cpuMSec() const { return (cpuEnd - cpuBegin) * 1e-6; }
+        double gpuMSec() const { return (gpuEnd - gpuBegin) * 1e-6; }
+        bool hasGpu() const { return gpuBegin >= 0 && gpuEnd >= gpuBegin; }
+
+        const char* category;
+        QString name;
+        int depth;
+        qint64 cpuBegin; ///< nsecs from the profiler creation
+        qint64 cpuEnd;
+        qint64 gpuBegin; ///< nsecs in the cpu time line (-1 if it isn't measured)
+        qint64 gpuEnd;
+        int query; ///< index of the first query of the frame (-1 if it's a cpu scope)
+    };
+
+    struct Frame
+    {
+        Frame();
+        double cpuMSec() const { return (cpuEnd - cpuBegin) * 1e-6; }
+        double gpuMSec() const;
+
+        QString name;
+        int index;
+        qint64 cpuBegin;
+        qint64 cpuEnd;
+        std::vector<Scope> scopes;
+        std::vector<GLuint> queries; ///< the first one is the origin of the frame
+    };
+
+    static void setInstance(Profiler* aInstance);
+    static Profiler* instance();
+
+    // it requires a current opengl context on destruction.
+    Profiler();
+    ~Profiler();
+
+    void beginFrame(const QString& aName);
+    void endFrame();
+    bool isInFrame() const { return mInFrame; }
+
+    // scopes out of frames are given to the next frame.
+    int pushScope(const char* aCategory, const QString& aName, bool aUseGpu);
+    void popScope(int aId);
+
+    // collect finished queries. (if aWait is true, it blocks until all of them finish)
+    void resolve(bool aWait = false);
+
+    // the count of resolved frames to keep. (zero means unlimited)
+    void setHistoryCapacity(int aCount);
+    int historyCapacity() const { return mHistoryCapacity; }
+    const std::deque<Frame>& history() const { return mHistory; }
+    void clear();
+
+    QJsonDocument toChromeTrace() const;
+    bool writeChromeTrace(const QString& aFilePath) const;
+
+private:
+    GLuint acquireQuery();
+    void releaseQueries(Frame& aFrame);
+    void closeScope(Frame& aFrame, Scope& aScope);
+    void closeOpenScopes(Frame& aFrame);
+    bool resolveFrame(Frame& aFrame, bool aWait);
+    void pushHistory(Frame& aFrame);
+
+    QThread* mThread;
+    QElapsedTimer mTimer;
+    bool mInFrame;
+    int mFrameCount;
+    Frame mCurrent;
+    Frame mLoose;
+    std::vector<int> mStack;
+    std::deque<Frame> mPending;
+    std::deque<Frame> mHistory;
+    std::vector<GLuint> mFreeQueries;
+    std::vector<GLuint> mAllQueries;
+    int mHistoryCapacity;
+};
+
+// a scope which is recorded to the current profiler if it exists.
+class ProfileScope : private util::NonCopyable
+{
+public:
+    ProfileScope(const char* aCategory, const char* aName, bool aUseGpu = false);
+    ProfileScope(const char* aCategory, const QString& aName, bool aUseGpu = false);
+    ~ProfileScope();
+
+private:
+    Profiler* mProfiler;
+    int mId;
+};
+
+} // namespace gl
+
+#endif // GL_PROFILER_H
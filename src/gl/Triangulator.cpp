@@ -1,50 +1,524 @@
+#include <cmath>
+#include <set>
+#include <algorithm>
 #include "util/CollDetect.h"
 #include "gl/Triangulator.h"
 
 namespace gl
 {
 
-Triangulator::Triangulator(const QPoint* aPoints, int aCount)
-    : mPoints()
+//-------------------------------------------------------------------------------------------------
+// order of the edges which intersect with the sweep line (from left to right)
+class Triangulator::EdgeOrder
+{
+public:
+    enum { kSweepPoint = -1 };
+
+    EdgeOrder(const Triangulator& aOwner)
+        : mOwner(&aOwner)
+    {
+    }
+
+    bool operator()(int aLhs, int aRhs) const
+    {
+        const double lx = (aLhs == kSweepPoint) ? mOwner->mSweepX : mOwner->edgeX(aLhs);
+        const double rx = (aRhs == kSweepPoint) ? mOwner->mSweepX : mOwner->edgeX(aRhs);
+        if (lx != rx) return lx < rx;
+        if (aLhs == kSweepPoint || aRhs == kSweepPoint) return false;
+
+        // the edges touch on the sweep line, compare them slightly below.
+        const double ls = slope(aLhs);
+        const double rs = slope(aRhs);
+        if (ls != rs) return ls > rs;
+        return aLhs < aRhs;
+    }
+
+private:
+    double slope(int aEdge) const
+    {
+        auto& a = mOwner->mVertices[aEdge];
+        auto& b = mOwner->mVertices[(aEdge + 1) % mOwner->mVertices.size()];
+        if (a.y == b.y) return 0.0;
+        return (b.x - a.x) / (b.y - a.y);
+    }
+
+    const Triangulator* mOwner;
+};
+
+//-------------------------------------------------------------------------------------------------
+Triangulator::Triangulator()
+    : mVertices()
+    , mOrder()
+    , mTypes()
+    , mHelpers()
+    , mHalfEdges()
+    , mOutgoings()
+    , mOutgoingOffsets()
+    , mFace()
+    , mChainSide()
+    , mSorted()
+    , mStack()
+    , mPoints()
+    , mTriangleCount(0)
+    , mSweepX(0.0)
+    , mSweepY(0.0)
     , mTriangles()
     , mFirstPoint()
     , mIsSuccess(false)
 {
-    if (aCount < 3) return;
-    makeRoundChain<QPoint>(aPoints, aCount);
-    mIsSuccess = triangulate();
-    if (!mIsSuccess) mTriangles.clear();
+}
+
+Triangulator::Triangulator(const QPoint* aPoints, int aCount)
+    : Triangulator()
+{
+    reset(aPoints, aCount);
 }
 
 Triangulator::Triangulator(const QPointF* aPoints, int aCount)
-    : mPoints()
-    , mTriangles()
-    , mFirstPoint()
-    , mIsSuccess(false)
+    : Triangulator()
 {
-    if (aCount < 3) return;
-    makeRoundChain<QPointF>(aPoints, aCount);
-    mIsSuccess = triangulate();
-    if (!mIsSuccess) mTriangles.clear();
+    reset(aPoints, aCount);
 }
 
 Triangulator::Triangulator(const QPolygonF& aPolygon)
-    : mPoints()
-    , mTriangles()
-    , mFirstPoint()
-    , mIsSuccess(false)
+    : Triangulator()
+{
+    reset(aPolygon);
+}
+
+bool Triangulator::reset(const QPoint* aPoints, int aCount)
+{
+    return resetImpl<QPoint>(aPoints, aCount);
+}
+
+bool Triangulator::reset(const QPointF* aPoints, int aCount)
+{
+    return resetImpl<QPointF>(aPoints, aCount);
+}
+
+bool Triangulator::reset(const QPolygonF& aPolygon)
+{
+    return resetImpl<QPointF>(aPolygon.data(), aPolygon.size());
+}
+
+void Triangulator::orientAntiClockwise()
+{
+    const int count = (int)mVertices.size();
+    double area = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        auto& a = mVertices[i];
+        auto& b = mVertices[(i + 1) % count];
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    if (area < 0.0)
+    {
+        std::reverse(mVertices.begin(), mVertices.end());
+    }
+}
+
+bool Triangulator::triangulateByMonotone()
+{
+    const int count = (int)mVertices.size();
+    mTriangles.reserve((count - 2) * 3);
+    mTriangleCount = 0;
+
+    if (!makeMonotonePartition()) return false;
+    if (!triangulateMonotoneFaces()) return false;
+
+    // a simple polygon always consists of (count - 2) triangles
+    return mTriangleCount == count - 2;
+}
+
+bool Triangulator::isAbove(int aLhs, int aRhs) const
+{
+    auto& a = mVertices[aLhs];
+    auto& b = mVertices[aRhs];
+    if (a.y != b.y) return a.y > b.y;
+    if (a.x != b.x) return a.x < b.x;
+    return aLhs < aRhs;
+}
+
+Triangulator::VertexType Triangulator::vertexType(int aIndex) const
+{
+    const int count = (int)mVertices.size();
+    const int prev = (aIndex + count - 1) % count;
+    const int next = (aIndex + 1) % count;
+    auto& p = mVertices[prev];
+    auto& c = mVertices[aIndex];
+    auto& n = mVertices[next];
+
+    const bool prevBelow = isAbove(aIndex, prev);
+    const bool nextBelow = isAbove(aIndex, next);
+    const bool convex = (c.x - p.x) * (n.y - c.y) - (c.y - p.y) * (n.x - c.x) > 0.0;
+
+    if (prevBelow && nextBelow)
+    {
+        return convex ? VertexType_Start : VertexType_Split;
+    }
+    else if (!prevBelow && !nextBelow)
+    {
+        return convex ? VertexType_End : VertexType_Merge;
+    }
+    return VertexType_Regular;
+}
+
+double Triangulator::edgeX(int aEdge) const
+{
+    auto& a = mVertices[aEdge];
+    auto& b = mVertices[(aEdge + 1) % mVertices.size()];
+
+    if (a.y == b.y)
+    {
+        return xc_clamp(mSweepX, std::min(a.x, b.x), std::max(a.x, b.x));
+    }
+    return a.x + (mSweepY - a.y) * (b.x - a.x) / (b.y - a.y);
+}
+
+bool Triangulator::makeMonotonePartition()
+{
+    typedef std::set<int, EdgeOrder> EdgeStatus;
+
+    const int count = (int)mVertices.size();
+
+    // sort vertices from top to bottom
+    mOrder.resize(count);
+    for (int i = 0; i < count; ++i) mOrder[i] = i;
+    std::sort(mOrder.begin(), mOrder.end(), [=](int a, int b) { return this->isAbove(a, b); });
+
+    mTypes.resize(count);
+    for (int i = 0; i < count; ++i) mTypes[i] = vertexType(i);
+
+    mHelpers.assign(count, -1);
+
+    // polygon edges
+    mHalfEdges.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        HalfEdge edge = { i, (i + 1) % count, 0.0, false };
+        mHalfEdges.push_back(edge);
+    }
+
+    auto addDiagonal = [=](int aFrom, int aTo)
+    {
+        HalfEdge edge0 = { aFrom, aTo, 0.0, false };
+        HalfEdge edge1 = { aTo, aFrom, 0.0, false };
+        this->mHalfEdges.push_back(edge0);
+        this->mHalfEdges.push_back(edge1);
+    };
+
+    EdgeStatus status((EdgeOrder(*this)));
+    std::vector<EdgeStatus::iterator> statusItrs(count, status.end());
+
+    auto insertEdge = [&](int aEdge)
+    {
+        auto result = status.insert(aEdge);
+        statusItrs[aEdge] = result.first;
+        mHelpers[aEdge] = aEdge;
+        return result.second;
+    };
+    auto removeEdge = [&](int aEdge)
+    {
+        if (statusItrs[aEdge] == status.end()) return false;
+        status.erase(statusItrs[aEdge]);
+        statusItrs[aEdge] = status.end();
+        return true;
+    };
+    auto findLeftEdge = [&]()
+    {
+        auto itr = status.upper_bound(EdgeOrder::kSweepPoint);
+        if (itr == status.begin()) return -1;
+        return *(--itr);
+    };
+    auto isMerge = [&](int aVertex)
+    {
+        return aVertex >= 0 && mTypes[aVertex] == VertexType_Merge;
+    };
+
+    // sweep
+    for (int vtx : mOrder)
+    {
+        mSweepX = mVertices[vtx].x;
+        mSweepY = mVertices[vtx].y;
+        const int prevEdge = (vtx + count - 1) % count;
+
+        switch (mTypes[vtx])
+        {
+        case VertexType_Start:
+            if (!insertEdge(vtx)) return false;
+            break;
+
+        case VertexType_End:
+            if (isMerge(mHelpers[prevEdge])) addDiagonal(vtx, mHelpers[prevEdge]);
+            if (!removeEdge(prevEdge)) return false;
+            break;
+
+        case VertexType_Split:
+        {
+            const int left = findLeftEdge();
+            if (left < 0) return false;
+            addDiagonal(vtx, mHelpers[left]);
+            mHelpers[left] = vtx;
+            if (!insertEdge(vtx)) return false;
+            break;
+        }
+        case VertexType_Merge:
+        {
+            if (isMerge(mHelpers[prevEdge])) addDiagonal(vtx, mHelpers[prevEdge]);
+            if (!removeEdge(prevEdge)) return false;
+            const int left = findLeftEdge();
+            if (left < 0) return false;
+            if (isMerge(mHelpers[left])) addDiagonal(vtx, mHelpers[left]);
+            mHelpers[left] = vtx;
+            break;
+        }
+        case VertexType_Regular:
+            if (isAbove(prevEdge, vtx))
+            {
+                // the interior lies to the right of the vertex
+                if (isMerge(mHelpers[prevEdge])) addDiagonal(vtx, mHelpers[prevEdge]);
+                if (!removeEdge(prevEdge)) return false;
+                if (!insertEdge(vtx)) return false;
+            }
+            else
+            {
+                const int left = findLeftEdge();
+                if (left < 0) return false;
+                if (isMerge(mHelpers[left])) addDiagonal(vtx, mHelpers[left]);
+                mHelpers[left] = vtx;
+            }
+            break;
+
+        default:
+            XC_ASSERT(0);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Triangulator::triangulateMonotoneFaces()
 {
-    if (aPolygon.size() < 3) return;
-    makeRoundChain<QPointF>(aPolygon.data(), aPolygon.size());
-    mIsSuccess = triangulate();
-    if (!mIsSuccess) mTriangles.clear();
+    const int count = (int)mVertices.size();
+    const int edgeCount = (int)mHalfEdges.size();
+
+    // sort outgoing half edges of each vertex by the angle
+    mOutgoingOffsets.assign(count + 1, 0);
+    for (auto& edge : mHalfEdges)
+    {
+        auto& from = mVertices[edge.from];
+        auto& to = mVertices[edge.to];
+        edge.angle = std::atan2(to.y - from.y, to.x - from.x);
+        ++mOutgoingOffsets[edge.from + 1];
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        mOutgoingOffsets[i + 1] += mOutgoingOffsets[i];
+    }
+    mOutgoings.resize(edgeCount);
+    {
+        mStack.assign(mOutgoingOffsets.begin(), mOutgoingOffsets.end() - 1);
+        for (int i = 0; i < edgeCount; ++i)
+        {
+            mOutgoings[mStack[mHalfEdges[i].from]++] = i;
+        }
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        std::sort(mOutgoings.begin() + mOutgoingOffsets[i],
+                  mOutgoings.begin() + mOutgoingOffsets[i + 1],
+                  [=](int a, int b) { return mHalfEdges[a].angle < mHalfEdges[b].angle; });
+    }
+
+    // walk around each faces which keep the interior on the left
+    for (int i = 0; i < edgeCount; ++i)
+    {
+        if (mHalfEdges[i].visited) continue;
+
+        mFace.clear();
+        int current = i;
+        while (true)
+        {
+            auto& edge = mHalfEdges[current];
+            edge.visited = true;
+            mFace.push_back(edge.from);
+            if ((int)mFace.size() > count) return false;
+
+            // choose the next edge which is clockwise-nearest from the reverse edge
+            auto& to = mVertices[edge.to];
+            auto& from = mVertices[edge.from];
+            const double reverse = std::atan2(from.y - to.y, from.x - to.x);
+            auto bgn = mOutgoings.begin() + mOutgoingOffsets[edge.to];
+            auto end = mOutgoings.begin() + mOutgoingOffsets[edge.to + 1];
+            if (bgn == end) return false;
+
+            auto itr = std::lower_bound(bgn, end, reverse, [=](int a, double angle)
+            {
+                return mHalfEdges[a].angle < angle;
+            });
+            const int next = (itr == bgn) ? *(end - 1) : *(itr - 1);
+
+            if (next == i) break;
+            if (mHalfEdges[next].visited) return false;
+            current = next;
+        }
+
+        if (mFace.size() < 3) return false;
+        triangulateMonotone(mFace);
+    }
+    return true;
+}
+
+void Triangulator::triangulateMonotone(const std::vector<int>& aFace)
+{
+    enum { kLeft = 0, kRight = 1 };
+    const int count = (int)aFace.size();
+
+    if (count == 3)
+    {
+        pushTriangle(aFace[0], aFace[1], aFace[2]);
+        return;
+    }
+
+    // find top and bottom
+    int top = 0;
+    int bottom = 0;
+    for (int i = 1; i < count; ++i)
+    {
+        if (isAbove(aFace[i], aFace[top])) top = i;
+        if (isAbove(aFace[bottom], aFace[i])) bottom = i;
+    }
+
+    // the anti-clockwise chain from the top is the left chain.
+    // merge both chains from top to bottom.
+    mChainSide.resize(mVertices.size());
+    mSorted.clear();
+    mChainSide[aFace[top]] = kLeft;
+    mSorted.push_back(aFace[top]);
+    {
+        int l = (top + 1) % count;
+        int r = (top + count - 1) % count;
+
+        while (l != bottom || r != bottom)
+        {
+            const bool takesLeft = (l == bottom) ? false :
+                                   (r == bottom) ? true :
+                                   isAbove(aFace[l], aFace[r]);
+            if (takesLeft)
+            {
+                mChainSide[aFace[l]] = kLeft;
+                mSorted.push_back(aFace[l]);
+                l = (l + 1) % count;
+            }
+            else
+            {
+                mChainSide[aFace[r]] = kRight;
+                mSorted.push_back(aFace[r]);
+                r = (r + count - 1) % count;
+            }
+        }
+    }
+    mChainSide[aFace[bottom]] = kLeft;
+    mSorted.push_back(aFace[bottom]);
+
+    auto cross = [=](int o, int a, int b)
+    {
+        auto& vo = mVertices[o];
+        auto& va = mVertices[a];
+        auto& vb = mVertices[b];
+        return (va.x - vo.x) * (vb.y - vo.y) - (va.y - vo.y) * (vb.x - vo.x);
+    };
+
+    mStack.clear();
+    mStack.push_back(mSorted[0]);
+    mStack.push_back(mSorted[1]);
+
+    for (int j = 2; j < count - 1; ++j)
+    {
+        const int u = mSorted[j];
+
+        if (mChainSide[u] != mChainSide[mStack.back()])
+        {
+            // connect to all vertices in the stack
+            for (int k = 0; k + 1 < (int)mStack.size(); ++k)
+            {
+                pushTriangle(u, mStack[k], mStack[k + 1]);
+            }
+            mStack.clear();
+            mStack.push_back(mSorted[j - 1]);
+            mStack.push_back(u);
+        }
+        else
+        {
+            int last = mStack.back();
+            mStack.pop_back();
+
+            while (!mStack.empty())
+            {
+                const int s = mStack.back();
+                const bool inside = (mChainSide[u] == kLeft) ?
+                            cross(s, last, u) > 0.0 :
+                            cross(u, last, s) > 0.0;
+                if (!inside) break;
+
+                pushTriangle(u, last, s);
+                last = s;
+                mStack.pop_back();
+            }
+            mStack.push_back(last);
+            mStack.push_back(u);
+        }
+    }
+
+    // connect the bottom to all remaining vertices
+    const int u = mSorted[count - 1];
+    for (int k = 0; k + 1 < (int)mStack.size(); ++k)
+    {
+        pushTriangle(u, mStack[k], mStack[k + 1]);
+    }
+}
+
+void Triangulator::pushTriangle(int aV0, int aV1, int aV2)
+{
+    auto& v0 = mVertices[aV0];
+    auto& v1 = mVertices[aV1];
+    auto& v2 = mVertices[aV2];
+
+    // anti-clockwise in the sweep coordinate
+    if ((v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x) < 0.0)
+    {
+        std::swap(aV1, aV2);
+    }
+    mTriangles.push_back(gl::Vector2::make(mVertices[aV0].pos));
+    mTriangles.push_back(gl::Vector2::make(mVertices[aV1].pos));
+    mTriangles.push_back(gl::Vector2::make(mVertices[aV2].pos));
+    ++mTriangleCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+void Triangulator::makeRoundChain()
+{
+    // the ear clipping expects a clockwise chain in the south east coordinate
+    const int count = (int)mVertices.size();
+    mPoints.resize(count);
+
+    Point* prev = &(mPoints[count - 1]);
+    for (int i = 0; i < count; ++i)
+    {
+        auto& curr = mPoints[i];
+        curr.pos = mVertices[count - 1 - i].pos;
+        prev->next = &curr;
+        curr.prev = prev;
+        prev = &curr;
+    }
 }
 
-bool Triangulator::triangulate()
+bool Triangulator::triangulateByEarClipping()
 {
-    mTriangles.reserve(mPoints.size() * 3);
+    makeRoundChain();
 
-    int remain = mPoints.size();
+    int remain = (int)mPoints.size();
     if (remain < 3) return false;
 
     mFirstPoint = &(mPoints[0]);
@@ -1,6 +1,7 @@
 #ifndef GL_TRIANGULATOR_H
 #define GL_TRIANGULATOR_H
 
+#include <vector>
 #include <QPolygonF>
 #include <QVector2D>
 #include <QVector>
@@ -11,17 +12,53 @@ namespace gl
 {
 
 // south east coordinate
-// triangulate a simple clockwise polygon by ear clipping algorithm.
+// triangulate a simple polygon by monotone partitioning in O(n log n).
+// the result triangles are anti-clockwise in any orientation of the polygon.
+// if the partitioning fails (ex. a self-intersecting polygon),
+// ear clipping algorithm is used as a fallback.
+// an instance can be reused to avoid reallocating the work buffers.
 class Triangulator
 {
 public:
+    Triangulator();
     Triangulator(const QPoint* aPoints, int aCount);
     Triangulator(const QPointF* aPoints, int aCount);
     Triangulator(const QPolygonF& aPolygon);
+
+    bool reset(const QPoint* aPoints, int aCount);
+    bool reset(const QPointF* aPoints, int aCount);
+    bool reset(const QPolygonF& aPolygon);
+
     explicit operator bool() const { return mIsSuccess; }
     const QVector<gl::Vector2>& triangles() const { return mTriangles; }
 
 private:
+    // a vertex in the sweep coordinate (y-up and anti-clockwise)
+    struct Vertex
+    {
+        double x;
+        double y;
+        QVector2D pos;
+    };
+
+    enum VertexType
+    {
+        VertexType_Start,
+        VertexType_End,
+        VertexType_Split,
+        VertexType_Merge,
+        VertexType_Regular
+    };
+
+    // an outgoing half edge of the partitioned polygon
+    struct HalfEdge
+    {
+        int from;
+        int to;
+        double angle;
+        bool visited;
+    };
+
     struct Point
     {
         Point() : pos(), prev(), next() {}
@@ -30,33 +67,77 @@ private:
         Point* next;
     };
 
-    template<typename tPointType> void makeRoundChain(const tPointType* aPoints, int aCount);
+    class EdgeOrder;
+
+    template<typename tPointType> bool resetImpl(const tPointType* aPoints, int aCount);
 
-    bool triangulate();
+    void orientAntiClockwise();
+    bool triangulateByMonotone();
+    bool makeMonotonePartition();
+    bool triangulateMonotoneFaces();
+    void triangulateMonotone(const std::vector<int>& aFace);
+    void pushTriangle(int aV0, int aV1, int aV2);
+    bool isAbove(int aLhs, int aRhs) const;
+    VertexType vertexType(int aIndex) const;
+    double edgeX(int aEdge) const;
+
+    void makeRoundChain();
+    bool triangulateByEarClipping();
     bool isConvex(const Point& aPoint) const;
     bool isEar(const Point& aPoint) const;
 
-    QVector<Point> mPoints;
+    // work buffers
+    std::vector<Vertex> mVertices;
+    std::vector<int> mOrder;
+    std::vector<VertexType> mTypes;
+    std::vector<int> mHelpers;
+    std::vector<HalfEdge> mHalfEdges;
+    std::vector<int> mOutgoings;
+    std::vector<int> mOutgoingOffsets;
+    std::vector<int> mFace;
+    std::vector<int> mChainSide;
+    std::vector<int> mSorted;
+    std::vector<int> mStack;
+    std::vector<Point> mPoints;
+    int mTriangleCount;
+    double mSweepX;
+    double mSweepY;
+
     QVector<gl::Vector2> mTriangles;
     Point* mFirstPoint;
     bool mIsSuccess;
 };
 
 template<typename tPointType>
-void Triangulator::makeRoundChain(const tPointType* aPoints, int aCount)
+bool Triangulator::resetImpl(const tPointType* aPoints, int aCount)
 {
-    mPoints.resize(aCount);
+    mTriangles.resize(0);
+    mVertices.clear();
+    mIsSuccess = false;
 
-    // make round chain
-    Point* prev = &(mPoints[aCount - 1]);
+    // remove duplicated points
     for (int i = 0; i < aCount; ++i)
     {
-        auto& curr = mPoints[i];
-        curr.pos = QVector2D(aPoints[i]);
-        prev->next = &curr;
-        curr.prev = prev;
-        prev = &curr;
+        const QVector2D pos(aPoints[i]);
+        if (!mVertices.empty() && mVertices.back().pos == pos) continue;
+        Vertex vertex = { (double)pos.x(), -(double)pos.y(), pos };
+        mVertices.push_back(vertex);
+    }
+    while (mVertices.size() > 1 && mVertices.back().pos == mVertices.front().pos)
+    {
+        mVertices.pop_back();
+    }
+    if (mVertices.size() < 3) return false;
+
+    orientAntiClockwise();
+    mIsSuccess = triangulateByMonotone();
+    if (!mIsSuccess)
+    {
+        mTriangles.resize(0);
+        mIsSuccess = triangulateByEarClipping();
     }
+    if (!mIsSuccess) mTriangles.resize(0);
+    return mIsSuccess;
 }
 
 } // namespace gl
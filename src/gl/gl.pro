@@ -40,7 +40,9 @@ SOURCES += \
     PrimitiveDrawer.cpp \
     Triangulator.cpp \
     FontDrawer.cpp \
-    TextObject.cpp
+    TextObject.cpp \
+    Profiler.cpp \
+    OffscreenContext.cpp
 
 HEADERS += \
     EasyShaderProgram.h \
@@ -64,4 +66,6 @@ HEADERS += \
     PrimitiveDrawer.h \
     Triangulator.h \
     FontDrawer.h \
-    TextObject.h
+    TextObject.h \
+    Profiler.h \
+    OffscreenContext.h
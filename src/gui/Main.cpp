@@ -1,4 +1,5 @@
 #include "gui/MSVCMemoryLeakDebugger.h" // first of all
+#include <cstdlib>
 #include <QApplication>
 #include <QDir>
 #include <QFile>
@@ -8,6 +9,7 @@
 #include "XC.h"
 #include "gl/Global.h"
 #include "ctrl/System.h"
+#include "ctrl/ExportShard.h"
 #include "gui/MainWindow.h"
 #include "gui/GUIResources.h"
 #include "gui/MSVCBackTracer.h"
@@ -60,6 +62,19 @@ public:
     }
 };
 
+// child processes of exports have no one to answer dialogs
+class ShardErrorHandler : public XCErrorHandler
+{
+public:
+    virtual void critical(
+            const QString& aText, const QString& aInfo,
+            const QString& aDetail) const
+    {
+        XC_REPORT() << aText << "\n" << aInfo << "\n" << aDetail;
+        std::exit(EXIT_FAILURE);
+    }
+};
+
 XCAssertHandler* gXCAssertHandler = nullptr;
 XCErrorHandler* gXCErrorHandler = nullptr;
 static AEAssertHandler sAEAssertHandler;
@@ -118,6 +133,18 @@ int entryPoint(int argc, char *argv[])
     // initialize current
     QDir::setCurrent(appDir);
 
+    // a child process of a sharded export
+    {
+        const QStringList args = app.arguments();
+        const int shardIndex = args.indexOf(ctrl::ExportShard::kArgument);
+        if (shardIndex >= 0 && shardIndex + 1 < args.size())
+        {
+            static ShardErrorHandler shardErrorHandler;
+            gXCErrorHandler = &shardErrorHandler;
+            return ctrl::ExportShard::executeChild(args.at(shardIndex + 1));
+        }
+    }
+
     // set fatal error handler
     static AEErrorHandler aeErrorHandler;
     gXCErrorHandler = &aeErrorHandler;
@@ -1,7 +1,12 @@
 #include <functional>
+#include <algorithm>
 #include <QMouseEvent>
 #include <QOpenGLFunctions>
 #include <QGuiApplication>
+#include <QPainter>
+#include <QFontMetrics>
+#include <QMap>
+#include <QHash>
 #include "XC.h"
 #include "util/Finally.h"
 #include "gl/Util.h"
@@ -15,6 +20,14 @@
 #include "gui/KeyCommandMap.h"
 #include "gui/MouseSetting.h"
 
+namespace
+{
+// the resolution is reduced up to 1/4 on playback.
+static const int kMaxProxyLevel = 2;
+static const int kProxySampleCount = 8;
+static const double kProxyTolerance = 1.2;
+}
+
 namespace gui
 {
 
@@ -32,6 +45,7 @@ MainDisplayWidget::MainDisplayWidget(ViaPoint& aViaPoint, QWidget* aParent)
     , mDestinationTexturizer()
     , mTextureDrawer()
     , mPainterHandle()
+    , mProfiler()
     , mRenderingLock()
     , mRenderInfo()
     , mAbstractCursor()
@@ -43,6 +57,12 @@ MainDisplayWidget::MainDisplayWidget(ViaPoint& aViaPoint, QWidget* aParent)
     , mMovingCanvasByTool(false)
     , mMovingCanvasByKey(false)
     , mDevicePixelRatio(1.0)
+    , mIsPlaying(false)
+    , mProxyLevel(0)
+    , mFrameTimer()
+    , mFrameTimeSum(0.0)
+    , mFrameCount(0)
+    , mIsFlushingEvents(false)
 {
 #ifdef USE_GL_CORE_PROFILE
     // setup opengl format
@@ -115,6 +135,7 @@ MainDisplayWidget::MainDisplayWidget(ViaPoint& aViaPoint, QWidget* aParent)
 
 MainDisplayWidget::~MainDisplayWidget()
 {
+    mProfiler.reset();
     mPainterHandle.reset();
     mTextureDrawer.reset();
     mDestinationTexturizer.reset();
@@ -171,6 +192,27 @@ void MainDisplayWidget::resetCamera()
     }
 }
 
+void MainDisplayWidget::setProfilerEnabled(bool aIsEnabled)
+{
+    if (aIsEnabled == (bool)mProfiler) return;
+
+    // queries require the context
+    this->makeCurrent();
+    if (aIsEnabled)
+    {
+        mProfiler.reset(new gl::Profiler());
+        gl::Profiler::setInstance(mProfiler.data());
+    }
+    else
+    {
+        gl::Profiler::setInstance(nullptr);
+        mProfiler.reset();
+    }
+    this->doneCurrent();
+
+    updateRender();
+}
+
 void MainDisplayWidget::setProjectTabBar(ProjectTabBar* aTabBar)
 {
     mProjectTabBar = aTabBar;
@@ -178,6 +220,9 @@ void MainDisplayWidget::setProjectTabBar(ProjectTabBar* aTabBar)
 
 void MainDisplayWidget::updateRender()
 {
+    // the frame being painted already reflects the flushed events
+    if (mIsFlushingEvents) return;
+
     this->update();
 }
 
@@ -227,16 +272,14 @@ void MainDisplayWidget::initializeGL()
 
     mDevicePixelRatio = this->devicePixelRatioF();
 
-    // create framebuffer for display
-    mFramebuffer.reset(new QOpenGLFramebufferObject(deviceSize()));
-
     // create clipping buffer
     mClippingFrame.reset(new core::ClippingFrame());
-    mClippingFrame->resize(deviceSize());
 
     // create texturizer for destination colors of the framebuffer
     mDestinationTexturizer.reset(new core::DestinationTexturizer());
-    mDestinationTexturizer->resize(deviceSize());
+
+    // create framebuffer for display
+    resizeFramebuffers(proxySize());
 
     // create texture drawer for copying framebuffer to display
     mTextureDrawer.reset(new gl::EasyTextureDrawer());
@@ -254,6 +297,21 @@ void MainDisplayWidget::paintGL()
 {
     gl::Global::Functions& ggl = gl::Global::functions();
 
+    // apply the modifications which were merged since the last frame
+    if (mProject)
+    {
+        mIsFlushingEvents = true;
+        mProject->flushTimeLineEvents();
+        mIsFlushingEvents = false;
+    }
+
+    // follow the proxy resolution
+    const QSize frameSize = proxySize();
+    if (mFramebuffer->size() != frameSize)
+    {
+        resizeFramebuffers(frameSize);
+    }
+
     // clear clipping
     mClippingFrame->clearTexture();
     mClippingFrame->resetClippingId();
@@ -268,7 +326,7 @@ void MainDisplayWidget::paintGL()
     }
 
     // setup
-    gl::Util::setViewportAsActualPixels(deviceSize());
+    gl::Util::setViewportAsActualPixels(frameSize);
     gl::Util::clearColorBuffer(0.25f, 0.25f, 0.25f, 1.0f);
     gl::Util::resetRenderState();
     GL_CHECK_ERROR();
@@ -277,11 +335,13 @@ void MainDisplayWidget::paintGL()
     if (mProject)
     {
         XC_PTR_ASSERT(mRenderInfo);
+        mRenderInfo->camera.setDevicePixelRatio(mDevicePixelRatio * proxyScale());
         mRenderInfo->time = mProject->currentTimeInfo();
         mRenderInfo->framebuffer = mFramebuffer->handle();
         mRenderInfo->dest = mFramebuffer->texture();
         mRenderInfo->isGrid = false;
         mRenderInfo->nonPosed = false;
+        mRenderInfo->cachesStaticTree = true;
         mRenderInfo->clippingId = 0;
         mRenderInfo->clippingFrame = mClippingFrame.data();
         mRenderInfo->destTexturizer = mDestinationTexturizer.data();
@@ -298,13 +358,21 @@ void MainDisplayWidget::paintGL()
         GL_CHECK_ERROR();
     }
 
+    if (mProject)
+    {
+        // the painter overlay uses the actual resolution
+        mRenderInfo->camera.setDevicePixelRatio(mDevicePixelRatio);
+    }
+
     if (!mFramebuffer->release())
     {
         XC_FATAL_ERROR("OpenGL Error", "Failed to unbind framebuffer.", "");
     }
 
     ggl.glBindFramebuffer(GL_FRAMEBUFFER, this->defaultFramebufferObject());
+    gl::Util::setViewportAsActualPixels(deviceSize());
 
+    gl::ProfileScope profile("pipeline", "present", true);
     if (mViewSetting.cutImagesByTheFrame && mProject)
     {
         XC_PTR_ASSERT(mRenderInfo);
@@ -323,6 +391,55 @@ void MainDisplayWidget::paintGL()
 
     ggl.glFlush();
     GL_CHECK_ERROR();
+
+    updateProxyLevel();
+}
+
+void MainDisplayWidget::resizeFramebuffers(const QSize& aSize)
+{
+    mFramebuffer.reset();
+    mFramebuffer.reset(new QOpenGLFramebufferObject(aSize));
+
+    if (aSize != deviceSize())
+    {
+        // a proxy frame is magnified on presentation
+        gl::Global::Functions& ggl = gl::Global::functions();
+        ggl.glBindTexture(GL_TEXTURE_2D, mFramebuffer->texture());
+        ggl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        ggl.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        ggl.glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    mClippingFrame->resize(aSize);
+    mDestinationTexturizer->resize(aSize);
+    GL_CHECK_ERROR();
+}
+
+void MainDisplayWidget::updateProxyLevel()
+{
+    if (!mIsPlaying || !mProject) return;
+
+    // measure intervals of the playback frames
+    if (!mFrameTimer.isValid())
+    {
+        mFrameTimer.start();
+        return;
+    }
+    mFrameTimeSum += mFrameTimer.nsecsElapsed() * 1e-6;
+    mFrameTimer.restart();
+    if (++mFrameCount < kProxySampleCount) return;
+
+    const double average = mFrameTimeSum / mFrameCount;
+    const double budget = 1000.0 / std::max(mProject->attribute().fps(), 1);
+    mFrameTimeSum = 0.0;
+    mFrameCount = 0;
+
+    // lower the resolution while the frame rate is not kept
+    if (average > budget * kProxyTolerance && mProxyLevel < kMaxProxyLevel)
+    {
+        ++mProxyLevel;
+        mFrameTimer.invalidate();
+    }
 }
 
 void MainDisplayWidget::paintEvent(QPaintEvent* aEvent)
@@ -331,6 +448,12 @@ void MainDisplayWidget::paintEvent(QPaintEvent* aEvent)
     if (!mRenderingLock.tryLockForRead()) return;
     util::Finally unlocker([=](){ this->mRenderingLock.unlock(); });
 
+    if (mProfiler)
+    {
+        this->makeCurrent();
+        mProfiler->beginFrame("display");
+    }
+
     QOpenGLWidget::paintEvent(aEvent);
 
     QPainter* painter = mPainterHandle->begin(*this);
@@ -342,15 +465,112 @@ void MainDisplayWidget::paintEvent(QPaintEvent* aEvent)
         mDriver->renderQt(*mRenderInfo, *painter);
         GL_CHECK_ERROR();
     }
+
+    if (mProfiler)
+    {
+        drawProfilerOverlay(*painter);
+    }
+
     // we must call end function
     mPainterHandle->end();
+
+    if (mProfiler)
+    {
+        this->makeCurrent();
+        mProfiler->endFrame();
+    }
+}
+
+void MainDisplayWidget::drawProfilerOverlay(QPainter& aPainter)
+{
+    static const int kFrameCount = 30;
+    static const int kLayerCount = 8;
+
+    auto& history = mProfiler->history();
+    if (history.empty()) return;
+
+    // average of recent frames
+    const int count = std::min((int)history.size(), kFrameCount);
+    double frameCpu = 0.0;
+    double frameGpu = 0.0;
+    QMap<QString, QPair<double, double>> stages;
+    QHash<QString, double> layers;
+
+    for (auto itr = history.end() - count; itr != history.end(); ++itr)
+    {
+        frameCpu += itr->cpuMSec();
+        frameGpu += itr->gpuMSec();
+
+        for (auto& scope : itr->scopes)
+        {
+            const double gpu = scope.hasGpu() ? scope.gpuMSec() : 0.0;
+            if (qstrcmp(scope.category, "pipeline") == 0 || qstrcmp(scope.category, "qt") == 0)
+            {
+                auto& stage = stages[scope.name];
+                stage.first += scope.cpuMSec();
+                stage.second += gpu;
+            }
+            else
+            {
+                // transform, draw and clipping of each layer
+                layers[scope.name] += scope.hasGpu() ? gpu : scope.cpuMSec();
+            }
+        }
+    }
+
+    auto msec = [=](double aValue) { return QString::number(aValue / count, 'f', 2); };
+
+    QStringList lines;
+    lines << "frame: cpu " + msec(frameCpu) + " ms, gpu " + msec(frameGpu) + " ms";
+    for (auto itr = stages.begin(); itr != stages.end(); ++itr)
+    {
+        lines << "  " + itr.key() + ": cpu " + msec(itr.value().first) +
+                 " ms, gpu " + msec(itr.value().second) + " ms";
+    }
+
+    QList<QPair<double, QString>> sortedLayers;
+    for (auto itr = layers.begin(); itr != layers.end(); ++itr)
+    {
+        sortedLayers.push_back(qMakePair(itr.value(), itr.key()));
+    }
+    std::sort(sortedLayers.begin(), sortedLayers.end(),
+              [](const QPair<double, QString>& a, const QPair<double, QString>& b)
+    {
+        return a.first > b.first;
+    });
+    lines << "layers:";
+    for (int i = 0; i < sortedLayers.count() && i < kLayerCount; ++i)
+    {
+        lines << "  " + sortedLayers[i].second + ": " + msec(sortedLayers[i].first) + " ms";
+    }
+
+    // draw
+    aPainter.save();
+    QFont font("Monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    aPainter.setFont(font);
+
+    const QFontMetrics metrics(font);
+    const int lineHeight = metrics.height();
+    int width = 0;
+    for (auto& line : lines)
+    {
+        width = std::max(width, metrics.width(line));
+    }
+    const QRect rect(8, 32, width + 16, lineHeight * lines.count() + 16);
+    aPainter.fillRect(rect, QColor(0, 0, 0, 160));
+    aPainter.setPen(QColor(230, 230, 230));
+    for (int i = 0; i < lines.count(); ++i)
+    {
+        aPainter.drawText(rect.left() + 8, rect.top() + 8 + metrics.ascent() + i * lineHeight, lines[i]);
+    }
+    aPainter.restore();
 }
 
 void MainDisplayWidget::resizeGL(int w, int h)
 {
     // currrent device pixel ratio (Attention that it is variable.)
     mDevicePixelRatio = this->devicePixelRatioF();
-    const QSize devSize(mDevicePixelRatio * w, mDevicePixelRatio * h); // device pixel size
     const QSize absSize(w, h); // abstract pixel size
 
     if (mRenderInfo)
@@ -359,14 +579,7 @@ void MainDisplayWidget::resizeGL(int w, int h)
         mRenderInfo->camera.setScreenSize(absSize);
         mCanvasMover.onScreenResized();
     }
-    mFramebuffer.reset();
-    mFramebuffer.reset(new QOpenGLFramebufferObject(devSize.width(), devSize.height()));
-
-    mClippingFrame.reset();
-    mClippingFrame.reset(new core::ClippingFrame());
-    mClippingFrame->resize(devSize);
-
-    mDestinationTexturizer->resize(devSize);
+    resizeFramebuffers(proxySize());
 
     if (mProjectTabBar)
     {
@@ -512,6 +725,21 @@ void MainDisplayWidget::onProjectAttributeUpdated()
     }
 }
 
+void MainDisplayWidget::onPlayBackStateChanged(bool aIsActive)
+{
+    mIsPlaying = aIsActive;
+    mFrameTimer.invalidate();
+    mFrameTimeSum = 0.0;
+    mFrameCount = 0;
+
+    // back to the full resolution on pause
+    if (!mIsPlaying && mProxyLevel != 0)
+    {
+        mProxyLevel = 0;
+        updateRender();
+    }
+}
+
 void MainDisplayWidget::updateCursor()
 {
     if (mDriver)
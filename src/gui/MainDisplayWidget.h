@@ -6,11 +6,13 @@
 #include <QScopedPointer>
 #include <QTabBar>
 #include <QReadWriteLock>
+#include <QElapsedTimer>
 #include "util/LinkPointer.h"
 #include "gl/Global.h"
 #include "gl/Root.h"
 #include "gl/VertexArrayObject.h"
 #include "gl/EasyTextureDrawer.h"
+#include "gl/Profiler.h"
 #include "core/Project.h"
 #include "core/AbstractCursor.h"
 #include "core/TimeInfo.h"
@@ -38,6 +40,8 @@ public:
     void setProjectTabBar(ProjectTabBar* aTabBar);
     void updateRender();
     void resetCamera();
+    void setProfilerEnabled(bool aIsEnabled);
+    bool isProfilerEnabled() const { return mProfiler; }
 
     QReadWriteLock& renderingLock() { return mRenderingLock; }
     const QReadWriteLock& renderingLock() const { return mRenderingLock; }
@@ -50,6 +54,7 @@ public:
     void onFinalizeTool(ctrl::ToolType);
     void onViewSettingChanged(const MainViewSetting&);
     void onProjectAttributeUpdated();
+    void onPlayBackStateChanged(bool aIsActive);
 
 private:
     class GLContextAccessor : public gl::ContextAccessor
@@ -73,7 +78,12 @@ private:
     virtual void tabletEvent(QTabletEvent* event);
 
     void updateCursor();
+    void drawProfilerOverlay(QPainter& aPainter);
     QSize deviceSize() const { return this->size() * mDevicePixelRatio; }
+    double proxyScale() const { return 1.0 / (1 << mProxyLevel); }
+    QSize proxySize() const { return this->size() * (mDevicePixelRatio * proxyScale()); }
+    void resizeFramebuffers(const QSize& aSize);
+    void updateProxyLevel();
 
     ViaPoint& mViaPoint;
     gl::DeviceInfo mGLDeviceInfo;
@@ -86,6 +96,7 @@ private:
     QScopedPointer<core::DestinationTexturizer> mDestinationTexturizer;
     QScopedPointer<gl::EasyTextureDrawer> mTextureDrawer;
     QScopedPointer<ctrl::PainterHandle> mPainterHandle;
+    QScopedPointer<gl::Profiler> mProfiler;
     QReadWriteLock mRenderingLock;
     core::RenderInfo* mRenderInfo;
     core::AbstractCursor mAbstractCursor;
@@ -97,6 +108,12 @@ private:
     bool mMovingCanvasByTool;
     bool mMovingCanvasByKey;
     double mDevicePixelRatio;
+    bool mIsPlaying;
+    int mProxyLevel;
+    QElapsedTimer mFrameTimer;
+    double mFrameTimeSum;
+    int mFrameCount;
+    bool mIsFlushingEvents;
 };
 
 } // namespace gui
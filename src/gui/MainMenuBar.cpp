@@ -162,7 +162,15 @@ MainMenuBar::MainMenuBar(MainWindow& aMainWindow, ViaPoint& aViaPoint, QWidget*
             }
         });
 
+        QAction* profiler = new QAction(tr("Profiler Overlay"), this);
+        profiler->setCheckable(true);
+        connect(profiler, &QAction::triggered, [=](bool aChecked)
+        {
+            mainWindow->onProfilerTriggered(aChecked);
+        });
+
         windowMenu->addAction(resource);
+        windowMenu->addAction(profiler);
     }
 
     QMenu* optionMenu = new QMenu(tr("Option"), this);
@@ -7,6 +7,7 @@
 #include <QShortcut>
 #include <QElapsedTimer>
 #include <QMessageBox>
+#include <QStatusBar>
 #include "util/IProgressReporter.h"
 #include "gl/Global.h"
 #include "ctrl/Exporter.h"
@@ -55,6 +56,7 @@ MainWindow::MainWindow(ctrl::System& aSystem, GUIResources& aResources, const Lo
     , mResourceDialog()
     , mDriverHolder()
     , mCurrent()
+    , mSavingTimer()
 {
     // setup default opengl format
     {
@@ -120,6 +122,12 @@ MainWindow::MainWindow(ctrl::System& aSystem, GUIResources& aResources, const Lo
         mViaPoint.setKeyCommandInvoker(mKeyCommandInvoker.data());
     }
 
+    // polling of background saving
+    {
+        mSavingTimer.setInterval(100);
+        this->connect(&mSavingTimer, &QTimer::timeout, this, &MainWindow::onSavingTimerTimeout);
+    }
+
     // create main menu bar
     {
         mMainMenuBar = new MainMenuBar(*this, mViaPoint, this);
@@ -260,6 +268,7 @@ MainWindow::MainWindow(ctrl::System& aSystem, GUIResources& aResources, const Lo
         timeLine.onFrameUpdated.connect(&driver, &DriverHolder::onFrameUpdated);
         timeLine.onFrameUpdated.connect(&prop, &PropertyWidget::onFrameUpdated);
         timeLine.onPlayBackStateChanged.connect(&prop, &PropertyWidget::onPlayBackStateChanged);
+        timeLine.onPlayBackStateChanged.connect(&disp, &MainDisplayWidget::onPlayBackStateChanged);
 
         menu.onProjectAttributeUpdated.connect(&disp, &MainDisplayWidget::onProjectAttributeUpdated);
         menu.onProjectAttributeUpdated.connect(&timeLine, &TimeLineWidget::onProjectAttributeUpdated);
@@ -364,6 +373,7 @@ void MainWindow::testNewProject(const QString& aFilePath)
 
 void MainWindow::closeAllProjects()
 {
+    finishProjectSaving();
     mProjectTabBar->removeAllProject();
     resetProjectRefs(nullptr);
     mSystem.closeAllProjects();
@@ -457,6 +467,8 @@ void MainWindow::keyReleaseEvent(QKeyEvent* aEvent)
 
 void MainWindow::closeEvent(QCloseEvent* aEvent)
 {
+    finishProjectSaving();
+
     if (mSystem.hasModifiedProject())
     {
         auto result = confirmProjectClosing(false);
@@ -568,6 +580,11 @@ void MainWindow::onRedoTriggered()
     }
 }
 
+void MainWindow::onProfilerTriggered(bool aChecked)
+{
+    mMainDisplay->setProfilerEnabled(aChecked);
+}
+
 void MainWindow::onNewProjectTriggered()
 {
     // stop animation and main display rendering
@@ -658,8 +675,11 @@ void MainWindow::onOpenProjectTriggered()
     }
 }
 
-bool MainWindow::processProjectSaving(core::Project& aProject, bool aRename)
+bool MainWindow::processProjectSaving(core::Project& aProject, bool aRename, bool aInBackground)
 {
+    // a previous saving uses the same cache file
+    finishProjectSaving();
+
     // stop animation and main display rendering
     EventSuspender suspender(*mMainDisplay, *mTarget);
 
@@ -681,6 +701,22 @@ bool MainWindow::processProjectSaving(core::Project& aProject, bool aRename)
         aProject.setFileName(fileName);
     }
 
+    if (aInBackground)
+    {
+        // take a snapshot only, the file is written on a worker thread
+        auto result = mSystem.beginSaving(aProject);
+        if (!result)
+        {
+            QMessageBox::warning(nullptr, "Saving Error", result.message);
+            return false; // failed
+        }
+
+        this->statusBar()->show();
+        this->statusBar()->showMessage(tr("Saving..."));
+        mSavingTimer.start();
+        return true;
+    }
+
     // save
     auto result = mSystem.saveProject(aProject);
     if (!result)
@@ -693,11 +729,46 @@ bool MainWindow::processProjectSaving(core::Project& aProject, bool aRename)
     return true;
 }
 
+bool MainWindow::finishProjectSaving()
+{
+    if (!mSystem.isSaving()) return true;
+
+    mSavingTimer.stop();
+    auto result = mSystem.endSaving();
+
+    this->statusBar()->clearMessage();
+    this->statusBar()->hide();
+    mProjectTabBar->updateTabNames();
+
+    if (!result)
+    {
+        QMessageBox::warning(nullptr, "Saving Error", result.message);
+        return false; // failed
+    }
+    return true;
+}
+
+void MainWindow::onSavingTimerTimeout()
+{
+    if (!mSystem.isSaving())
+    {
+        mSavingTimer.stop();
+    }
+    else if (mSystem.isSavingFinished())
+    {
+        finishProjectSaving();
+    }
+    else
+    {
+        this->statusBar()->showMessage(tr("Saving... %1%").arg(mSystem.savingProgress()));
+    }
+}
+
 void MainWindow::onSaveProjectTriggered()
 {
     if (mCurrent)
     {
-        processProjectSaving(*mCurrent);
+        processProjectSaving(*mCurrent, false, true);
     }
 }
 
@@ -705,7 +776,7 @@ void MainWindow::onSaveProjectAsTriggered()
 {
     if (mCurrent)
     {
-        processProjectSaving(*mCurrent, true);
+        processProjectSaving(*mCurrent, true, true);
     }
 }
 
@@ -713,6 +784,8 @@ void MainWindow::onCloseProjectTriggered()
 {
     if (mCurrent)
     {
+        finishProjectSaving();
+
         if (mCurrent->isModified())
         {
             auto result = confirmProjectClosing(true);
@@ -782,6 +855,11 @@ void MainWindow::onExportImageSeqTriggered(const QString& aSuffix)
     ctrl::Exporter exporter(*mCurrent);
     exporter.setOverwriteConfirmer(overwriteConfirmer);
     exporter.setProgressReporter(progress);
+    exporter.setShardCount(0);
+    if (mMainDisplay->isProfilerEnabled())
+    {
+        exporter.setProfileDumpPath(dirName + "/" + iparam.name + "_trace.json");
+    }
 
     // execute
     if (!exporter.execute(cparam, iparam))
@@ -861,6 +939,11 @@ void MainWindow::onExportVideoTriggered(const ctrl::VideoFormat& aFormat)
     exporter.setOverwriteConfirmer([=](const QString&)->bool { return true; });
     exporter.setProgressReporter(progress);
     exporter.setUILogger(progress);
+    exporter.setShardCount(0);
+    if (mMainDisplay->isProfilerEnabled())
+    {
+        exporter.setProfileDumpPath(fileName + "_trace.json");
+    }
 
     // execute
     auto result = isGif ?
@@ -5,6 +5,7 @@
 #include <QKeyEvent>
 #include <QFileInfo>
 #include <QScopedPointer>
+#include <QTimer>
 #include "ctrl/System.h"
 #include "gui/MainMenuBar.h"
 #include "gui/MainDisplayWidget.h"
@@ -52,6 +53,7 @@ public:
     void onExportVideoTriggered(const ctrl::VideoFormat& aFormat);
     void onUndoTriggered();
     void onRedoTriggered();
+    void onProfilerTriggered(bool aChecked);
 
 private:
     virtual void keyPressEvent(QKeyEvent* aEvent);
@@ -59,7 +61,9 @@ private:
     virtual void closeEvent(QCloseEvent* aEvent);
 
     void resetProjectRefs(core::Project* aProject);
-    bool processProjectSaving(core::Project& aProject, bool aRename = false);
+    bool processProjectSaving(core::Project& aProject, bool aRename = false, bool aInBackground = false);
+    bool finishProjectSaving();
+    void onSavingTimerTimeout();
     int confirmProjectClosing(bool aCurrentOnly);
     void onProjectTabChanged(core::Project&);
 
@@ -80,6 +84,7 @@ private:
     ResourceDialog* mResourceDialog;
     QScopedPointer<DriverHolder> mDriverHolder;
     core::Project* mCurrent;
+    QTimer mSavingTimer;
 };
 
 } // namespace gui
@@ -245,19 +245,21 @@ void TimeLineInnerWidget::paintEvent(QPaintEvent* aEvent)
     painter.end();
 }
 
-void TimeLineInnerWidget::onTimeLineModified(core::TimeLineEvent&, bool)
+void TimeLineInnerWidget::onTimeLineModified(core::TimeLineEvent& aEvent, bool)
 {
     if (!mOnPasting)
     {
         mCopyTargets = core::TimeLineEvent();
     }
-    mEditor->updateKey();
+    mEditor->updateKey(aEvent);
     this->update();
 }
 
 void TimeLineInnerWidget::onTreeRestructured(core::ObjectTreeEvent&, bool)
 {
     mCopyTargets = core::TimeLineEvent();
+    mEditor->updateTree();
+    this->update();
 }
 
 void TimeLineInnerWidget::onProjectAttributeModified(core::ProjectEvent&, bool)
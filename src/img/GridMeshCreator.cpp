@@ -1,9 +1,75 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "util/MathUtil.h"
 #include "util/TriangleRasterizer.h"
 #include "img/GridMeshCreator.h"
 #include "img/Util.h"
 #include "img/ColorRGBA.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMG_GRIDMESHCREATOR_USE_SSE2
+#endif
+
+namespace
+{
+
+// split [0, aCount) into contiguous bands and run them on separate threads.
+// aFunc(band index, begin, end) must only write to the rows of its own band.
+///@note the bands don't go through a thr::Paralleler on purpose. the creator runs
+/// on the caller's thread from layer loading, key edits and the bench, where no
+/// project is at hand, and the project's workers carry long bone influence builds
+/// which the bands would wait behind (or deadlock on, if called from a worker).
+/// the threads are joined before returning, so img keeps depending on util only.
+template<typename tFunc>
+void runInBands(int aCount, int aMinBandSize, const tFunc& aFunc)
+{
+    const int threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    const int bandCount = std::max(1, std::min(threadCount, aCount / std::max(1, aMinBandSize)));
+
+    if (bandCount == 1)
+    {
+        aFunc(0, 0, aCount);
+        return;
+    }
+
+    auto bandBegin = [=](int aBand) { return (int)((sint64)aCount * aBand / bandCount); };
+
+    std::vector<std::thread> threads;
+    threads.reserve(bandCount - 1);
+    for (int i = 1; i < bandCount; ++i)
+    {
+        threads.emplace_back(std::cref(aFunc), i, bandBegin(i), bandBegin(i + 1));
+    }
+    aFunc(0, 0, bandBegin(1));
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+static const int kMinRowsPerBand = 16;
+
+#if defined(IMG_GRIDMESHCREATOR_USE_SSE2)
+// returns the opacity bits of 16 rgba pixels
+inline uint32 getOpaBits16(const uint8* aPixels, __m128i aThreshold)
+{
+    auto src = (const __m128i*)aPixels;
+    const __m128i a0 = _mm_srli_epi32(_mm_loadu_si128(src + 0), 24);
+    const __m128i a1 = _mm_srli_epi32(_mm_loadu_si128(src + 1), 24);
+    const __m128i a2 = _mm_srli_epi32(_mm_loadu_si128(src + 2), 24);
+    const __m128i a3 = _mm_srli_epi32(_mm_loadu_si128(src + 3), 24);
+    const __m128i alpha = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+    // alpha >= threshold
+    const __m128i opaque = _mm_cmpeq_epi8(_mm_max_epu8(alpha, aThreshold), alpha);
+    return (uint32)_mm_movemask_epi8(opaque);
+}
+#endif
+
+} // namespace
+
 namespace img
 {
 
@@ -21,6 +87,8 @@ GridMeshCreator::Image::Image(const uint8* aPtr, const QSize& aSize)
     : mBuffer()
     , mData()
     , mSize(aSize)
+    , mOpaBits()
+    , mOpaBitsPitch((aSize.width() + 63) / 64)
 {
     XC_PTR_ASSERT(aPtr);
     XC_ASSERT(!aSize.isEmpty());
@@ -29,16 +97,85 @@ GridMeshCreator::Image::Image(const uint8* aPtr, const QSize& aSize)
     memcpy(mBuffer.data(), aPtr, mBuffer.size());
     img::Util::expandAlpha1Pixel(mBuffer.data(), mSize);
     mData = mBuffer.data();
+
+    // classify the opacity of each pixel
+    mOpaBits.reset(new uint64[mOpaBitsPitch * mSize.height()]);
+    runInBands(mSize.height(), kMinRowsPerBand, [=](int, int aBegin, int aEnd)
+    {
+        this->writeOpaBits(aBegin, aEnd);
+    });
 }
 
-bool GridMeshCreator::Image::hasSomeAlphaIn3x3(int aX, int aY) const
+void GridMeshCreator::Image::writeOpaBits(int aYBegin, int aYEnd)
 {
-    for (int i = -1; i < 2; ++i)
+    const int w = mSize.width();
+
+    for (int y = aYBegin; y < aYEnd; ++y)
     {
-        for (int k = -1; k < 2; ++k)
+        const uint8* row = mData + y * w * 4;
+        uint64* bits = mOpaBits.data() + y * mOpaBitsPitch;
+        int x = 0;
+
+#if defined(IMG_GRIDMESHCREATOR_USE_SSE2)
+        const __m128i threshold = _mm_set1_epi8((char)(kAlphaThreshold + 1));
+        for (; x + 64 <= w; x += 64)
         {
-            if (hasAlpha(aX + i, aY + k)) return true;
+            const uint8* pixels = row + x * 4;
+            bits[x >> 6] =
+                    ((uint64)getOpaBits16(pixels,       threshold)) |
+                    ((uint64)getOpaBits16(pixels +  64, threshold) << 16) |
+                    ((uint64)getOpaBits16(pixels + 128, threshold) << 32) |
+                    ((uint64)getOpaBits16(pixels + 192, threshold) << 48);
         }
+#endif
+        // remaining pixels
+        for (; x < w; x += 64)
+        {
+            const int end = std::min(x + 64, w);
+            uint64 word = 0;
+            for (int i = x; i < end; ++i)
+            {
+                if (row[i * 4 + 3] > kAlphaThreshold)
+                {
+                    word |= ((uint64)1 << (i - x));
+                }
+            }
+            bits[x >> 6] = word;
+        }
+    }
+}
+
+bool GridMeshCreator::Image::hasAlphaInRow(int aY, int aLeft, int aRight) const
+{
+    if (aY < 0 || mSize.height() <= aY) return false;
+
+    const int l = std::max(aLeft, 0);
+    const int r = std::min(aRight, mSize.width() - 1);
+    if (l > r) return false;
+
+    const uint64* bits = mOpaBits.data() + aY * mOpaBitsPitch;
+    const int lw = l >> 6;
+    const int rw = r >> 6;
+    const uint64 lmask = ~(uint64)0 << (l & 63);
+    const uint64 rmask = ~(uint64)0 >> (63 - (r & 63));
+
+    if (lw == rw)
+    {
+        return (bits[lw] & lmask & rmask) != 0;
+    }
+    if (bits[lw] & lmask) return true;
+    for (int i = lw + 1; i < rw; ++i)
+    {
+        if (bits[i]) return true;
+    }
+    return (bits[rw] & rmask) != 0;
+}
+
+bool GridMeshCreator::Image::hasSomeAlphaIn3x3(int aX, int aY) const
+{
+    for (int k = -1; k < 2; ++k)
+    {
+        if (hasAlphaInRow(aY + k, aX - 1, aX + 1)) return true;
     }
     return false;
 }
@@ -65,14 +202,9 @@ bool GridMeshCreator::Image::getOpaExistence(const Cell& aCell, const QSizeF& aC
         const int l = (int)(aCell.x + offs);
         const int r = (int)(aCell.x + cellWidth - offs);
 
-        for (int x = l; x <= r; ++x)
+        if (hasAlphaInRow(y, l, r))
         {
-            if (x < 0 || mSize.width() <= x) continue;
-
-            if (hasRawAlpha(x, y))
-            {
-                return true;
-            }
+            return true;
         }
     }
     return false;
@@ -256,19 +388,38 @@ GridMeshCreator::CellTable::CellTable(int aCellWidth)
 }
 
 int GridMeshCreator::CellTable::initCells(const Image &aImage)
+{
+    auto tableSize = calculateCellTableSize(aImage.size(), mCellSize);
+    mWidth = tableSize.width();
+    mHeight = tableSize.height();
+    mCells.reset(new Cell[mWidth * mHeight]);
+
+    // initialize each row bands in parallel
+    const int minRows = std::max(1, kMinRowsPerBand / std::max(1, (int)mCellSize.height()));
+    std::vector<int> counts(std::max(1, (int)std::thread::hardware_concurrency()), 0);
+    runInBands(mHeight, minRows, [&](int aBand, int aBegin, int aEnd)
+    {
+        counts[aBand] = this->initCellRows(aImage, aBegin, aEnd);
+    });
+
+    int count = 0;
+    for (auto bandCount : counts)
+    {
+        count += bandCount;
+    }
+    return count;
+}
+
+int GridMeshCreator::CellTable::initCellRows(const Image& aImage, int aYBegin, int aYEnd)
 {
     int count = 0;
 
     const float cellWidth = mCellSize.width();
     const float cellHeight = mCellSize.height();
     const float halfCellWidth = cellWidth * 0.5f;
-    auto tableSize = calculateCellTableSize(aImage.size(), mCellSize);
-    mWidth = tableSize.width();
-    mHeight = tableSize.height();
-    mCells.reset(new Cell[mWidth * mHeight]);
 
     // initialize each cells
-    for (int y = 0; y < mHeight; ++y)
+    for (int y = aYBegin; y < aYEnd; ++y)
     {
         const bool zalign = (y % 2 == 0);
         const int line = y * mWidth;
@@ -619,32 +770,10 @@ void GridMeshCreator::reduceBurrs(VertexTable& aTable, const Image& aImage)
     }
 
     // shorten reducing vectors if they are riding on a opaque pixels.
-    for (int y = 0; y < aTable.height(); ++y)
+    runInBands(aTable.height(), kMinRowsPerBand, [&](int, int aBegin, int aEnd)
     {
-        for (int x = 0; x < aTable.width(); ++x)
-        {
-            auto& vtx = aTable.vertex(x, y);
-            if (vtx.isExist)
-            {
-                if (vtx.maxReduce > 0.0f)
-                {
-                    vtx.reduceRate = 0.95f;
-                    const float maxReduce = vtx.maxReduce;
-
-                    for (int div = 0; div < 9; ++div)
-                    {
-                        auto pos = vtx.posReduced();
-
-                        if (!aImage.hasSomeAlphaIn3x3((int)pos.x(), (int)pos.y()))
-                        {
-                            break;
-                        }
-                        vtx.maxReduce = (1.0f - (div + 1) * 0.125f) * maxReduce;
-                    }
-                }
-            }
-        }
-    }
+        this->fitReducingVectorsToOpaques(aTable, aImage, aBegin, aEnd);
+    });
 
 #if 1
     auto iw = aImage.size().width();
@@ -815,4 +944,35 @@ void GridMeshCreator::reduceBurrs(VertexTable& aTable, const Image& aImage)
 #endif
 }
 
+void GridMeshCreator::fitReducingVectorsToOpaques(
+        VertexTable& aTable, const Image& aImage, int aYBegin, int aYEnd)
+{
+    for (int y = aYBegin; y < aYEnd; ++y)
+    {
+        for (int x = 0; x < aTable.width(); ++x)
+        {
+            auto& vtx = aTable.vertex(x, y);
+            if (vtx.isExist)
+            {
+                if (vtx.maxReduce > 0.0f)
+                {
+                    vtx.reduceRate = 0.95f;
+                    const float maxReduce = vtx.maxReduce;
+
+                    for (int div = 0; div < 9; ++div)
+                    {
+                        auto pos = vtx.posReduced();
+
+                        if (!aImage.hasSomeAlphaIn3x3((int)pos.x(), (int)pos.y()))
+                        {
+                            break;
+                        }
+                        vtx.maxReduce = (1.0f - (div + 1) * 0.125f) * maxReduce;
+                    }
+                }
+            }
+        }
+    }
+}
+
 } // namespace img
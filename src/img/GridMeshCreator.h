@@ -65,22 +65,30 @@ private:
 
     class Image
     {
+        enum { kAlphaThreshold = 10 };
+
         img::Buffer mBuffer;
         const uint8* mData;
         QSize mSize;
+        // one bit per pixel, set if the alpha is over the threshold
+        QScopedArrayPointer<uint64> mOpaBits;
+        int mOpaBitsPitch;
+
+        void writeOpaBits(int aYBegin, int aYEnd);
 
     public:
         Image(const uint8* aPtr, const QSize& aSize);
 
         QSize size() const { return mSize; }
         bool hasRawAlpha(int aX, int aY) const
-            { return mData[(aX + aY * mSize.width()) * 4 + 3] > 10; }
+            { return (mOpaBits[aY * mOpaBitsPitch + (aX >> 6)] >> (aX & 63)) & 1; }
         bool hasAlpha(int aX, int aY) const
         {
             if (aX < 0 || mSize.width() <= aX ||
                 aY < 0 || mSize.height() <= aY) return false;
             return hasRawAlpha(aX, aY);
         }
+        bool hasAlphaInRow(int aY, int aLeft, int aRight) const;
         bool hasSomeAlphaIn3x3(int aX, int aY) const;
         bool getOpaExistence(const Cell& aCell, const QSizeF& aCellSize) const;
     };
@@ -143,6 +151,7 @@ private:
 
         CellTable(int aCellWidth);
         int initCells(const Image& aImage);
+        int initCellRows(const Image& aImage, int aYBegin, int aYEnd);
         void connectCellsToVertices(VertexTable& aTable);
         Cell& cell(int aX, int aY);
         Cell* findExistingCell(int aX, int aY);
@@ -158,6 +167,8 @@ private:
     const Vertex* findConnectVertex(int aX, int aY, int aConnectId) const;
     void setIndicesOfExistingVertices(VertexTable& aTable);
     void reduceBurrs(VertexTable& aTable, const Image& aImage);
+    void fitReducingVectorsToOpaques(
+            VertexTable& aTable, const Image& aImage, int aYBegin, int aYEnd);
 
     QScopedPointer<CellTable> mCells;
     QScopedPointer<VertexTable> mVertices;
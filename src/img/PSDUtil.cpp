@@ -2,6 +2,8 @@
 #include <iostream>
 #include <cmath>
 #include "XC.h"
+#include "util/PackBits.h"
+#include "util/ChannelUtil.h"
 #include "img/PSDUtil.h"
 
 
@@ -154,44 +156,7 @@ XCMemBlock PSDUtil::makeClippedImage(
 //------------------------------------------------------------//
 size_t PSDUtil::encodePackBits(const uint8* aSrc, uint8* aDst, size_t aLength)
 {
-    const uint8* end = aSrc + aLength;
-
-    const uint8* p = aSrc;
-    uint8* dp = aDst;
-    long long int remains = aLength;
-
-    while (remains > 0)
-    {
-        const uint8* mark = p;
-        const uint8* markMax = mark + (remains < 128 ? remains : 128);
-
-        // found three duplicated value
-        if (mark <= (end - 3) && mark[0] == mark[1] && mark[1] == mark[2])
-        {
-            // scan
-            p += 3;
-            while (p < markMax && *p == mark[0]) ++p;
-
-            const int count = (int)(p - mark);
-            *dp++ = 1 + 256 - count;
-            *dp++ = mark[0];
-            remains -= count;
-        }
-        else
-        {
-            while (p < markMax)
-            {
-                if(p <= (end - 3) && p[0] == p[1] && p[1] == p[2]) break;
-                ++p;
-            }
-            const int count = (int)(p - mark);
-            *dp++ = count - 1;
-            memcpy(dp, mark, count);
-            dp += count;
-            remains -= count;
-        }
-    }
-    return dp - aDst;
+    return util::PackBits::encode(aSrc, aLength, aDst);
 }
 
 //------------------------------------------------------------//
@@ -215,10 +180,7 @@ XCMemBlock PSDUtil::encodePlanePackBits(
     {
         XC_ASSERT(currentLength <= totalLength);
 
-        for (int x = 0; x < aWidth; ++x)
-        {
-            srcLine[x] = aSrc[(x + y * aWidth) * aSrcStride];
-        }
+        util::ChannelUtil::extract(aSrc + y * aWidth * aSrcStride, aWidth, aSrcStride, srcLine.get());
 
         // encode data
         const size_t lineLength = encodePackBits(srcLine.get(), work.get() + currentLength, aWidth);
@@ -325,14 +287,7 @@ bool PSDUtil::makeChanneledImage(
                 return false;
             }
 
-            for (int y = 0; y < h; ++y)
-            {
-                for (int x = 0; x < w; ++x)
-                {
-                    (chan->data.get())[x + y * w] =
-                            (aSrc.data)[(x + y * w) * compoNum + index];
-                }
-            }
+            util::ChannelUtil::extract(aSrc.data + index, (size_t)(w * h), compoNum, chan->data.get());
         }
         else if (chan->compressionId == 1)
         {
@@ -390,73 +345,33 @@ bool PSDUtil::decodePlanePackBits(
     }
 
     // decompress RLE for each scanlines
+    std::vector<uint8> line(aDstStride == 1 ? 0 : aWidth);
+
     for(int y = 0; y < aHeight; ++y)
     {
-        const uint8* lineEnd = srcData + XC_FROM_BIG_ENDIAN(header[y]);
+        const size_t lineLength = XC_FROM_BIG_ENDIAN(header[y]);
 
         // too short
-        if (aSrc + aSrcLength < lineEnd)
+        if ((size_t)(aSrc + aSrcLength - srcData) < lineLength)
         {
             PSDUTIL_DUMP("decode packbits error 4");
             return false;
         }
 
-        int x = 0;
-        while (srcData < lineEnd)
+        // a plane is decoded directly, otherwise it's scattered after decoding
+        uint8* dst = (aDstStride == 1) ? aDst : line.data();
+        if (!util::PackBits::decode(srcData, lineLength, dst, (size_t)aWidth))
         {
-            // packet header
-            const char packHead = (char)(*srcData);
-
-            if (packHead < 0)
-            {
-                // noop operation
-                if (packHead == -128) continue;
-
-                // continuos operation
-                const int count = -packHead + 1;
-                x += count;
-                if (x > aWidth)
-                {
-                    PSDUTIL_DUMP("decode packbits error 5");
-                    return false;
-                }
-
-                const uint8 value = *(++srcData);
-                for (int i = 0; i < count; ++i, aDst += aDstStride)
-                {
-                    *aDst = value;
-                }
-            }
-            else
-            {
-                // no continuos operation
-                const int count = packHead + 1;
-                x += count;
-                if (x > aWidth)
-                {
-                    PSDUTIL_DUMP("decode packbits error 6: %d", x);
-                    return false;
-                }
-
-                for (int i = 0; i < count; ++i, aDst += aDstStride)
-                {
-                    if (srcData >= lineEnd)
-                    {
-                        PSDUTIL_DUMP("decode packbits error 7");
-                        return false;
-                    }
-                    *aDst = *(++srcData);
-                }
-            }
-
-            if (srcData < lineEnd) ++srcData;
+            PSDUTIL_DUMP("decode packbits error 5: line %d", y);
+            return false;
         }
-
-        if (x != aWidth)
+        if (aDstStride != 1)
         {
-            PSDUTIL_DUMP("decode packbits error 8: %d", x);
-            return false;
+            util::ChannelUtil::insert(line.data(), (size_t)aWidth, aDstStride, aDst);
         }
+
+        srcData += lineLength;
+        aDst += aWidth * aDstStride;
     }
 
     return true;
@@ -554,13 +469,7 @@ XCMemBlock PSDUtil::makeInterleavedImage(
         {
             if (chan->compressionId == 0)
             {
-                for (int y = 0; y < h; ++y)
-                {
-                    for (int x = 0; x < w; ++x)
-                    {
-                        (image.data)[(x + y * w) * stride + i] = (chan->data.get())[x + y * w];
-                    }
-                }
+                util::ChannelUtil::insert(chan->data.get(), (size_t)(w * h), stride, image.data + i);
             }
             else if (chan->compressionId == 1)
             {
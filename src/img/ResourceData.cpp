@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <cstring>
 #include "util/MathUtil.h"
+#include "util/ContentHash.h"
 #include "img/ResourceNode.h"
 #include "img/ResourceHandle.h"
 
@@ -7,7 +9,8 @@ namespace img
 {
 
 ResourceData::ResourceData(const QString& aIdentifier, const ResourceNode* aSerialAddress)
-    : mBuffer()
+    : mBuffer(std::make_shared<img::Buffer>())
+    , mImageHash(util::ContentHash::compute(nullptr, 0))
     , mPos()
     , mUserData()
     , mIsLayer()
@@ -20,17 +23,45 @@ ResourceData::ResourceData(const QString& aIdentifier, const ResourceNode* aSeri
 
 void ResourceData::grabImage(const XCMemBlock& aBlock, const QSize& aSize, Format aFormat)
 {
-    mBuffer.grab(aFormat, aBlock, aSize);
+    grabImage(aBlock, aSize, aFormat, util::ContentHash::compute(aBlock));
+}
+
+void ResourceData::grabImage(const XCMemBlock& aBlock, const QSize& aSize, Format aFormat, uint64 aHash)
+{
+    mBuffer = std::make_shared<img::Buffer>();
+    mBuffer->grab(aFormat, aBlock, aSize);
+    mImageHash = aHash;
 }
 
 XCMemBlock ResourceData::releaseImage()
 {
-    return mBuffer.release();
+    XCMemBlock block;
+
+    if (mBuffer.use_count() == 1)
+    {
+        block = mBuffer->release();
+    }
+    else if (mBuffer->data())
+    {
+        // the buffer is shared by the others
+        block.size = mBuffer->size();
+        block.data = new uint8[block.size];
+        memcpy(block.data, mBuffer->data(), block.size);
+    }
+    freeImage();
+    return block;
 }
 
 void ResourceData::freeImage()
 {
-    mBuffer.free();
+    mBuffer = std::make_shared<img::Buffer>();
+    mImageHash = util::ContentHash::compute(nullptr, 0);
+}
+
+void ResourceData::shareImage(const ResourceData& aData)
+{
+    mBuffer = aData.mBuffer;
+    mImageHash = aData.mImageHash;
 }
 
 void ResourceData::setPos(const QPoint& aPos)
@@ -53,6 +84,7 @@ void ResourceData::setBlendMode(BlendMode aMode)
 void ResourceData::copyFrom(const ResourceData& aData)
 {
     mBuffer = aData.mBuffer;
+    mImageHash = aData.mImageHash;
     mUserData = aData.mUserData;
     mIdentifier = aData.mIdentifier;
     mPos = aData.mPos;
@@ -63,7 +95,7 @@ void ResourceData::copyFrom(const ResourceData& aData)
 
 QRect ResourceData::rect() const
 {
-    return QRect(mPos, mBuffer.pixelSize());
+    return QRect(mPos, mBuffer->pixelSize());
 }
 
 QVector2D ResourceData::center() const
@@ -78,14 +110,21 @@ bool ResourceData::hasSameLayerDataWith(const ResourceData& aData)
     if (blendMode() != aData.blendMode()) return false;
     if (!hasImage()) return !aData.hasImage();
     if (!aData.hasImage()) return false;
+
+    // the hashes reject most of the differences, the bytes decide the rest
+    return hasSameImageWith(aData);
+}
+
+bool ResourceData::hasSameImageWith(const ResourceData& aData) const
+{
+    if (mBuffer == aData.mBuffer) return true;
+    if (imageHash() != aData.imageHash()) return false;
     if (image().pixelSize() != aData.image().pixelSize()) return false;
     if (image().format() != aData.image().format()) return false;
 
     auto size = image().size();
     XC_ASSERT(size == aData.image().size());
-    auto ptr1 = image().data();
-    auto ptr2 = aData.image().data();
-    return std::equal(ptr1, ptr1 + size, ptr2);
+    return size == 0 || memcmp(image().data(), aData.image().data(), size) == 0;
 }
 
 } // namespace img
@@ -2,6 +2,7 @@
 #define IMG_RESOURCEDATA_H
 
 #include <functional>
+#include <memory>
 #include <QPoint>
 #include "img/Buffer.h"
 #include "img/BlendMode.h"
@@ -19,8 +20,10 @@ public:
     virtual ~ResourceData() {}
 
     void grabImage(const XCMemBlock& aBlock, const QSize& aSize, Format aFormat);
+    void grabImage(const XCMemBlock& aBlock, const QSize& aSize, Format aFormat, uint64 aHash);
     XCMemBlock releaseImage();
     void freeImage();
+    void shareImage(const ResourceData& aData); // share a same image buffer
 
     void setIdentifier(const QString& aId) { mIdentifier = aId; }
     void setPos(const QPoint& aPos);
@@ -30,9 +33,11 @@ public:
     void copyFrom(const ResourceData& aData);
 
     bool isLayer() const { return mIsLayer; }
-    bool hasImage() const { return mBuffer.data(); }
+    bool hasImage() const { return mBuffer->data(); }
     const QString& identifier() const { return mIdentifier; }
-    const img::Buffer& image() const { return mBuffer; }
+    const img::Buffer& image() const { return *mBuffer; }
+    std::shared_ptr<const img::Buffer> sharedImage() const { return mBuffer; }
+    uint64 imageHash() const { return mImageHash; } // content hash of image bytes
     const QPoint& pos() const { return mPos; }
     void* userData() const { return mUserData; }
     BlendMode blendMode() const { return mBlendMode; }
@@ -44,10 +49,12 @@ public:
     QRect rect() const;
     QVector2D center() const;
 
-    bool hasSameLayerDataWith(const ResourceData& aData); // it's heavy
+    bool hasSameLayerDataWith(const ResourceData& aData);
+    bool hasSameImageWith(const ResourceData& aData) const; // compare bytes if hashes are same
 
 private:
-    img::Buffer mBuffer;
+    std::shared_ptr<img::Buffer> mBuffer; ///@note it's never modified after grabbing
+    uint64 mImageHash;
     QPoint mPos;
     void* mUserData;
     bool mIsLayer;
@@ -0,0 +1,43 @@
+#ifndef THR_CANCELTOKEN_H
+#define THR_CANCELTOKEN_H
+
+#include <atomic>
+#include <memory>
+
+namespace thr
+{
+
+// a cancel flag which is shared by copies.
+// a default constructed token is never canceled.
+class CancelToken
+{
+public:
+    static CancelToken create()
+    {
+        CancelToken token;
+        token.mFlag = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    CancelToken()
+        : mFlag()
+    {
+    }
+
+    void cancel() const
+    {
+        if (mFlag) mFlag->store(true, std::memory_order_relaxed);
+    }
+
+    bool isCanceled() const
+    {
+        return mFlag && mFlag->load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> mFlag;
+};
+
+} // namespace thr
+
+#endif // THR_CANCELTOKEN_H
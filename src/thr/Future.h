@@ -0,0 +1,223 @@
+#ifndef THR_FUTURE_H
+#define THR_FUTURE_H
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <condition_variable>
+#include "XC.h"
+
+namespace thr
+{
+
+template<typename tValue> class Promise;
+
+//-------------------------------------------------------------------------------------------------
+// the untyped part of a future. it is used to wait for several results.
+class FutureBase
+{
+public:
+    FutureBase()
+        : mState()
+    {
+    }
+
+    bool isValid() const { return (bool)mState; }
+
+    bool isReady() const
+    {
+        XC_PTR_ASSERT(mState);
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        return mState->isReady;
+    }
+
+    void wait() const
+    {
+        XC_PTR_ASSERT(mState);
+        std::unique_lock<std::mutex> lock(mState->mutex);
+        mState->condition.wait(lock, [=]() { return mState->isReady; });
+    }
+
+    // call aFunc once the result is ready.
+    // it is called immediately if ready, otherwise on the thread which sets the result.
+    void onReady(const std::function<void()>& aFunc) const
+    {
+        XC_PTR_ASSERT(mState);
+        {
+            std::lock_guard<std::mutex> lock(mState->mutex);
+            if (!mState->isReady)
+            {
+                mState->continuations.push_back(aFunc);
+                return;
+            }
+        }
+        aFunc();
+    }
+
+protected:
+    struct State
+    {
+        State()
+            : mutex()
+            , condition()
+            , isReady(false)
+            , continuations()
+        {
+        }
+        virtual ~State() {}
+
+        // called by a promise after writing the value
+        void setReady()
+        {
+            std::vector<std::function<void()>> continuations;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                XC_ASSERT(!isReady);
+                isReady = true;
+                continuations.swap(this->continuations);
+            }
+            condition.notify_all();
+
+            for (auto& continuation : continuations)
+            {
+                continuation();
+            }
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool isReady;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    explicit FutureBase(const std::shared_ptr<State>& aState)
+        : mState(aState)
+    {
+    }
+
+    std::shared_ptr<State> mState;
+};
+
+//-------------------------------------------------------------------------------------------------
+// a result which is written by another thread once.
+template<typename tValue>
+class Future : public FutureBase
+{
+    friend class Promise<tValue>;
+public:
+    Future() {}
+
+    // block until the result is ready
+    const tValue& get() const
+    {
+        wait();
+        return static_cast<const ValueState*>(mState.get())->value;
+    }
+
+private:
+    struct ValueState : public State
+    {
+        ValueState() : value() {}
+        tValue value;
+    };
+
+    explicit Future(const std::shared_ptr<ValueState>& aState)
+        : FutureBase(aState)
+    {
+    }
+};
+
+template<>
+class Future<void> : public FutureBase
+{
+    friend class Promise<void>;
+public:
+    Future() {}
+
+    void get() const { wait(); }
+
+private:
+    explicit Future(const std::shared_ptr<State>& aState)
+        : FutureBase(aState)
+    {
+    }
+};
+
+//-------------------------------------------------------------------------------------------------
+// the writer side of a future
+template<typename tValue>
+class Promise
+{
+public:
+    Promise()
+        : mState(std::make_shared<State>())
+    {
+    }
+
+    Future<tValue> future() const { return Future<tValue>(mState); }
+
+    void setValue(const tValue& aValue) const
+    {
+        mState->value = aValue;
+        mState->setReady();
+    }
+
+    void setValue(tValue&& aValue) const
+    {
+        mState->value = std::move(aValue);
+        mState->setReady();
+    }
+
+private:
+    typedef typename Future<tValue>::ValueState State;
+    std::shared_ptr<State> mState;
+};
+
+template<>
+class Promise<void>
+{
+public:
+    Promise()
+        : mState(std::make_shared<Future<void>::State>())
+    {
+    }
+
+    Future<void> future() const { return Future<void>(mState); }
+
+    void setValue() const { mState->setReady(); }
+
+private:
+    std::shared_ptr<Future<void>::State> mState;
+};
+
+//-------------------------------------------------------------------------------------------------
+// a future which is ready after all of aFutures are ready
+inline Future<void> whenAll(const std::vector<FutureBase>& aFutures)
+{
+    Promise<void> promise;
+    if (aFutures.empty())
+    {
+        promise.setValue();
+        return promise.future();
+    }
+
+    auto remains = std::make_shared<std::atomic<int>>((int)aFutures.size());
+    for (auto& future : aFutures)
+    {
+        future.onReady([=]()
+        {
+            if (remains->fetch_sub(1) == 1)
+            {
+                promise.setValue();
+            }
+        });
+    }
+    return promise.future();
+}
+
+} // namespace thr
+
+#endif // THR_FUTURE_H
@@ -3,10 +3,35 @@
 namespace thr
 {
 
+//-------------------------------------------------------------------------------------------------
+// a task which is owned by the worker running it
+class Paralleler::AutoTask : public Task
+{
+public:
+    AutoTask(const std::function<void()>& aFunc,
+             const std::function<void()>& aDiscard)
+        : mFunc(aFunc)
+        , mDiscard(aDiscard)
+    {
+    }
+
+protected:
+    virtual void run() { mFunc(); }
+    virtual bool isAutoDeleted() const { return true; }
+    virtual void discard() { mDiscard(); }
+
+private:
+    std::function<void()> mFunc;
+    std::function<void()> mDiscard;
+};
+
+//-------------------------------------------------------------------------------------------------
+
 Paralleler::Paralleler(int aWorkerCount)
     : mQueue()
     , mWorkers()
     , mWorkerCount(aWorkerCount)
+    , mIsClosed(false)
 {
     for (int i = 0; i < mWorkerCount; ++i)
     {
@@ -14,6 +39,15 @@ Paralleler::Paralleler(int aWorkerCount)
     }
 }
 
+Paralleler::~Paralleler()
+{
+    // the continuations running from now on discard their tasks immediately
+    mIsClosed = true;
+
+    // join the workers before the queue discards the remaining tasks
+    mWorkers.clear();
+}
+
 void Paralleler::start(QThread::Priority aPriority)
 {
     for (auto& worker : mWorkers)
@@ -39,4 +73,15 @@ void Paralleler::wakeAll()
     mQueue.wakeAll();
 }
 
+void Paralleler::pushAutoTask(
+        const std::function<void()>& aFunc, const std::function<void()>& aDiscard)
+{
+    if (mIsClosed)
+    {
+        aDiscard();
+        return;
+    }
+    mQueue.push(*(new AutoTask(aFunc, aDiscard)));
+}
+
 } // namespace thr
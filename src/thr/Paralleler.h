@@ -2,19 +2,28 @@
 #define THR_PARALLELER_H
 
 #include <list>
+#include <atomic>
 #include <memory>
+#include <utility>
+#include <functional>
+#include <type_traits>
 #include "util/NonCopyable.h"
 #include "thr/Task.h"
+#include "thr/Future.h"
+#include "thr/CancelToken.h"
 #include "thr/TaskQueue.h"
 #include "thr/Worker.h"
 
 namespace thr
 {
 
+// a paralleler must outlive the futures passed to then() or after(),
+// since their continuations push the next tasks into it.
 class Paralleler : private util::NonCopyable
 {
 public:
     Paralleler(int aWorkerCount);
+    ~Paralleler();
 
     void start(QThread::Priority aPriority = QThread::InheritPriority);
 
@@ -22,10 +31,90 @@ public:
     void cancel(Task& aTask);
     void wakeAll();
 
+    // run aFunc on a worker and return the future of its result.
+    // aFunc is skipped if aToken was canceled before the running or the paralleler
+    // was destroyed before it, and then the result is a default constructed value.
+    template<typename tFunc>
+    Future<typename std::result_of<tFunc()>::type> async(
+            tFunc aFunc, const CancelToken& aToken = CancelToken())
+    {
+        typedef typename std::result_of<tFunc()>::type ResultType;
+        Promise<ResultType> promise;
+        std::function<void()> discard = [=]()
+        {
+            fulfil(promise, []() { return ResultType(); });
+        };
+        std::function<void()> body = [=]()
+        {
+            if (!aToken.isCanceled())
+            {
+                fulfil(promise, aFunc);
+            }
+            else
+            {
+                discard();
+            }
+        };
+        pushAutoTask(body, discard);
+        return promise.future();
+    }
+
+    // run aFunc with the result of aFuture on a worker after aFuture gets ready.
+    template<typename tValue, typename tFunc>
+    Future<typename std::result_of<tFunc(const tValue&)>::type> then(
+            const Future<tValue>& aFuture, tFunc aFunc,
+            const CancelToken& aToken = CancelToken())
+    {
+        typedef typename std::result_of<tFunc(const tValue&)>::type ResultType;
+        Promise<ResultType> promise;
+        aFuture.onReady([=]()
+        {
+            Future<ResultType> next = this->async([=]() { return aFunc(aFuture.get()); }, aToken);
+            next.onReady([=]() { fulfil(promise, [=]() { return next.get(); }); });
+        });
+        return promise.future();
+    }
+
+    // run aFunc on a worker after aFuture gets ready. (e.g. a future of whenAll)
+    template<typename tFunc>
+    Future<typename std::result_of<tFunc()>::type> after(
+            const FutureBase& aFuture, tFunc aFunc,
+            const CancelToken& aToken = CancelToken())
+    {
+        typedef typename std::result_of<tFunc()>::type ResultType;
+        Promise<ResultType> promise;
+        aFuture.onReady([=]()
+        {
+            Future<ResultType> next = this->async(aFunc, aToken);
+            next.onReady([=]() { fulfil(promise, [=]() { return next.get(); }); });
+        });
+        return promise.future();
+    }
+
 private:
+    class AutoTask;
+
+    template<typename tValue, typename tFunc>
+    static void fulfil(const Promise<tValue>& aPromise, const tFunc& aFunc)
+    {
+        aPromise.setValue(aFunc());
+    }
+
+    template<typename tFunc>
+    static void fulfil(const Promise<void>& aPromise, const tFunc& aFunc)
+    {
+        aFunc();
+        aPromise.setValue();
+    }
+
+    // aDiscard is called instead of aFunc if the task is never run.
+    void pushAutoTask(const std::function<void()>& aFunc,
+                      const std::function<void()>& aDiscard);
+
     TaskQueue mQueue;
     std::list<std::unique_ptr<Worker>> mWorkers;
     int mWorkerCount;
+    std::atomic<bool> mIsClosed;
 };
 
 } // namespace thr
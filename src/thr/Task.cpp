@@ -1,4 +1,3 @@
-#include <QThread>
 #include "thr/Task.h"
 
 namespace thr
@@ -7,67 +6,83 @@ namespace thr
 Task::Task()
     : mState(State_Idle)
     , mIsCanceling(false)
-    , mLock()
+    , mWaitMutex()
+    , mWaitCondition()
 {
 }
 
 Task::~Task()
 {
     wait();
+
+    // a worker may be still notifying the finish
+    std::lock_guard<std::mutex> lock(mWaitMutex);
 }
 
 void Task::wait() const
 {
-    while (isRunning())
-    {
-        QThread::msleep(1);
-    }
+    if (!isRunning()) return;
+
+    std::unique_lock<std::mutex> lock(mWaitMutex);
+    mWaitCondition.wait(lock, [=]() { return !isRunning(); });
+}
+
+void Task::waitFinish() const
+{
+    if (isFinished()) return;
+
+    std::unique_lock<std::mutex> lock(mWaitMutex);
+    mWaitCondition.wait(lock, [=]() { return isFinished(); });
 }
 
 bool Task::isFinished() const
 {
-    QReadLocker locker(&mLock);
-    return mState == State_Finish;
+    return mState.load(std::memory_order_acquire) == State_Finish;
 }
 
 bool Task::isRunning() const
 {
-    QReadLocker locker(&mLock);
-    return mState == State_Run;
+    return mState.load(std::memory_order_acquire) == State_Run;
 }
 
 bool Task::isCanceling() const
 {
-    QReadLocker locker(&mLock);
-    return mIsCanceling;
+    return mIsCanceling.load(std::memory_order_relaxed);
 }
 
 void Task::setIdle()
 {
-    QWriteLocker locker(&mLock);
-    mState = State_Idle;
+    mIsCanceling.store(false, std::memory_order_relaxed);
+    setState(State_Idle);
 }
 
 void Task::setRun()
 {
-    QWriteLocker locker(&mLock);
-    mState = State_Run;
+    setState(State_Run);
 }
 
 void Task::setFinish()
 {
-    QWriteLocker locker(&mLock);
-    mState = State_Finish;
-    mIsCanceling = false;
+    mIsCanceling.store(false, std::memory_order_relaxed);
+    setState(State_Finish);
 }
 
 void Task::setCancel()
 {
-    QWriteLocker locker(&mLock);
-    if (mState == State_Run)
+    // the flag is meaningful only for a running task
+    if (isRunning())
     {
-        mIsCanceling = true;
+        mIsCanceling.store(true, std::memory_order_relaxed);
     }
 }
 
+void Task::setState(State aState)
+{
+    // lock so that a waiter never misses the notification,
+    // and the task is never destroyed while notifying
+    std::lock_guard<std::mutex> lock(mWaitMutex);
+    mState.store(aState, std::memory_order_release);
+    mWaitCondition.notify_all();
+}
+
 } // namespace thr
@@ -1,7 +1,9 @@
 #ifndef THR_TASK
 #define THR_TASK
 
-#include <QReadWriteLock>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 namespace thr { class Paralleler; }
 namespace thr { class Worker; }
 namespace thr { class TaskQueue; }
@@ -18,7 +20,11 @@ public:
     Task();
     virtual ~Task();
 
+    // block while a worker is running the task
     void wait() const;
+    // block until a worker finishes the task. (the task has to be pushed)
+    void waitFinish() const;
+
     bool isFinished() const;
     bool isRunning() const;
     bool isCanceling() const;
@@ -26,6 +32,12 @@ public:
 protected:
     virtual void run() = 0;
 
+    // a task which is allocated by the paralleler deletes itself after running.
+    virtual bool isAutoDeleted() const { return false; }
+
+    // called instead of run() if an auto deleted task is left in a destroyed queue.
+    virtual void discard() {}
+
 private:
     enum State
     {
@@ -38,13 +50,14 @@ private:
     void setRun();
     void setFinish();
     void setCancel();
+    void setState(State aState);
 
-    State mState;
-    bool mIsCanceling;
-    mutable QReadWriteLock mLock;
+    std::atomic<int> mState;
+    std::atomic<bool> mIsCanceling;
+    mutable std::mutex mWaitMutex;
+    mutable std::condition_variable mWaitCondition;
 };
 
 } // namespace thr
 
 #endif // THR_TASK
-
@@ -8,15 +8,37 @@ TaskQueue::TaskQueue()
     : mTaskList()
     , mLock()
     , mCondition()
-    , mCondLock()
 {
 }
 
+TaskQueue::~TaskQueue()
+{
+    // tasks which nobody owns
+    // (discarding a task may push another one by the continuation of its future)
+    while (1)
+    {
+        Task* task = nullptr;
+        {
+            QMutexLocker locker(&mLock);
+            if (mTaskList.empty()) break;
+            task = mTaskList.front();
+            mTaskList.pop_front();
+        }
+
+        if (task->isAutoDeleted())
+        {
+            task->discard();
+            delete task;
+        }
+    }
+}
+
 void TaskQueue::push(Task& aTask)
 {
     QMutexLocker locker(&mLock);
     aTask.setIdle();
     mTaskList.push_back(&aTask);
+    mCondition.wakeOne();
 }
 
 void TaskQueue::removeAll(Task& aTask)
@@ -27,30 +49,29 @@ void TaskQueue::removeAll(Task& aTask)
 
 Task* TaskQueue::waitPop(unsigned long aMSec)
 {
-    mLock.lock();
+    QMutexLocker locker(&mLock);
 
     // wait if empty
     if (mTaskList.empty())
     {
-        mLock.unlock();
-
-        // sleep
-        QMutexLocker condLocker(&mCondLock);
-        mCondition.wait(&mCondLock, aMSec);
-        return nullptr;
+        // the condition shares the lock, so no pushing is missed
+        mCondition.wait(&mLock, aMSec);
+        if (mTaskList.empty())
+        {
+            return nullptr;
+        }
     }
 
     // pop task
     Task* task = mTaskList.front();
     mTaskList.pop_front();
-
-    mLock.unlock();
+    task->setRun();
     return task;
 }
 
 void TaskQueue::wakeAll()
 {
-    QMutexLocker condLocker(&mCondLock);
+    QMutexLocker locker(&mLock);
     mCondition.wakeAll();
 }
 
@@ -14,6 +14,7 @@ class TaskQueue : private util::NonCopyable
 {
 public:
     TaskQueue();
+    ~TaskQueue();
 
     // push a task
     // Ownership of tasks still belong to a caller.
@@ -23,6 +24,8 @@ public:
     void removeAll(Task& aTask);
 
     // pop a task with proper waiting
+    // A popped task is set running before the queue is unlocked,
+    // so that a task is always either queued or canceled by its flag.
     Task* waitPop(unsigned long aMSec);
 
     // Wake all workers which are waiting for task popping.
@@ -32,7 +35,6 @@ private:
     QList<Task*> mTaskList;
     QMutex mLock;
     QWaitCondition mCondition;
-    QMutex mCondLock;
 };
 
 } // namespace thr
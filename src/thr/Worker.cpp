@@ -38,10 +38,16 @@ void Worker::Thread::run()
         Task* task = mQueue.waitPop(1 * 1000);
         if (task)
         {
-            task->setRun();
+            // the queue has already set the task running
+            const bool autoDeleted = task->isAutoDeleted();
             task->run();
             task->setFinish();
             THR_WORKER_DUMP("worker ran a task");
+
+            if (autoDeleted)
+            {
+                delete task;
+            }
         }
     }
 }
@@ -33,4 +33,6 @@ HEADERS += \
     Worker.h \
     TaskQueue.h \
     Task.h \
-    Paralleler.h
+    Paralleler.h \
+    Future.h \
+    CancelToken.h
@@ -1,16 +1,19 @@
 #ifndef UTIL_ARRAYBUFFER_H
 #define UTIL_ARRAYBUFFER_H
 
+#include <memory>
 #include <utility>
 #include "XC.h"
 
 namespace util
 {
 
+// an array which is implicitly shared between copies.
+// the objects are copied when a shared array is accessed for writing.
 template<typename tObject>
 class ArrayBuffer
 {
-    tObject* mObjects;
+    std::shared_ptr<tObject> mObjects;
     int mCount;
 
 public:
@@ -28,45 +31,27 @@ public:
     }
 
     ArrayBuffer(const ArrayBuffer<tObject>& aRhs)
-        : mObjects()
+        : mObjects(aRhs.mObjects)
         , mCount(aRhs.mCount)
     {
-        if (mCount > 0)
-        {
-            mObjects = new tObject[mCount];
-            for (int i = 0; i < mCount; ++i)
-            {
-                mObjects[i] = aRhs.mObjects[i];
-            }
-        }
     }
 
     ArrayBuffer& operator=(const ArrayBuffer<tObject>& aRhs)
     {
-        reset();
+        mObjects = aRhs.mObjects;
         mCount = aRhs.mCount;
-        if (mCount > 0)
-        {
-            mObjects = new tObject[mCount];
-            for (int i = 0; i < mCount; ++i)
-            {
-                mObjects[i] = aRhs.mObjects[i];
-            }
-        }
         return *this;
     }
 
     virtual ~ArrayBuffer()
     {
-        reset();
     }
 
     void reset()
     {
         if (mObjects)
         {
-            delete [] mObjects;
-            mObjects = nullptr;
+            mObjects.reset();
             mCount = 0;
         }
     }
@@ -75,7 +60,10 @@ public:
     {
         XC_ASSERT((aObjects && aCount > 0) || (!aObjects && aCount == 0));
         reset();
-        mObjects = aObjects;
+        if (aObjects)
+        {
+            mObjects.reset(aObjects, std::default_delete<tObject[]>());
+        }
         mCount = aCount;
     }
 
@@ -90,23 +78,51 @@ public:
 
     void swap(ArrayBuffer<tObject>& aRhs)
     {
-        std::swap(mObjects, aRhs.mObjects);
+        mObjects.swap(aRhs.mObjects);
         std::swap(mCount, aRhs.mCount);
     }
 
+    // whether the objects are referred from other arrays.
+    bool isShared() const
+    {
+        return mObjects && mObjects.use_count() > 1;
+    }
+
+    // make the objects unique to this array.
+    void detach()
+    {
+        if (isShared())
+        {
+            tObject* objects = new tObject[mCount];
+            const tObject* source = mObjects.get();
+            for (int i = 0; i < mCount; ++i)
+            {
+                objects[i] = source[i];
+            }
+            mObjects.reset(objects, std::default_delete<tObject[]>());
+        }
+    }
+
     explicit operator bool() const
     {
-        return mObjects;
+        return (bool)mObjects;
     }
 
     tObject* data()
     {
-        return mObjects;
+        detach();
+        return mObjects.get();
     }
 
     const tObject* data() const
     {
-        return mObjects;
+        return mObjects.get();
+    }
+
+    // never detaches even if it's called through a non-const buffer
+    const tObject* constData() const
+    {
+        return mObjects.get();
     }
 
     int count() const
@@ -116,26 +132,27 @@ public:
 
     tObject& operator [](int aIndex)
     {
-        return mObjects[aIndex];
+        detach();
+        return mObjects.get()[aIndex];
     }
 
     const tObject& operator [](int aIndex) const
     {
-        return mObjects[aIndex];
+        return mObjects.get()[aIndex];
     }
 
     tObject& at(int aIndex)
     {
         XC_PTR_ASSERT(mObjects);
         XC_ASSERT(0 <= aIndex && aIndex < mCount);
-        return mObjects[aIndex];
+        return data()[aIndex];
     }
 
     const tObject& at(int aIndex) const
     {
         XC_PTR_ASSERT(mObjects);
         XC_ASSERT(0 <= aIndex && aIndex < mCount);
-        return mObjects[aIndex];
+        return mObjects.get()[aIndex];
     }
 };
 
@@ -0,0 +1,151 @@
+#include "util/ChannelUtil.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTIL_CHANNELUTIL_USE_SSE2
+#endif
+
+namespace util
+{
+
+void ChannelUtil::split4(const uint8* aSrc, size_t aCount,
+                         uint8* aDst0, uint8* aDst1, uint8* aDst2, uint8* aDst3)
+{
+    size_t i = 0;
+#if defined(UTIL_CHANNELUTIL_USE_SSE2)
+    for (; i + 16 <= aCount; i += 16)
+    {
+        auto src = (const __m128i*)(aSrc + i * 4);
+        const __m128i a0 = _mm_loadu_si128(src + 0);
+        const __m128i a1 = _mm_loadu_si128(src + 1);
+        const __m128i a2 = _mm_loadu_si128(src + 2);
+        const __m128i a3 = _mm_loadu_si128(src + 3);
+
+        // transpose bytes by unpacking three times
+        const __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+        const __m128i b1 = _mm_unpackhi_epi8(a0, a1);
+        const __m128i b2 = _mm_unpacklo_epi8(a2, a3);
+        const __m128i b3 = _mm_unpackhi_epi8(a2, a3);
+
+        const __m128i c0 = _mm_unpacklo_epi8(b0, b1);
+        const __m128i c1 = _mm_unpackhi_epi8(b0, b1);
+        const __m128i c2 = _mm_unpacklo_epi8(b2, b3);
+        const __m128i c3 = _mm_unpackhi_epi8(b2, b3);
+
+        const __m128i d0 = _mm_unpacklo_epi8(c0, c1); // r0-7 g0-7
+        const __m128i d1 = _mm_unpackhi_epi8(c0, c1); // b0-7 a0-7
+        const __m128i d2 = _mm_unpacklo_epi8(c2, c3); // r8-15 g8-15
+        const __m128i d3 = _mm_unpackhi_epi8(c2, c3); // b8-15 a8-15
+
+        _mm_storeu_si128((__m128i*)(aDst0 + i), _mm_unpacklo_epi64(d0, d2));
+        _mm_storeu_si128((__m128i*)(aDst1 + i), _mm_unpackhi_epi64(d0, d2));
+        _mm_storeu_si128((__m128i*)(aDst2 + i), _mm_unpacklo_epi64(d1, d3));
+        _mm_storeu_si128((__m128i*)(aDst3 + i), _mm_unpackhi_epi64(d1, d3));
+    }
+#endif
+    for (; i < aCount; ++i)
+    {
+        const uint8* p = aSrc + i * 4;
+        aDst0[i] = p[0];
+        aDst1[i] = p[1];
+        aDst2[i] = p[2];
+        aDst3[i] = p[3];
+    }
+}
+
+void ChannelUtil::merge4(const uint8* aSrc0, const uint8* aSrc1,
+                         const uint8* aSrc2, const uint8* aSrc3,
+                         size_t aCount, uint8* aDst)
+{
+    size_t i = 0;
+#if defined(UTIL_CHANNELUTIL_USE_SSE2)
+    for (; i + 16 <= aCount; i += 16)
+    {
+        const __m128i r = _mm_loadu_si128((const __m128i*)(aSrc0 + i));
+        const __m128i g = _mm_loadu_si128((const __m128i*)(aSrc1 + i));
+        const __m128i b = _mm_loadu_si128((const __m128i*)(aSrc2 + i));
+        const __m128i a = _mm_loadu_si128((const __m128i*)(aSrc3 + i));
+
+        const __m128i rgLo = _mm_unpacklo_epi8(r, g);
+        const __m128i rgHi = _mm_unpackhi_epi8(r, g);
+        const __m128i baLo = _mm_unpacklo_epi8(b, a);
+        const __m128i baHi = _mm_unpackhi_epi8(b, a);
+
+        auto dst = (__m128i*)(aDst + i * 4);
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(rgLo, baLo));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rgLo, baLo));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rgHi, baHi));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rgHi, baHi));
+    }
+#endif
+    for (; i < aCount; ++i)
+    {
+        uint8* p = aDst + i * 4;
+        p[0] = aSrc0[i];
+        p[1] = aSrc1[i];
+        p[2] = aSrc2[i];
+        p[3] = aSrc3[i];
+    }
+}
+
+void ChannelUtil::extract(const uint8* aSrc, size_t aCount, int aStride, uint8* aDst)
+{
+    size_t i = 0;
+#if defined(UTIL_CHANNELUTIL_USE_SSE2)
+    if (aStride == 4)
+    {
+        // the last pixel may be partial, so keep it for the scalar loop
+        const __m128i mask = _mm_set1_epi32(0xff);
+        for (; i + 17 <= aCount; i += 16)
+        {
+            auto src = (const __m128i*)(aSrc + i * 4);
+            const __m128i v0 = _mm_and_si128(_mm_loadu_si128(src + 0), mask);
+            const __m128i v1 = _mm_and_si128(_mm_loadu_si128(src + 1), mask);
+            const __m128i v2 = _mm_and_si128(_mm_loadu_si128(src + 2), mask);
+            const __m128i v3 = _mm_and_si128(_mm_loadu_si128(src + 3), mask);
+            const __m128i v = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+            _mm_storeu_si128((__m128i*)(aDst + i), v);
+        }
+    }
+#endif
+    for (; i < aCount; ++i)
+    {
+        aDst[i] = aSrc[i * aStride];
+    }
+}
+
+void ChannelUtil::insert(const uint8* aSrc, size_t aCount, int aStride, uint8* aDst)
+{
+    size_t i = 0;
+#if defined(UTIL_CHANNELUTIL_USE_SSE2)
+    if (aStride == 4)
+    {
+        // blend into 16 bytes blocks. (the last pixel may be partial)
+        const __m128i mask = _mm_set1_epi32(0xff);
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 17 <= aCount; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(aSrc + i));
+            const __m128i lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i hi = _mm_unpackhi_epi8(v, zero);
+            const __m128i w[4] = {
+                _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)
+            };
+
+            auto dst = (__m128i*)(aDst + i * 4);
+            for (int k = 0; k < 4; ++k)
+            {
+                const __m128i d = _mm_andnot_si128(mask, _mm_loadu_si128(dst + k));
+                _mm_storeu_si128(dst + k, _mm_or_si128(d, w[k]));
+            }
+        }
+    }
+#endif
+    for (; i < aCount; ++i)
+    {
+        aDst[i * aStride] = aSrc[i];
+    }
+}
+
+} // namespace util
@@ -0,0 +1,32 @@
+#ifndef UTIL_CHANNELUTIL_H
+#define UTIL_CHANNELUTIL_H
+
+#include "XC.h"
+
+namespace util
+{
+
+// conversions between interleaved pixels and channel planes
+class ChannelUtil
+{
+public:
+    // rgba pixels to four planes
+    static void split4(const uint8* aSrc, size_t aCount,
+                       uint8* aDst0, uint8* aDst1, uint8* aDst2, uint8* aDst3);
+
+    // four planes to rgba pixels
+    static void merge4(const uint8* aSrc0, const uint8* aSrc1,
+                       const uint8* aSrc2, const uint8* aSrc3,
+                       size_t aCount, uint8* aDst);
+
+    // gather a channel. (aSrc[i * aStride] to aDst[i])
+    static void extract(const uint8* aSrc, size_t aCount, int aStride, uint8* aDst);
+
+    // scatter a channel. (aSrc[i] to aDst[i * aStride])
+    // bytes of aDst outside of [0, (aCount - 1) * aStride] are never touched.
+    static void insert(const uint8* aSrc, size_t aCount, int aStride, uint8* aDst);
+};
+
+} // namespace util
+
+#endif // UTIL_CHANNELUTIL_H
@@ -0,0 +1,119 @@
+#include <cstring>
+#include "util/ContentHash.h"
+
+namespace
+{
+
+static const uint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64 kPrime3 = 0x165667B19E3779F9ULL;
+static const uint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64 rotl(uint64 aValue, int aBits)
+{
+    return (aValue << aBits) | (aValue >> (64 - aBits));
+}
+
+inline uint64 read64(const uint8* p)
+{
+    uint64 value;
+    memcpy(&value, p, sizeof(value));
+    return XC_FROM_LITTLE_ENDIAN(value);
+}
+
+inline uint32 read32(const uint8* p)
+{
+    uint32 value;
+    memcpy(&value, p, sizeof(value));
+    return XC_FROM_LITTLE_ENDIAN(value);
+}
+
+inline uint64 mixRound(uint64 aAcc, uint64 aInput)
+{
+    aAcc += aInput * kPrime2;
+    aAcc = rotl(aAcc, 31);
+    return aAcc * kPrime1;
+}
+
+inline uint64 mergeRound(uint64 aAcc, uint64 aValue)
+{
+    aAcc ^= mixRound(0, aValue);
+    return aAcc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+namespace util
+{
+
+uint64 ContentHash::compute(const uint8* aData, size_t aSize, uint64 aSeed)
+{
+    const uint8* p = aData;
+    const uint8* end = aData + aSize;
+    uint64 h = 0;
+
+    if (aSize >= 32)
+    {
+        // four independent lanes, they are pipelined well
+        uint64 v1 = aSeed + kPrime1 + kPrime2;
+        uint64 v2 = aSeed + kPrime2;
+        uint64 v3 = aSeed;
+        uint64 v4 = aSeed - kPrime1;
+
+        const uint8* limit = end - 32;
+        do
+        {
+            v1 = mixRound(v1, read64(p));
+            v2 = mixRound(v2, read64(p + 8));
+            v3 = mixRound(v3, read64(p + 16));
+            v4 = mixRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    }
+    else
+    {
+        h = aSeed + kPrime5;
+    }
+
+    h += (uint64)aSize;
+
+    // remaining bytes
+    for (; p + 8 <= end; p += 8)
+    {
+        h ^= mixRound(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end)
+    {
+        h ^= (uint64)read32(p) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+    {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    // avalanche
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64 ContentHash::compute(const XCMemBlock& aBlock, uint64 aSeed)
+{
+    return compute(aBlock.data, aBlock.size, aSeed);
+}
+
+} // namespace util
@@ -0,0 +1,19 @@
+#ifndef UTIL_CONTENTHASH_H
+#define UTIL_CONTENTHASH_H
+
+#include "XC.h"
+
+namespace util
+{
+
+// 64bit non-cryptographic hash of bytes. (compatible with XXH64)
+class ContentHash
+{
+public:
+    static uint64 compute(const uint8* aData, size_t aSize, uint64 aSeed = 0);
+    static uint64 compute(const XCMemBlock& aBlock, uint64 aSeed = 0);
+};
+
+} // namespace util
+
+#endif // UTIL_CONTENTHASH_H
@@ -0,0 +1,81 @@
+#ifndef UTIL_OBJECTPOOL_H
+#define UTIL_OBJECTPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+#include "XC.h"
+#include "util/NonCopyable.h"
+
+namespace util
+{
+
+// a free list allocator for small objects which are created and deleted in large numbers.
+// memory is allocated by chunks and is kept until the pool is destroyed.
+template<typename tObj, int tChunkCount = 1024>
+class ObjectPool : private util::NonCopyable
+{
+public:
+    // shared pool of the type
+    static ObjectPool& instance()
+    {
+        static ObjectPool sPool;
+        return sPool;
+    }
+
+    ObjectPool()
+        : mMutex()
+        , mFree()
+        , mChunks()
+    {
+    }
+
+    void* allocate()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mFree)
+        {
+            pushChunk();
+        }
+        Slot* slot = mFree;
+        mFree = slot->next;
+        return slot;
+    }
+
+    void deallocate(void* aPtr)
+    {
+        if (!aPtr) return;
+        std::lock_guard<std::mutex> lock(mMutex);
+        Slot* slot = static_cast<Slot*>(aPtr);
+        slot->next = mFree;
+        mFree = slot;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        typename std::aligned_storage<sizeof(tObj), alignof(tObj)>::type storage;
+    };
+
+    void pushChunk()
+    {
+        std::unique_ptr<Slot[]> chunk(new Slot[tChunkCount]);
+        for (int i = 0; i < tChunkCount - 1; ++i)
+        {
+            chunk[i].next = &chunk[i + 1];
+        }
+        chunk[tChunkCount - 1].next = mFree;
+        mFree = &chunk[0];
+        mChunks.push_back(std::move(chunk));
+    }
+
+    std::mutex mMutex;
+    Slot* mFree;
+    std::vector<std::unique_ptr<Slot[]>> mChunks;
+};
+
+} // namespace util
+
+#endif // UTIL_OBJECTPOOL_H
@@ -1,5 +1,93 @@
+#include <cstring>
 #include "util/PackBits.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTIL_PACKBITS_USE_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+
+#if defined(UTIL_PACKBITS_USE_SSE2)
+// index of the lowest set bit (aBits must not be zero)
+inline int lowestBit(uint32 aBits)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, aBits);
+    return (int)index;
+#else
+    return __builtin_ctz(aBits);
+#endif
+}
+
+// the bits of positions which start three duplicated values. (p[0..17] must be readable)
+inline uint32 getTripleBits16(const uint8* p)
+{
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)(p + 0));
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 1));
+    const __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 2));
+    const __m128i eq = _mm_and_si128(_mm_cmpeq_epi8(v0, v1), _mm_cmpeq_epi8(v1, v2));
+    return (uint32)_mm_movemask_epi8(eq);
+}
+#endif
+
+inline bool isTriple(const uint8* p)
+{
+    return p[0] == p[1] && p[1] == p[2];
+}
+
+// scan the end of a run (from aBegin to aMax)
+inline const uint8* scanRun(const uint8* aBegin, const uint8* aMax, uint8 aValue)
+{
+    const uint8* p = aBegin;
+#if defined(UTIL_PACKBITS_USE_SSE2)
+    const __m128i value = _mm_set1_epi8((char)aValue);
+    while (aMax - p >= 16)
+    {
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), value);
+        const uint32 diff = (~(uint32)_mm_movemask_epi8(eq)) & 0xffffu;
+        if (diff) return p + lowestBit(diff);
+        p += 16;
+    }
+#endif
+    while (p < aMax && *p == aValue) ++p;
+    return p;
+}
+
+// scan the end of literals (from aBegin to aMax, triples are checked before aEnd)
+inline const uint8* scanLiterals(const uint8* aBegin, const uint8* aMax, const uint8* aEnd)
+{
+    const uint8* p = aBegin;
+    while (p < aMax)
+    {
+#if defined(UTIL_PACKBITS_USE_SSE2)
+        if (aEnd - p >= 18)
+        {
+            const size_t limit = (size_t)(aMax - p);
+            const uint32 bits = getTripleBits16(p);
+            if (bits)
+            {
+                const size_t index = (size_t)lowestBit(bits);
+                if (index < limit) return p + index;
+            }
+            p += (limit < 16 ? limit : 16);
+            continue;
+        }
+#endif
+        if (aEnd - p >= 3 && isTriple(p)) break;
+        ++p;
+    }
+    return p;
+}
+
+} // namespace
+
 namespace util
 {
 
@@ -12,114 +100,101 @@ size_t PackBits::worstEncodedSize(size_t aSrcSize)
     return aSrcSize + (aSrcSize / 128) + 1;
 }
 
-size_t PackBits::encode(const XCMemBlock& aSrc, uint8* aDst)
+size_t PackBits::encode(const uint8* aSrc, size_t aSrcSize, uint8* aDst)
 {
-    const uint8* end = aSrc.data + aSrc.size;
-    const uint8* p = aSrc.data;
+    const uint8* end = aSrc + aSrcSize;
+    const uint8* p = aSrc;
     uint8* dp = aDst;
-    long long int remains = aSrc.size;
 
-    while (remains > 0)
+    while (p < end)
     {
         const uint8* mark = p;
+        const size_t remains = (size_t)(end - p);
         const uint8* markMax = mark + (remains < 128 ? remains : 128);
 
         // found three duplicated value
-        if (mark <= (end - 3) && mark[0] == mark[1] && mark[1] == mark[2])
+        if (remains >= 3 && isTriple(mark))
         {
             // scan
-            p += 3;
-            while (p < markMax && *p == mark[0]) ++p;
+            p = scanRun(mark + 3, markMax, mark[0]);
 
             const int count = (int)(p - mark);
-            *dp++ = 1 + 256 - count;
+            *dp++ = (uint8)(1 + 256 - count);
             *dp++ = mark[0];
-            remains -= count;
         }
         else
         {
-            while (p < markMax)
-            {
-                if(p <= (end - 3) && p[0] == p[1] && p[1] == p[2]) break;
-                ++p;
-            }
+            p = scanLiterals(mark, markMax, end);
+
             const int count = (int)(p - mark);
-            *dp++ = count - 1;
+            *dp++ = (uint8)(count - 1);
             memcpy(dp, mark, count);
             dp += count;
-            remains -= count;
         }
     }
     return dp - aDst;
 }
 
-bool PackBits::decode(const XCMemBlock& aSrc, XCMemBlock& aDst)
+bool PackBits::decode(const uint8* aSrc, size_t aSrcSize, uint8* aDst, size_t aDstSize)
 {
-    const uint8* end = aSrc.data + aSrc.size;
-    const uint8* p = aSrc.data;
-    uint8* dp = aDst.data;
-    size_t dlen = aDst.size;
+    const uint8* end = aSrc + aSrcSize;
+    const uint8* p = aSrc;
+    uint8* dp = aDst;
     size_t x = 0;
 
     while (p < end)
     {
         // packet header
-        const char head = (char)(*p);
+        const signed char head = (signed char)(*p);
 
-        if (head < 0)
+        if (head == -128)
         {
             // noop operation
-            if (head == -128) continue;
-
+            ++p;
+        }
+        else if (head < 0)
+        {
             // continuos operation
             const size_t count = -head + 1;
             x += count;
 
-            if (x > dlen)
+            if (x > aDstSize || (p + 1) >= end)
             {
-                //PACKBITS_DUMP("decode packbits error 1: %lu", x);
                 return false;
             }
 
-            const uint8 value = *(++p);
-
-            for (size_t i = 0; i < count; ++i, ++dp)
-            {
-                *dp = value;
-            }
+            memset(dp, p[1], count);
+            dp += count;
+            p += 2;
         }
         else
         {
             // no continuos operation
             const size_t count = head + 1;
             x += count;
-            if (x > dlen)
-            {
-                //PACKBITS_DUMP("decode packbits error 2: %lu", x);
-                return false;
-            }
-            if ((p + count) >= end)
+
+            if (x > aDstSize || (p + count) >= end)
             {
-                //PACKBITS_DUMP("decode packbits error 3");
                 return false;
             }
 
-            for (size_t i = 0; i < count; ++i, ++dp)
-            {
-                *dp = *(++p);
-            }
+            memcpy(dp, p + 1, count);
+            dp += count;
+            p += count + 1;
         }
-
-        ++p;
     }
 
-    if (x != dlen)
-    {
-        //PACKBITS_DUMP("decode packbits error 4: %lu", x);
-        return false;
-    }
+    return x == aDstSize;
+}
 
-    return true;
+size_t PackBits::encode(const XCMemBlock& aSrc, uint8* aDst)
+{
+    return encode(aSrc.data, aSrc.size, aDst);
+}
+
+bool PackBits::decode(const XCMemBlock& aSrc, XCMemBlock& aDst)
+{
+    return decode(aSrc.data, aSrc.size, aDst.data, aDst.size);
 }
 
 } // namespace util
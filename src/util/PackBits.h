@@ -13,6 +13,10 @@ public:
 
     static size_t worstEncodedSize(size_t aSrcSize);
 
+    // raw buffer versions. (they are shared with the psd codec)
+    static size_t encode(const uint8* aSrc, size_t aSrcSize, uint8* aDst);
+    static bool decode(const uint8* aSrc, size_t aSrcSize, uint8* aDst, size_t aDstSize);
+
     size_t encode(const XCMemBlock& aSrc, uint8* aDst);
 
     bool decode(const XCMemBlock& aSrc, XCMemBlock& aDst);
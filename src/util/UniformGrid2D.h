@@ -0,0 +1,153 @@
+#ifndef UTIL_UNIFORMGRID2D_H
+#define UTIL_UNIFORMGRID2D_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <QRectF>
+#include "XC.h"
+
+namespace util
+{
+
+// a uniform grid which buckets objects by their bounding boxes.
+// an object which overlaps several cells is visited once for each of them.
+template<typename tData>
+class UniformGrid2D
+{
+public:
+    UniformGrid2D()
+        : mSpace()
+        , mCellSize()
+        , mColumns(0)
+        , mRows(0)
+        , mCells()
+    {
+    }
+
+    // decide the resolution from an expected count of objects.
+    void reset(const QRectF& aSpace, int aObjectCount, int aObjectsPerCell = 2)
+    {
+        static const int kMaxDivision = 256;
+        XC_ASSERT(aObjectsPerCell > 0);
+
+        mSpace = aSpace.normalized();
+        const int cellCount = std::max(aObjectCount / aObjectsPerCell, 1);
+        const double aspect = mSpace.height() > 0.0 ?
+                    mSpace.width() / mSpace.height() : 1.0;
+        const double columns = std::sqrt(cellCount * std::max(aspect, 1e-3));
+
+        mColumns = xc_clamp((int)std::ceil(columns), 1, kMaxDivision);
+        mRows = xc_clamp((int)std::ceil(cellCount / (double)mColumns), 1, kMaxDivision);
+        mCellSize = QSizeF(std::max(mSpace.width() / mColumns, 1e-6),
+                           std::max(mSpace.height() / mRows, 1e-6));
+
+        for (auto& cell : mCells) cell.clear();
+        mCells.resize(mColumns * mRows);
+    }
+
+    void clear()
+    {
+        mSpace = QRectF();
+        mColumns = 0;
+        mRows = 0;
+        mCells.clear();
+    }
+
+    bool isEmpty() const { return mCells.empty(); }
+
+    void push(const tData& aData, const QRectF& aBox)
+    {
+        Range range = getRange(aBox);
+        for (int y = range.top; y <= range.bottom; ++y)
+        {
+            for (int x = range.left; x <= range.right; ++x)
+            {
+                mCells[y * mColumns + x].push_back(aData);
+            }
+        }
+    }
+
+    // aBox has to be same as the one of pushing.
+    void remove(const tData& aData, const QRectF& aBox)
+    {
+        Range range = getRange(aBox);
+        for (int y = range.top; y <= range.bottom; ++y)
+        {
+            for (int x = range.left; x <= range.right; ++x)
+            {
+                auto& cell = mCells[y * mColumns + x];
+                cell.erase(std::remove(cell.begin(), cell.end(), aData), cell.end());
+            }
+        }
+    }
+
+    void move(const tData& aData, const QRectF& aPrevBox, const QRectF& aNextBox)
+    {
+        remove(aData, aPrevBox);
+        push(aData, aNextBox);
+    }
+
+    // visit objects in the cells which overlap aRect.
+    // the visitor returns false to stop visiting.
+    template<typename tVisitor>
+    bool visit(const QRectF& aRect, tVisitor aVisitor) const
+    {
+        Range range = getRange(aRect);
+        for (int y = range.top; y <= range.bottom; ++y)
+        {
+            for (int x = range.left; x <= range.right; ++x)
+            {
+                for (auto& data : mCells[y * mColumns + x])
+                {
+                    if (!aVisitor(data)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Range
+    {
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    // an empty range if there is no cell
+    Range getRange(const QRectF& aBox) const
+    {
+        Range range = { 0, 0, -1, -1 };
+        if (mCells.empty()) return range;
+
+        const QRectF box = aBox.normalized();
+        if (box.right() < mSpace.left() || mSpace.right() < box.left() ||
+            box.bottom() < mSpace.top() || mSpace.bottom() < box.top())
+        {
+            return range;
+        }
+
+        range.left   = cellIndex(box.left() - mSpace.left(), mCellSize.width(), mColumns);
+        range.right  = cellIndex(box.right() - mSpace.left(), mCellSize.width(), mColumns);
+        range.top    = cellIndex(box.top() - mSpace.top(), mCellSize.height(), mRows);
+        range.bottom = cellIndex(box.bottom() - mSpace.top(), mCellSize.height(), mRows);
+        return range;
+    }
+
+    static int cellIndex(double aOffset, double aCellSize, int aCount)
+    {
+        return xc_clamp((int)std::floor(aOffset / aCellSize), 0, aCount - 1);
+    }
+
+    QRectF mSpace;
+    QSizeF mCellSize;
+    int mColumns;
+    int mRows;
+    std::vector<std::vector<tData>> mCells;
+};
+
+} // namespace util
+
+#endif // UTIL_UNIFORMGRID2D_H
@@ -20,6 +20,8 @@ SOURCES += \
     TextUtil.cpp \
     TreePos.cpp \
     PackBits.cpp \
+    ChannelUtil.cpp \
+    ContentHash.cpp \
     TreeUtil.cpp \
     Triangle2D.cpp \
     IndexTable.cpp \
@@ -45,12 +47,15 @@ HEADERS += \
     Circle.h \
     PlacePointer.h \
     NonCopyable.h \
+    ObjectPool.h \
     Easing.h \
     FergusonCoonsSpline.h \
     SlotId.h \
     StreamReader.h \
     StreamWriter.h \
     PackBits.h \
+    ChannelUtil.h \
+    ContentHash.h \
     Range.h \
     TreeUtil.h \
     Triangle2D.h \
@@ -64,6 +69,7 @@ HEADERS += \
     IDSolver.h \
     Triangle2DPos.h \
     BinarySpacePartition2D.h \
+    UniformGrid2D.h \
     SelectArgs.h \
     IProgressReporter.h \
     Finally.h \